@@ -29,6 +29,7 @@ resultOutput = "gtest_result"
 valgrindOutput = "valgrind_report"
 valgrindErrorCode = 101
 valgrindIgnore = "rialto-gstreamer.supp"
+benchmarkOutput = "benchmark_result.json"
 
 
 def runcmd(*args, **kwargs):
@@ -70,11 +71,17 @@ def main ():
                              + "Note: Valgrind can only write output to one source (log or xml). \n" \
                              + "Note: Requires version valgrind 3.17.0+ installed. \n")
     argParser.add_argument("-cov", "--coverage", action='store_true', help="Generates UT coverage report")
+    argParser.add_argument("-bm", "--benchmarks", nargs='?', const="",
+                        help="Build and run the benchmarks instead of the unittests \n" \
+                             + "Results written as json (default '*suite_name*_" + benchmarkOutput + "').")
     args = vars(argParser.parse_args())
 
     # Rialto Component Tests & Paths
     # {Component Name : {Test Suite, Test Path}}
     suitesToRun = {"gst" : {"suite" : "GstRialtoUnitTests", "path" : "/tests/ut/"}}
+    if args['benchmarks'] != None:
+        suitesToRun = {"gst" : {"suite" : "GstRialtoBenchmarks", "path" : "/tests/benchmarks/"},
+                       "startup" : {"suite" : "GstRialtoStartupBenchmarks", "path" : "/tests/benchmarks/"}}
 
     # Set RIALTO_SINKS_RANK environment variable
     os.environ["RIALTO_SINKS_RANK"] = "256"
@@ -106,6 +113,12 @@ def main ():
     if args['noBuild'] == False:
         buildTargets(suitesToRun, args['output'], f, args['valgrind'], args['coverage'])
 
+    # Run the benchmarks with json output
+    if args['benchmarks'] != None:
+        if args['noTest'] == False:
+            runBenchmarks(suitesToRun, args['output'], f, args['benchmarks'] if args['benchmarks'] else benchmarkOutput)
+        return
+
     # Run the tests with the optional settings
     if args['noTest'] == False:
         runTests(suitesToRun, args['listTests'], args['googletestFilter'], args['output'], f, xml, args['valgrind'],
@@ -174,6 +187,16 @@ def runTests (suites, doListTests, gtestFilter, outputDir, resultsFile, xmlFile,
     elif coverage:
         generateCoverageReport(outputDir, resultsFile)
 
+# Run the micro-benchmarks
+def runBenchmarks (suites, outputDir, resultsFile, jsonFile):
+    for key in suites:
+        executeCmd = ["." + suites[key]["path"] + suites[key]["suite"], "--benchmark_out=" + key + "_" + jsonFile,
+                      "--benchmark_out_format=json"]
+        if resultsFile != None:
+            runcmd(executeCmd, cwd=os.getcwd() + '/' + outputDir, stdout=resultsFile, stderr=subprocess.STDOUT)
+        else:
+            runcmd(executeCmd, cwd=os.getcwd() + '/' + outputDir, stderr=subprocess.STDOUT)
+
 # Returns the valgrind command arguments
 def AddValgrind(suite, outputToFile, outputToXml):
     executeCmd = ["valgrind", "--leak-check=full", "--show-leak-kinds=all", "--track-origins=yes", "--verbose", "--error-exitcode=" + str(valgrindErrorCode)]
@@ -0,0 +1,62 @@
+# Copyright (C) 2023 Sky UK
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation;
+# version 2.1 of the License.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+include(ExternalProject)
+include(GNUInstallDirs)
+
+set( GOOGLEBENCHMARK_FOUND TRUE )
+set( GOOGLEBENCHMARK_VERSION 1.8.3 )
+
+if( CMAKE_CROSSCOMPILING )
+    set( GOOGLEBENCHMARK_EXTRA_CMAKE_ARGS "-DCMAKE_TOOLCHAIN_FILE=${CMAKE_TOOLCHAIN_FILE}" )
+endif()
+
+ExternalProject_Add(
+        googlebenchmark-project
+
+        PREFIX deps/googlebenchmark-${GOOGLEBENCHMARK_VERSION}
+
+        URL      https://github.com/google/benchmark/archive/v${GOOGLEBENCHMARK_VERSION}.tar.gz
+        # URL_HASH SHA256=
+
+        CMAKE_ARGS
+            -DCMAKE_INSTALL_PREFIX=<INSTALL_DIR>
+            -DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}
+            -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+            -DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}
+            -DCMAKE_BUILD_TYPE=Release
+            -DBENCHMARK_ENABLE_TESTING=OFF
+            -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+            -DBENCHMARK_ENABLE_WERROR=OFF
+            -DCMAKE_POSITION_INDEPENDENT_CODE=On
+            ${GOOGLEBENCHMARK_EXTRA_CMAKE_ARGS}
+        )
+
+
+ExternalProject_Get_Property( googlebenchmark-project INSTALL_DIR )
+
+set( GOOGLEBENCHMARK_INCLUDE_DIRS ${INSTALL_DIR}/include )
+file( MAKE_DIRECTORY ${GOOGLEBENCHMARK_INCLUDE_DIRS} )
+
+set( GOOGLEBENCHMARK_LIBRARY ${INSTALL_DIR}/${CMAKE_INSTALL_LIBDIR}/${CMAKE_STATIC_LIBRARY_PREFIX}benchmark${CMAKE_STATIC_LIBRARY_SUFFIX} )
+
+add_library( GoogleBenchmark::benchmark STATIC IMPORTED )
+set_property( TARGET GoogleBenchmark::benchmark PROPERTY IMPORTED_LOCATION ${GOOGLEBENCHMARK_LIBRARY} )
+set_property( TARGET GoogleBenchmark::benchmark PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${GOOGLEBENCHMARK_INCLUDE_DIRS} )
+add_dependencies( GoogleBenchmark::benchmark googlebenchmark-project )
+
+unset( INSTALL_DIR )
@@ -24,38 +24,41 @@
 
 using namespace firebolt::rialto;
 
-std::unique_ptr<IMediaPipeline::MediaSegment> BufferParser::parseBuffer(GstSample *sample, GstBuffer *buffer,
-                                                                        GstMapInfo map, int streamId)
+BufferParser::~BufferParser()
+{
+    if (m_codecDataBuffer)
+        gst_buffer_unref(m_codecDataBuffer);
+}
+
+const std::unique_ptr<IMediaPipeline::MediaSegment> &BufferParser::parseBuffer(GstCaps *caps, GstBuffer *buffer,
+                                                                               GstMapInfo map, int streamId)
 {
     int64_t timeStamp = static_cast<int64_t>(GST_BUFFER_PTS(buffer));
     int64_t duration = static_cast<int64_t>(GST_BUFFER_DURATION(buffer));
-    GstCaps *caps = gst_sample_get_caps(sample);
     GstStructure *structure = gst_caps_get_structure(caps, 0);
 
-    std::unique_ptr<IMediaPipeline::MediaSegment> mseData =
-        parseSpecificPartOfBuffer(streamId, structure, timeStamp, duration);
+    parseSpecificPartOfBuffer(streamId, structure, timeStamp, duration);
 
-    mseData->setData(map.size, map.data);
+    m_segment->setData(map.size, map.data);
 
-    addCodecDataToSegment(mseData, structure);
-    addProtectionMetadataToSegment(mseData, buffer, map, structure);
+    addCodecDataToSegment(structure);
+    addProtectionMetadataToSegment(buffer, map, structure);
 
-    return mseData;
+    return m_segment;
 }
 
-void BufferParser::addProtectionMetadataToSegment(std::unique_ptr<IMediaPipeline::MediaSegment> &segment,
-                                                  GstBuffer *buffer, const GstMapInfo &map, GstStructure *structure)
+void BufferParser::addProtectionMetadataToSegment(GstBuffer *buffer, const GstMapInfo &map, GstStructure *structure)
 {
     EncryptionFormat encryptionFormat = EncryptionFormat::CLEAR;
-    BufferProtectionMetadata metadata;
+    BufferProtectionMetadata &metadata = m_protectionMetadata;
+    metadata.clear();
     ProcessProtectionMetadata(buffer, metadata);
 
-    std::string mediaType = gst_structure_get_name(structure);
-    if (mediaType == "application/x-cenc")
+    if (gst_structure_has_name(structure, "application/x-cenc"))
     {
         encryptionFormat = EncryptionFormat::CENC;
     }
-    else if (mediaType == "application/x-webm-enc")
+    else if (gst_structure_has_name(structure, "application/x-webm-enc"))
     {
         encryptionFormat = EncryptionFormat::WEBM;
     }
@@ -77,15 +80,15 @@ void BufferParser::addProtectionMetadataToSegment(std::unique_ptr<IMediaPipeline
                   metadata.encrypted, metadata.mediaKeySessionId, metadata.kid.size(), metadata.iv.size(),
                   metadata.subsamples.size(), metadata.initWithLast15);
 
-        segment->setEncrypted(true);
-        segment->setMediaKeySessionId(metadata.mediaKeySessionId);
-        segment->setKeyId(metadata.kid);
-        segment->setInitVector(metadata.iv);
-        segment->setInitWithLast15(metadata.initWithLast15);
-        segment->setCipherMode(metadata.cipherMode);
+        m_segment->setEncrypted(true);
+        m_segment->setMediaKeySessionId(metadata.mediaKeySessionId);
+        m_segment->setKeyId(metadata.kid);
+        m_segment->setInitVector(metadata.iv);
+        m_segment->setInitWithLast15(metadata.initWithLast15);
+        m_segment->setCipherMode(metadata.cipherMode);
         if (metadata.encryptionPatternSet)
         {
-            segment->setEncryptionPattern(metadata.cryptBlocks, metadata.skipBlocks);
+            m_segment->setEncryptionPattern(metadata.cryptBlocks, metadata.skipBlocks);
         }
 
         size_t subSampleCount = metadata.subsamples.size();
@@ -93,13 +96,12 @@ void BufferParser::addProtectionMetadataToSegment(std::unique_ptr<IMediaPipeline
         {
             GST_DEBUG("SUBSAMPLE: %zu/%zu C: %d E: %d", subSampleIdx, subSampleCount,
                       metadata.subsamples[subSampleIdx].first, metadata.subsamples[subSampleIdx].second);
-            segment->addSubSample(metadata.subsamples[subSampleIdx].first, metadata.subsamples[subSampleIdx].second);
+            m_segment->addSubSample(metadata.subsamples[subSampleIdx].first, metadata.subsamples[subSampleIdx].second);
         }
     }
 }
 
-void BufferParser::addCodecDataToSegment(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &segment,
-                                         GstStructure *structure)
+void BufferParser::addCodecDataToSegment(GstStructure *structure)
 {
     const GValue *codec_data;
     codec_data = gst_structure_get_value(structure, "codec_data");
@@ -108,33 +110,44 @@ void BufferParser::addCodecDataToSegment(std::unique_ptr<firebolt::rialto::IMedi
         GstBuffer *buf = gst_value_get_buffer(codec_data);
         if (buf)
         {
-            GstMappedBuffer mappedBuf(buf, GST_MAP_READ);
-            if (mappedBuf)
+            // The codec data only changes with the caps, it is copied once and shared by the following segments
+            if (buf != m_codecDataBuffer || !m_codecData)
             {
+                GstMappedBuffer mappedBuf(buf, GST_MAP_READ);
+                if (!mappedBuf)
+                {
+                    GST_ERROR("Failed to read codec_data");
+                    return;
+                }
                 auto codecData = std::make_shared<firebolt::rialto::CodecData>();
                 codecData->data = std::vector<std::uint8_t>(mappedBuf.data(), mappedBuf.data() + mappedBuf.size());
                 codecData->type = firebolt::rialto::CodecDataType::BUFFER;
-                segment->setCodecData(codecData);
-            }
-            else
-            {
-                GST_ERROR("Failed to read codec_data");
+                m_codecData = codecData;
+                gst_buffer_replace(&m_codecDataBuffer, buf);
             }
+            m_segment->setCodecData(m_codecData);
             return;
         }
         const gchar *str = g_value_get_string(codec_data);
         if (str)
         {
-            auto codecData = std::make_shared<firebolt::rialto::CodecData>();
-            codecData->data = std::vector<std::uint8_t>(str, str + std::strlen(str));
-            codecData->type = firebolt::rialto::CodecDataType::STRING;
-            segment->setCodecData(codecData);
+            const size_t kLength = std::strlen(str);
+            if (!m_codecData || m_codecDataBuffer || m_codecData->data.size() != kLength ||
+                std::memcmp(m_codecData->data.data(), str, kLength) != 0)
+            {
+                auto codecData = std::make_shared<firebolt::rialto::CodecData>();
+                codecData->data = std::vector<std::uint8_t>(str, str + kLength);
+                codecData->type = firebolt::rialto::CodecDataType::STRING;
+                m_codecData = codecData;
+                gst_buffer_replace(&m_codecDataBuffer, nullptr);
+            }
+            m_segment->setCodecData(m_codecData);
         }
     }
 }
 
-std::unique_ptr<IMediaPipeline::MediaSegment>
-AudioBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration)
+void AudioBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp,
+                                                  int64_t duration)
 {
     gint sampleRate = 0;
     gint numberOfChannels = 0;
@@ -144,14 +157,11 @@ AudioBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structu
     GST_DEBUG("New audio frame pts=%" PRId64 " duration=%" PRId64 " sampleRate=%d numberOfChannels=%d", timeStamp,
               duration, sampleRate, numberOfChannels);
 
-    std::unique_ptr<IMediaPipeline::MediaSegmentAudio> mseData =
-        std::make_unique<IMediaPipeline::MediaSegmentAudio>(streamId, timeStamp, duration, sampleRate, numberOfChannels);
-
-    return mseData;
+    assignSegment(IMediaPipeline::MediaSegmentAudio(streamId, timeStamp, duration, sampleRate, numberOfChannels));
 }
 
-std::unique_ptr<IMediaPipeline::MediaSegment>
-VideoBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration)
+void VideoBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp,
+                                                  int64_t duration)
 {
     gint width = 0;
     gint height = 0;
@@ -163,8 +173,5 @@ VideoBufferParser::parseSpecificPartOfBuffer(int streamId, GstStructure *structu
     GST_DEBUG("New video frame pts=%" PRId64 " duration=%" PRId64 " width=%d height=%d framerate=%d/%d", timeStamp,
               duration, width, height, frameRate.numerator, frameRate.denominator);
 
-    std::unique_ptr<IMediaPipeline::MediaSegmentVideo> mseData =
-        std::make_unique<IMediaPipeline::MediaSegmentVideo>(streamId, timeStamp, duration, width, height, frameRate);
-
-    return mseData;
+    assignSegment(IMediaPipeline::MediaSegmentVideo(streamId, timeStamp, duration, width, height, frameRate));
 }
@@ -19,6 +19,7 @@
 #ifndef BUFFERPARSER_H
 #define BUFFERPARSER_H
 
+#include "GStreamerEMEUtils.h"
 #include <IMediaPipeline.h>
 #include <gst/gst.h>
 
@@ -32,31 +33,60 @@ class BufferParser
     };
 
 public:
-    std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> parseBuffer(GstSample *sample, GstBuffer *buffer,
-                                                                                GstMapInfo map, int streamId);
+    virtual ~BufferParser();
+
+    /**
+     * @brief Builds the segment of a buffer.
+     *
+     * The parser reuses one segment, its metadata and the codec data of the caps for all the buffers, so that parsing
+     * does not allocate in steady state. The segment is valid until the next call.
+     *
+     * @param[in] caps     : The caps the buffer was received with
+     * @param[in] buffer   : The buffer
+     * @param[in] map      : The mapping of the buffer, the segment points to its data
+     * @param[in] streamId : The id of the source
+     *
+     * @retval the segment.
+     */
+    const std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &parseBuffer(GstCaps *caps, GstBuffer *buffer,
+                                                                                       GstMapInfo map, int streamId);
+
+protected:
+    // Copy assignment keeps the capacity of the key id, init vector and subsample vectors of the reused segment
+    template <typename SegmentType> void assignSegment(const SegmentType &segment)
+    {
+        if (!m_segment)
+        {
+            m_segment = std::make_unique<SegmentType>(segment);
+            return;
+        }
+        static_cast<SegmentType &>(*m_segment) = segment;
+    }
 
 private:
-    virtual std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment>
-    parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration) = 0;
+    virtual void parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp,
+                                           int64_t duration) = 0;
+
+    void addProtectionMetadataToSegment(GstBuffer *buffer, const GstMapInfo &map, GstStructure *structure);
+    void addCodecDataToSegment(GstStructure *structure);
 
-    void addProtectionMetadataToSegment(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &segment,
-                                        GstBuffer *buffer, const GstMapInfo &map, GstStructure *structure);
-    void addCodecDataToSegment(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &segment,
-                               GstStructure *structure);
+    std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> m_segment;
+    BufferProtectionMetadata m_protectionMetadata;
+    // The codec data of the current caps and the buffer it was copied from, held so that it can be compared
+    std::shared_ptr<firebolt::rialto::CodecData> m_codecData;
+    GstBuffer *m_codecDataBuffer = nullptr;
 };
 
 class AudioBufferParser : public BufferParser
 {
 private:
-    std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment>
-    parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration) override;
+    void parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration) override;
 };
 
 class VideoBufferParser : public BufferParser
 {
 private:
-    std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment>
-    parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration) override;
+    void parseSpecificPartOfBuffer(int streamId, GstStructure *structure, int64_t timeStamp, int64_t duration) override;
 };
 
 #endif // BUFFERPARSER_H
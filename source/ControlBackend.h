@@ -22,82 +22,249 @@
 
 #include <IControl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <gst/gst.h>
+#include <map>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <memory>
 
 namespace firebolt::rialto::client
 {
-class ControlBackend final : public ControlBackendInterface
+/**
+ * @brief The control client shared by all of the sinks of the process.
+ *
+ * Registers to RialtoServer once and caches the application state, so that the sinks can check it
+ * without an IPC round trip. Destroyed together with the last ControlBackend using it.
+ */
+class SharedControl
 {
     class ControlClient : public IControlClient
     {
     public:
-        explicit ControlClient(ControlBackend &backend) : mBackend{backend} {}
+        explicit ControlClient(SharedControl &control) : mControl{control} {}
         ~ControlClient() override = default;
         void notifyApplicationState(ApplicationState state) override
         {
             GST_INFO("ApplicationStateChanged received by rialto sink");
-            mBackend.onApplicationStateChanged(state);
+            mControl.onApplicationStateChanged(state);
         }
 
     private:
-        ControlBackend &mBackend;
+        SharedControl &mControl;
     };
 
 public:
-    ControlBackend() : m_rialtoClientState{ApplicationState::UNKNOWN}
+    SharedControl() : m_rialtoClientState{ApplicationState::UNKNOWN}, m_isRegistered{false}
     {
         m_controlClient = std::make_shared<ControlClient>(*this);
-        if (m_controlClient)
+    }
+
+    ~SharedControl() { m_control.reset(); }
+
+    SharedControl(const SharedControl &) = delete;
+    SharedControl &operator=(const SharedControl &) = delete;
+
+    static std::shared_ptr<SharedControl> instance()
+    {
+        static std::mutex instanceMutex;
+        static std::weak_ptr<SharedControl> instance;
+
+        std::shared_ptr<SharedControl> control;
+        ApplicationState state{ApplicationState::UNKNOWN};
+        bool isRegistered{false};
         {
-            m_control = IControlFactory::createFactory()->createControl();
-            if (!m_control)
+            std::lock_guard<std::mutex> lock{instanceMutex};
+            control = instance.lock();
+            if (!control)
             {
-                GST_ERROR("Unable to create control");
-                return;
+                control = std::make_shared<SharedControl>();
+                instance = control;
             }
-            if (!m_control->registerClient(m_controlClient, m_rialtoClientState))
+            if (!control->m_isRegistered)
             {
-                GST_ERROR("Unable to register client");
-                return;
+                // Registration is retried by the next sink if it failed before. The control is not replaced, so
+                // that the sinks already holding it are notified too.
+                isRegistered = control->registerClient(state);
             }
         }
-    }
-
-    ~ControlBackend() final { m_control.reset(); }
 
-    void removeControlBackend() override { m_control.reset(); }
+        // Notified without the instance mutex, as the listeners may create sinks themselves
+        if (isRegistered)
+        {
+            control->onApplicationStateChanged(state);
+        }
+        return control;
+    }
 
-    bool waitForRunning() override
+    bool waitForRunning()
     {
-        std::unique_lock<std::mutex> lock{m_mutex};
-        if (ApplicationState::RUNNING == m_rialtoClientState)
+        if (ApplicationState::RUNNING == m_rialtoClientState.load())
         {
             return true;
         }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
         m_stateCv.wait_for(lock, std::chrono::seconds{1},
-                           [&]() { return m_rialtoClientState == ApplicationState::RUNNING; });
-        return ApplicationState::RUNNING == m_rialtoClientState;
+                           [&]() { return m_rialtoClientState.load() == ApplicationState::RUNNING; });
+        return ApplicationState::RUNNING == m_rialtoClientState.load();
+    }
+
+    void addListener(const void *key, const std::function<void(ApplicationState)> &listener)
+    {
+        std::lock_guard<std::mutex> lock{m_listenersMutex};
+        m_listeners[key] = listener;
+    }
+
+    void removeListener(const void *key)
+    {
+        std::unique_lock<std::mutex> lock{m_listenersMutex};
+        m_listeners.erase(key);
+        // The listener may still be called by the ongoing notifications, except the one it is removed from
+        const std::thread::id kThisThread{std::this_thread::get_id()};
+        m_listenersCv.wait(lock,
+                           [&]()
+                           {
+                               return std::all_of(m_notifyingThreads.begin(), m_notifyingThreads.end(),
+                                                  [&](const std::thread::id &thread) { return thread == kThisThread; });
+                           });
     }
 
 private:
+    /**
+     * @brief Creates the control if needed and registers to RialtoServer. Called with the instance mutex held.
+     *
+     * @param[out] state : The application state returned by the registration
+     *
+     * @retval true on success.
+     */
+    bool registerClient(ApplicationState &state)
+    {
+        if (!m_control)
+        {
+            m_control = IControlFactory::createFactory()->createControl();
+            if (!m_control)
+            {
+                GST_ERROR("Unable to create control");
+                return false;
+            }
+        }
+
+        if (!m_control->registerClient(m_controlClient, state))
+        {
+            GST_ERROR("Unable to register client");
+            return false;
+        }
+        m_isRegistered = true;
+        return true;
+    }
+
     void onApplicationStateChanged(ApplicationState state)
     {
         GST_INFO("Rialto Client application state changed to: %s",
                  state == ApplicationState::RUNNING ? "Active" : "Inactive/Unknown");
-        std::unique_lock<std::mutex> lock{m_mutex};
-        m_rialtoClientState = state;
-        m_stateCv.notify_one();
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_rialtoClientState = state;
+        }
+        m_stateCv.notify_all();
+
+        // Listeners are called without the lock, so that they can add or remove listeners and do not hold up the
+        // other sinks. removeListener waits for the notification to end instead.
+        std::vector<const void *> keys;
+        {
+            std::lock_guard<std::mutex> listenersLock{m_listenersMutex};
+            for (const auto &listener : m_listeners)
+            {
+                keys.push_back(listener.first);
+            }
+            m_notifyingThreads.push_back(std::this_thread::get_id());
+        }
+
+        for (const void *key : keys)
+        {
+            std::function<void(ApplicationState)> listener;
+            {
+                // Skips the listeners removed by the previous ones
+                std::lock_guard<std::mutex> listenersLock{m_listenersMutex};
+                auto it = m_listeners.find(key);
+                if (it == m_listeners.end())
+                {
+                    continue;
+                }
+                listener = it->second;
+            }
+            listener(state);
+        }
+
+        {
+            std::lock_guard<std::mutex> listenersLock{m_listenersMutex};
+            m_notifyingThreads.erase(
+                std::find(m_notifyingThreads.begin(), m_notifyingThreads.end(), std::this_thread::get_id()));
+        }
+        m_listenersCv.notify_all();
     }
 
 private:
-    ApplicationState m_rialtoClientState;
+    std::atomic<ApplicationState> m_rialtoClientState;
+    bool m_isRegistered;
     std::shared_ptr<ControlClient> m_controlClient;
     std::shared_ptr<IControl> m_control;
     std::mutex m_mutex;
     std::condition_variable m_stateCv;
+    std::mutex m_listenersMutex;
+    std::condition_variable m_listenersCv;
+    std::map<const void *, std::function<void(ApplicationState)>> m_listeners;
+    std::vector<std::thread::id> m_notifyingThreads;
+};
+
+class ControlBackend final : public ControlBackendInterface
+{
+public:
+    ControlBackend() : m_sharedControl{SharedControl::instance()} {}
+
+    ~ControlBackend() final { removeControlBackend(); }
+
+    void removeControlBackend() override
+    {
+        if (m_sharedControl)
+        {
+            m_sharedControl->removeListener(this);
+            m_sharedControl.reset();
+        }
+    }
+
+    bool waitForRunning() override
+    {
+        if (!m_sharedControl)
+        {
+            // The sink is started again after removeControlBackend
+            m_sharedControl = SharedControl::instance();
+            if (m_applicationStateCallback)
+            {
+                m_sharedControl->addListener(this, m_applicationStateCallback);
+            }
+        }
+        return m_sharedControl->waitForRunning();
+    }
+
+    void setApplicationStateCallback(const std::function<void(ApplicationState)> &callback) override
+    {
+        m_applicationStateCallback = callback;
+        if (m_sharedControl)
+        {
+            m_sharedControl->addListener(this, m_applicationStateCallback);
+        }
+    }
+
+private:
+    std::shared_ptr<SharedControl> m_sharedControl;
+    std::function<void(ApplicationState)> m_applicationStateCallback;
 };
 } // namespace firebolt::rialto::client
@@ -20,6 +20,7 @@
 
 #include <ControlCommon.h>
 
+#include <functional>
 #include <string>
 
 namespace firebolt::rialto::client
@@ -30,5 +31,6 @@ public:
     virtual ~ControlBackendInterface() = default;
     virtual void removeControlBackend() = 0;
     virtual bool waitForRunning() = 0;
+    virtual void setApplicationStateCallback(const std::function<void(ApplicationState)> &callback) = 0;
 };
 } // namespace firebolt::rialto::client
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FlightRecorder.h"
+#include <cstdio>
+#include <gst/gst.h>
+
+namespace
+{
+constexpr char kMagic[4]{'R', 'F', 'R', '1'};
+
+struct FlightRecorderHeader
+{
+    char magic[4];
+    uint32_t entrySize;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+} // namespace
+
+void FlightRecorder::record(FlightRecorderEvent event, int64_t value1, int64_t value2)
+{
+    const uint64_t kIndex = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = m_slots[kIndex % kCapacity];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count(),
+                      std::memory_order_relaxed);
+    slot.event.store(static_cast<uint32_t>(event), std::memory_order_relaxed);
+    slot.value1.store(value1, std::memory_order_relaxed);
+    slot.value2.store(value2, std::memory_order_relaxed);
+    slot.sequence.store(kIndex + 1, std::memory_order_release);
+}
+
+std::vector<FlightRecorderEntry> FlightRecorder::getEntries() const
+{
+    const uint64_t kEnd = m_writeIndex.load(std::memory_order_acquire);
+    const uint64_t kBegin = kEnd > kCapacity ? kEnd - kCapacity : 0;
+
+    std::vector<FlightRecorderEntry> entries;
+    entries.reserve(kEnd - kBegin);
+    for (uint64_t index = kBegin; index < kEnd; ++index)
+    {
+        const Slot &slot = m_slots[index % kCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+        {
+            continue;
+        }
+        FlightRecorderEntry entry{slot.timeNs.load(std::memory_order_relaxed),
+                                  slot.event.load(std::memory_order_relaxed), 0,
+                                  slot.value1.load(std::memory_order_relaxed),
+                                  slot.value2.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == index + 1)
+        {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+bool FlightRecorder::dump(const std::string &filePath) const
+{
+    const std::vector<FlightRecorderEntry> kEntries{getEntries()};
+
+    FILE *file = fopen(filePath.c_str(), "wb");
+    if (!file)
+    {
+        GST_WARNING("Failed to open %s", filePath.c_str());
+        return false;
+    }
+
+    FlightRecorderHeader header{{kMagic[0], kMagic[1], kMagic[2], kMagic[3]},
+                                sizeof(FlightRecorderEntry),
+                                static_cast<uint32_t>(kEntries.size()),
+                                0};
+    bool result = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (result && !kEntries.empty())
+    {
+        result = fwrite(kEntries.data(), sizeof(FlightRecorderEntry), kEntries.size(), file) == kEntries.size();
+    }
+    result = (fclose(file) == 0) && result;
+    if (!result)
+    {
+        GST_WARNING("Failed to write %s", filePath.c_str());
+    }
+    return result;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The data path events kept by the flight recorder.
+ */
+enum class FlightRecorderEvent : uint32_t
+{
+    NEED_DATA = 1,    // value1: frames requested, value2: need data request id
+    SEGMENT = 2,      // value1: bytes, value2: pts
+    HAVE_DATA = 3,    // value1: MediaSourceStatus, value2: segments added
+    QUEUE_LEVEL = 4,  // value1: queued samples, value2: queued bytes
+    STATE_CHANGE = 5, // value1: GstStateChange
+    SERVER_STATE = 6, // value1: PlaybackState
+    SEEK = 7,         // value1: position
+    FLUSH = 8,        // value1: 1 on flush start, 0 on flush stop
+    UNDERFLOW = 9,
+    ERROR = 10,
+    EOS = 11,
+    CANCEL_NEED_DATA = 12 // value1: segments added before the cancellation, value2: need data request id
+};
+
+/**
+ * @brief An entry of the flight recorder, also the layout of the entries in a dump.
+ */
+struct FlightRecorderEntry
+{
+    uint64_t timeNs;
+    uint32_t event;
+    uint32_t reserved;
+    int64_t value1;
+    int64_t value2;
+};
+
+/**
+ * @brief Keeps the last data path events of a sink in a fixed-size ring, for postmortem analysis.
+ *
+ * Always on. Recording is lock-free and never allocates, so it can be called from any thread.
+ * A dump is a "RFR1" header followed by the entries, oldest first, in host byte order.
+ */
+class FlightRecorder
+{
+public:
+    static constexpr size_t kCapacity{2048};
+
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder &) = delete;
+    FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+    /**
+     * @brief Records an event, overwriting the oldest one when the ring is full.
+     *
+     * @param[in] event  : The event
+     * @param[in] value1 : The first value of the event
+     * @param[in] value2 : The second value of the event
+     */
+    void record(FlightRecorderEvent event, int64_t value1 = 0, int64_t value2 = 0);
+
+    /**
+     * @brief Gets the recorded entries, oldest first.
+     *
+     * The entries being overwritten while this is called are skipped.
+     *
+     * @retval the entries.
+     */
+    std::vector<FlightRecorderEntry> getEntries() const;
+
+    /**
+     * @brief Writes the recorded entries to a file.
+     *
+     * @param[in] filePath : The file to write
+     *
+     * @retval true on success.
+     */
+    bool dump(const std::string &filePath) const;
+
+private:
+    struct Slot
+    {
+        // Index of the entry plus one, 0 while it is written
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> timeNs{0};
+        std::atomic<uint32_t> event{0};
+        std::atomic<int64_t> value1{0};
+        std::atomic<int64_t> value2{0};
+    };
+
+    std::atomic<uint64_t> m_writeIndex{0};
+    std::array<Slot, kCapacity> m_slots;
+};
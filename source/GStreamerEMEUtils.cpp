@@ -48,7 +48,7 @@ void getKIDFromProtectionMetadata(GstRialtoProtectionMetadata *protectionMeta, B
             GstMappedBuffer mappedKeyID(keyIDBuffer, GST_MAP_READ);
             if (mappedKeyID)
             {
-                metadata.kid = std::vector<uint8_t>(mappedKeyID.data(), mappedKeyID.data() + mappedKeyID.size());
+                metadata.kid.assign(mappedKeyID.data(), mappedKeyID.data() + mappedKeyID.size());
             }
         }
     }
@@ -67,7 +67,7 @@ void getIVFromProtectionMetadata(GstRialtoProtectionMetadata *protectionMeta, Bu
             GstMappedBuffer mappedIV(ivBuffer, GST_MAP_READ);
             if (mappedIV && (ivSize == mappedIV.size()))
             {
-                metadata.iv = std::vector<uint8_t>(mappedIV.data(), mappedIV.data() + mappedIV.size());
+                metadata.iv.assign(mappedIV.data(), mappedIV.data() + mappedIV.size());
             }
         }
     }
@@ -90,8 +90,7 @@ void getSubSamplesFromProtectionMetadata(GstRialtoProtectionMetadata *protection
                 if (mappedSubSamples &&
                     ((mappedSubSamples.size() / (sizeof(int16_t) + sizeof(int32_t))) == subSampleCount))
                 {
-                    std::vector<uint8_t> subSamples(mappedSubSamples.data(),
-                                                    mappedSubSamples.data() + mappedSubSamples.size());
+                    const uint8_t *subSamples = mappedSubSamples.data();
                     //'senc' atom
                     // unsigned   int(16)      subsample_count;
                     //{
@@ -28,6 +28,21 @@ struct BufferProtectionMetadata
 {
     BufferProtectionMetadata() : encrypted(false) {}
 
+    // Resets the metadata for the next buffer, keeping the capacity of the vectors
+    void clear()
+    {
+        encrypted = false;
+        mediaKeySessionId = -1;
+        iv.clear();
+        kid.clear();
+        subsamples.clear();
+        initWithLast15 = 0;
+        cipherMode = firebolt::rialto::CipherMode::UNKNOWN;
+        cryptBlocks = 0;
+        skipBlocks = 0;
+        encryptionPatternSet = false;
+    }
+
     bool encrypted{false};
     int mediaKeySessionId{-1};
     std::vector<uint8_t> iv;
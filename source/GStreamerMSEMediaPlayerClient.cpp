@@ -17,11 +17,14 @@
  */
 
 #include "GStreamerMSEMediaPlayerClient.h"
+#include "GStreamerMSEUtils.h"
 #include "RialtoGStreamerMSEBaseSink.h"
 #include "RialtoGStreamerMSEBaseSinkPrivate.h"
 #include "RialtoGStreamerMSEVideoSink.h"
+#include "Tracing.h"
 #include <algorithm>
 #include <chrono>
+#include <limits>
 #include <thread>
 
 namespace
@@ -31,6 +34,14 @@ namespace
 // 1 second is probably erring on the side of caution, but should not have side effect.
 const int64_t segmentStartMaximumDiff = 1000000000;
 const int32_t UNKNOWN_STREAMS_NUMBER = -1;
+// The number of requests fitting the learnt metadata size after which the size is lowered by an eighth
+const uint32_t kMetadataDecayBatches = 16;
+
+// The server numbers the need data requests sequentially, the distance keeps the order across the wrap around
+bool isNewerRequest(unsigned int needDataRequestId, unsigned int otherNeedDataRequestId)
+{
+    return static_cast<int32_t>(needDataRequestId - otherNeedDataRequestId) > 0;
+}
 } // namespace
 
 GStreamerMSEMediaPlayerClient::GStreamerMSEMediaPlayerClient(
@@ -41,7 +52,8 @@ GStreamerMSEMediaPlayerClient::GStreamerMSEMediaPlayerClient(
       m_clientBackend(MediaPlayerClientBackend), m_position(0), m_duration(0), m_audioStreams{UNKNOWN_STREAMS_NUMBER},
       m_videoStreams{UNKNOWN_STREAMS_NUMBER}, m_videoRectangle{0, 0, 1920, 1080}, m_streamingStopped(false),
       m_maxWidth(maxVideoWidth == 0 ? DEFAULT_MAX_VIDEO_WIDTH : maxVideoWidth),
-      m_maxHeight(maxVideoHeight == 0 ? DEFAULT_MAX_VIDEO_HEIGHT : maxVideoHeight)
+      m_maxHeight(maxVideoHeight == 0 ? DEFAULT_MAX_VIDEO_HEIGHT : maxVideoHeight),
+      m_canSuspend(rialto_mse_sink_get_suspend_retain_bytes() > 0)
 {
     m_backendQueue->start();
 }
@@ -72,6 +84,39 @@ void GStreamerMSEMediaPlayerClient::destroyClientBackend()
     m_clientBackend.reset();
 }
 
+bool GStreamerMSEMediaPlayerClient::prepareForReuse()
+{
+    if (m_streamingStopped)
+    {
+        return false;
+    }
+
+    bool result = false;
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            if (!m_clientBackend || !m_isBackendCreated)
+            {
+                return;
+            }
+
+            m_clientBackend->stop();
+            for (auto &source : m_attachedSources)
+            {
+                source.second.m_bufferPuller->stop();
+                if (!m_clientBackend->removeSource(source.first))
+                {
+                    GST_WARNING("Remove source %d failed", source.first);
+                }
+            }
+            m_bufferPullers.clear();
+            m_attachedSources.clear();
+            result = true;
+        });
+
+    return result;
+}
+
 void GStreamerMSEMediaPlayerClient::notifyDuration(int64_t duration)
 {
     m_backendQueue->postMessage(std::make_shared<SetDurationMessage>(duration, m_duration));
@@ -97,14 +142,49 @@ void GStreamerMSEMediaPlayerClient::notifyAudioData(bool hasData) {}
 
 void GStreamerMSEMediaPlayerClient::notifyNeedMediaData(
     int32_t sourceId, size_t frameCount, uint32_t needDataRequestId,
-    const std::shared_ptr<firebolt::rialto::MediaPlayerShmInfo> & /*shmInfo*/)
+    const std::shared_ptr<firebolt::rialto::MediaPlayerShmInfo> &shmInfo)
 {
-    m_backendQueue->postMessage(std::make_shared<NeedDataMessage>(sourceId, frameCount, needDataRequestId, this));
+    Tracer::instance().instant("NeedData", {{"sourceId", sourceId},
+                                            {"frames", static_cast<int64_t>(frameCount)},
+                                            {"requestId", needDataRequestId}});
+
+    // Outside of a seek the request goes straight to the puller of the source, the backend thread only handles the
+    // requests which have to be checked against the seek state
+    const firebolt::rialto::MediaPlayerShmInfo kShmInfo{shmInfo ? *shmInfo : firebolt::rialto::MediaPlayerShmInfo{}};
+    bool isFound = false;
+    bool isPosted = false;
+    if (m_serverSeekingState == SeekingState::IDLE)
+    {
+        const auto kNeedDataTime = std::chrono::steady_clock::now();
+        isFound = m_bufferPullers.find(sourceId,
+                                       [&](BufferPuller &bufferPuller)
+                                       {
+                                           isPosted = bufferPuller.requestPullBuffer(sourceId, frameCount,
+                                                                                     needDataRequestId, kShmInfo,
+                                                                                     kNeedDataTime, this);
+                                       });
+    }
 
-    return;
+    if (!isFound)
+    {
+        m_backendQueue->postMessage(
+            m_needDataMessages.acquire(sourceId, frameCount, needDataRequestId, kShmInfo, this));
+    }
+    else if (!isPosted)
+    {
+        // The puller has been stopped by a seek since the state was checked, the server sends new requests after it
+        GST_INFO("Dropping NeedDataRequestId %u of stopped sourceId=%d", needDataRequestId, sourceId);
+    }
 }
 
-void GStreamerMSEMediaPlayerClient::notifyCancelNeedMediaData(int sourceId) {}
+void GStreamerMSEMediaPlayerClient::notifyCancelNeedMediaData(int sourceId)
+{
+    // The server does not expect an answer to the cancelled requests
+    if (!m_bufferPullers.find(sourceId, [](BufferPuller &bufferPuller) { bufferPuller.cancelPulls(); }))
+    {
+        GST_WARNING("Failed to cancel need data for sourceId=%d", sourceId);
+    }
+}
 
 void GStreamerMSEMediaPlayerClient::notifyQos(int32_t sourceId, const firebolt::rialto::QosInfo &qosInfo)
 {
@@ -138,45 +218,88 @@ int64_t GStreamerMSEMediaPlayerClient::getPosition()
 bool GStreamerMSEMediaPlayerClient::createBackend()
 {
     bool result = false;
-    m_backendQueue->callInEventLoop(
-        [&]()
-        {
-            if (!m_clientBackend)
-            {
-                GST_ERROR("Client backend is NULL");
-                result = false;
-                return;
-            }
-            m_clientBackend->createMediaPlayerBackend(shared_from_this(), m_maxWidth, m_maxHeight);
-
-            if (m_clientBackend->isMediaPlayerBackendCreated())
-            {
-                std::string utf8url = "mse://1";
-                firebolt::rialto::MediaType mediaType = firebolt::rialto::MediaType::MSE;
-                if (!m_clientBackend->load(mediaType, "", utf8url))
-                {
-                    GST_ERROR("Could not load RialtoClient");
-                    return;
-                }
-                result = true;
-            }
-            else
-            {
-                GST_ERROR("Media player backend could not be created");
-            }
-        });
+    m_backendQueue->callInEventLoop([&]() { result = createBackendDo(); });
 
     return result;
 }
 
+void GStreamerMSEMediaPlayerClient::createBackendAsync()
+{
+    m_backendCreatedPromise = std::promise<bool>();
+    m_backendCreated = m_backendCreatedPromise.get_future().share();
+    if (!m_backendQueue->postMessage(std::make_shared<CreateBackendMessage>(this)))
+    {
+        GST_ERROR("Could not start creating the media player backend");
+        m_backendCreatedPromise.set_value(false);
+    }
+}
+
+bool GStreamerMSEMediaPlayerClient::waitForBackend()
+{
+    if (!m_backendCreated.valid())
+    {
+        return true;
+    }
+    return m_backendCreated.get();
+}
+
+bool GStreamerMSEMediaPlayerClient::createBackendDo()
+{
+    if (!m_clientBackend)
+    {
+        GST_ERROR("Client backend is NULL");
+        return false;
+    }
+    if (m_isBackendCreated)
+    {
+        // The client is reused, forget the state of the previous pipeline
+        m_position = 0;
+        m_duration = 0;
+        m_wasAllSourcesAttachedSent = false;
+        m_audioStreams = UNKNOWN_STREAMS_NUMBER;
+        m_videoStreams = UNKNOWN_STREAMS_NUMBER;
+        m_serverSeekingState = SeekingState::IDLE;
+    }
+    else
+    {
+        m_clientBackend->createMediaPlayerBackend(shared_from_this(), m_maxWidth, m_maxHeight);
+
+        if (!m_clientBackend->isMediaPlayerBackendCreated())
+        {
+            GST_ERROR("Media player backend could not be created");
+            return false;
+        }
+        m_isBackendCreated = true;
+    }
+
+    std::string utf8url = "mse://1";
+    firebolt::rialto::MediaType mediaType = firebolt::rialto::MediaType::MSE;
+    if (!m_clientBackend->load(mediaType, "", utf8url))
+    {
+        GST_ERROR("Could not load RialtoClient");
+        return false;
+    }
+    return true;
+}
+
 void GStreamerMSEMediaPlayerClient::play()
 {
-    m_backendQueue->callInEventLoop([&]() { m_clientBackend->play(); });
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            m_isPlayRequested = true;
+            m_clientBackend->play();
+        });
 }
 
 void GStreamerMSEMediaPlayerClient::pause()
 {
-    m_backendQueue->callInEventLoop([&]() { m_clientBackend->pause(); });
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            m_isPlayRequested = false;
+            m_clientBackend->pause();
+        });
 }
 
 void GStreamerMSEMediaPlayerClient::stop()
@@ -197,6 +320,8 @@ void GStreamerMSEMediaPlayerClient::notifySourceStartedSeeking(int32_t sourceId)
 
             sourceIt->second.m_seekingState = SeekingState::SEEKING;
             sourceIt->second.m_bufferPuller->stop();
+            // The server sends new requests after the seek
+            sourceIt->second.m_bufferPuller->cancelPulls();
 
             startPullingDataIfSeekFinished();
         });
@@ -254,7 +379,16 @@ bool GStreamerMSEMediaPlayerClient::attachSource(std::unique_ptr<firebolt::rialt
                 {
                     m_attachedSources.emplace(source->getId(),
                                               AttachedSource(rialtoSink, bufferPuller, source->getType()));
+                    if (m_canSuspend)
+                    {
+                        m_attachedSources.at(source->getId()).m_mediaSource = source->copy();
+                    }
                     rialtoSink->priv->m_sourceId = source->getId();
+                    if (!m_bufferPullers.insert(source->getId(), bufferPuller))
+                    {
+                        GST_WARNING("Need data requests for source %d go through the backend thread",
+                                    source->getId());
+                    }
                     bufferPuller->start();
                 }
             }
@@ -281,6 +415,7 @@ void GStreamerMSEMediaPlayerClient::removeSource(int32_t sourceId)
             {
                 GST_WARNING("Remove source %d failed", sourceId);
             }
+            m_bufferPullers.erase(sourceId);
             m_attachedSources.erase(sourceId);
         });
 }
@@ -403,6 +538,7 @@ void GStreamerMSEMediaPlayerClient::setVideoRectangle(const std::string &rectang
 
             m_clientBackend->setVideoWindow(rect.x, rect.y, rect.width, rect.height);
             m_videoRectangle = rect;
+            m_wasVideoRectangleSet = true;
         });
 }
 
@@ -437,7 +573,12 @@ bool GStreamerMSEMediaPlayerClient::renderFrame(RialtoMSEBaseSink *sink)
 
 void GStreamerMSEMediaPlayerClient::setVolume(double volume)
 {
-    m_backendQueue->callInEventLoop([&]() { m_clientBackend->setVolume(volume); });
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            m_clientBackend->setVolume(volume);
+            m_volume = volume;
+        });
 }
 
 double GStreamerMSEMediaPlayerClient::getVolume()
@@ -460,7 +601,12 @@ double GStreamerMSEMediaPlayerClient::getVolume()
 
 void GStreamerMSEMediaPlayerClient::setMute(bool mute)
 {
-    m_backendQueue->callInEventLoop([&]() { m_clientBackend->setMute(mute); });
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            m_clientBackend->setMute(mute);
+            m_mute = mute;
+        });
 }
 
 bool GStreamerMSEMediaPlayerClient::getMute()
@@ -519,6 +665,112 @@ void GStreamerMSEMediaPlayerClient::setVideoStreamsInfo(int32_t videoStreams, bo
         });
 }
 
+void GStreamerMSEMediaPlayerClient::suspend()
+{
+    m_backendQueue->postMessage(std::make_shared<SetSuspendedMessage>(true, this));
+}
+
+void GStreamerMSEMediaPlayerClient::resume()
+{
+    m_backendQueue->postMessage(std::make_shared<SetSuspendedMessage>(false, this));
+}
+
+void GStreamerMSEMediaPlayerClient::suspendDo()
+{
+    if (!m_canSuspend || m_isSuspended || !m_clientBackend || !m_isBackendCreated || !m_wasAllSourcesAttachedSent)
+    {
+        return;
+    }
+
+    getPositionDo(&m_position);
+    GST_INFO("Suspending at position %" GST_TIME_FORMAT, GST_TIME_ARGS(m_position));
+    for (auto &source : m_attachedSources)
+    {
+        source.second.m_bufferPuller->stop();
+        source.second.m_bufferPuller->cancelPulls();
+        source.second.m_seekingState = SeekingState::IDLE;
+    }
+
+    m_clientBackend->stop();
+    m_clientBackend->destroyMediaPlayerBackend();
+    m_isBackendCreated = false;
+    m_wasAllSourcesAttachedSent = false;
+    m_serverSeekingState = SeekingState::IDLE;
+    m_isSuspended = true;
+}
+
+void GStreamerMSEMediaPlayerClient::resumeDo()
+{
+    if (!m_isSuspended)
+    {
+        return;
+    }
+    m_isSuspended = false;
+
+    GST_INFO("Resuming from position %" GST_TIME_FORMAT, GST_TIME_ARGS(m_position));
+    if (!createBackendDo())
+    {
+        for (auto &source : m_attachedSources)
+        {
+            rialto_mse_base_handle_rialto_server_error(source.second.m_rialtoSink);
+        }
+        return;
+    }
+
+    // The server gives new ids to the sources attached again
+    std::unordered_map<int32_t, AttachedSource> attachedSources;
+    for (auto &source : m_attachedSources)
+    {
+        std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> mediaSource =
+            source.second.m_mediaSource->copy();
+        if (!m_clientBackend->attachSource(mediaSource))
+        {
+            GST_ERROR("Could not attach source %d again", source.first);
+            rialto_mse_base_handle_rialto_server_error(source.second.m_rialtoSink);
+            continue;
+        }
+        source.second.m_rialtoSink->priv->m_sourceId = mediaSource->getId();
+        attachedSources.emplace(mediaSource->getId(), std::move(source.second));
+    }
+    m_attachedSources.swap(attachedSources);
+    m_bufferPullers.clear();
+    for (auto &source : m_attachedSources)
+    {
+        m_bufferPullers.insert(source.first, source.second.m_bufferPuller);
+    }
+    m_clientBackend->allSourcesAttached();
+    m_wasAllSourcesAttachedSent = true;
+
+    // Seek to the position, or to the retained data when the sinks kept nothing before it
+    int64_t seekPosition = m_position;
+    for (auto &source : m_attachedSources)
+    {
+        GstClockTime firstPts = rialto_mse_base_sink_restore_retained_samples(source.second.m_rialtoSink, m_position);
+        if (GST_CLOCK_TIME_IS_VALID(firstPts) && static_cast<int64_t>(firstPts) > seekPosition)
+        {
+            seekPosition = static_cast<int64_t>(firstPts);
+        }
+        source.second.m_seekingState = SeekingState::SEEKING;
+    }
+
+    m_clientBackend->pause();
+    m_serverSeekingState = SeekingState::SEEKING;
+    m_clientBackend->seek(seekPosition);
+    m_position = seekPosition;
+
+    m_clientBackend->setVolume(m_volume);
+    m_clientBackend->setMute(m_mute);
+    if (m_wasVideoRectangleSet)
+    {
+        m_clientBackend->setVideoWindow(m_videoRectangle.x, m_videoRectangle.y, m_videoRectangle.width,
+                                        m_videoRectangle.height);
+    }
+    if (m_isPlayRequested)
+    {
+        m_clientBackend->play();
+    }
+}
+
 bool GStreamerMSEMediaPlayerClient::areAllStreamsAttached()
 {
     int32_t attachedVideoSources = 0;
@@ -538,23 +790,27 @@ bool GStreamerMSEMediaPlayerClient::areAllStreamsAttached()
     return attachedVideoSources == m_videoStreams && attachedAudioSources == m_audioStreams;
 }
 
-bool GStreamerMSEMediaPlayerClient::requestPullBuffer(int streamId, size_t frameCount, unsigned int needDataRequestId)
+bool GStreamerMSEMediaPlayerClient::requestPullBuffer(int streamId, size_t frameCount, unsigned int needDataRequestId,
+                                                      const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                                                      std::chrono::steady_clock::time_point needDataTime)
 {
     bool result = false;
-    m_backendQueue->callInEventLoop(
-        [&]()
+    auto request = [&]()
+    {
+        auto sourceIt = m_attachedSources.find(streamId);
+        if (sourceIt == m_attachedSources.end() || m_serverSeekingState != SeekingState::IDLE)
         {
-            auto sourceIt = m_attachedSources.find(streamId);
-            if (sourceIt == m_attachedSources.end() || m_serverSeekingState != SeekingState::IDLE)
-            {
-                GST_ERROR("There's no attached source with id %d or seek is not finished %u", streamId,
-                          static_cast<uint32_t>(m_serverSeekingState));
+            GST_ERROR("There's no attached source with id %d or seek is not finished %u", streamId,
+                      static_cast<uint32_t>(m_serverSeekingState.load()));
 
-                result = false;
-                return;
-            }
-            result = sourceIt->second.m_bufferPuller->requestPullBuffer(streamId, frameCount, needDataRequestId, this);
-        });
+            result = false;
+            return;
+        }
+        result = sourceIt->second.m_bufferPuller->requestPullBuffer(streamId, frameCount, needDataRequestId, shmInfo,
+                                                                    needDataTime, this);
+    };
+    // Called for every need data request, capturing a single reference lets std::function store it without allocating
+    m_backendQueue->callInEventLoop([&request]() { request(); });
 
     return result;
 }
@@ -626,10 +882,96 @@ void BufferPuller::stop()
 }
 
 bool BufferPuller::requestPullBuffer(int sourceId, size_t frameCount, unsigned int needDataRequestId,
+                                     const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                                     std::chrono::steady_clock::time_point needDataTime,
                                      GStreamerMSEMediaPlayerClient *player)
 {
-    return m_queue->postMessage(std::make_shared<PullBufferMessage>(sourceId, frameCount, needDataRequestId,
-                                                                    m_rialtoSink, m_bufferParser, *m_queue, player));
+    {
+        std::lock_guard<std::mutex> lock{m_requestsMutex};
+        if (std::find(m_ongoingNeedDataRequests.begin(), m_ongoingNeedDataRequests.end(), needDataRequestId) !=
+            m_ongoingNeedDataRequests.end())
+        {
+            GST_DEBUG("Need data request %u for source %d is already being pulled", needDataRequestId, sourceId);
+            return true;
+        }
+        // Recorded before posting, the puller may answer the request before postMessage returns. An older request
+        // sent again by the backend thread may be posted after a newer one, it does not become the latest.
+        m_ongoingNeedDataRequests.push_back(needDataRequestId);
+        if (isNewerRequest(needDataRequestId, m_latestNeedDataRequestId))
+        {
+            m_latestNeedDataRequestId = needDataRequestId;
+        }
+    }
+
+    if (!m_queue->postMessage(m_pullBufferMessages.acquire(sourceId, frameCount, needDataRequestId, shmInfo,
+                                                           needDataTime, m_rialtoSink, m_bufferParser, this, player)))
+    {
+        completeRequest(needDataRequestId);
+        return false;
+    }
+    return true;
+}
+
+void BufferPuller::completeRequest(unsigned int needDataRequestId)
+{
+    std::lock_guard<std::mutex> lock{m_requestsMutex};
+    m_ongoingNeedDataRequests.erase(std::remove(m_ongoingNeedDataRequests.begin(), m_ongoingNeedDataRequests.end(),
+                                                needDataRequestId),
+                                    m_ongoingNeedDataRequests.end());
+}
+
+bool BufferPuller::isSuperseded(unsigned int needDataRequestId) const
+{
+    return isNewerRequest(m_latestNeedDataRequestId, needDataRequestId);
+}
+
+void BufferPuller::cancelPulls()
+{
+    std::lock_guard<std::mutex> lock{m_requestsMutex};
+    ++m_cancelGeneration;
+    m_ongoingNeedDataRequests.clear();
+    m_metadataBytesPerSegment = 0;
+    m_batchesFitted = 0;
+}
+
+uint32_t BufferPuller::getCancelGeneration() const
+{
+    return m_cancelGeneration;
+}
+
+size_t BufferPuller::getMaxSegments(uint32_t maxMetadataBytes) const
+{
+    const uint32_t kMetadataBytesPerSegment = m_metadataBytesPerSegment;
+    if (maxMetadataBytes == 0 || kMetadataBytesPerSegment == 0)
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+    return std::max<size_t>(1, maxMetadataBytes / kMetadataBytesPerSegment);
+}
+
+void BufferPuller::learnMetadataBytes(uint32_t maxMetadataBytes, size_t segments)
+{
+    // The segments did not fit, so one takes more than their share of the space. The largest estimate is kept, as
+    // the metadata of encrypted samples is larger.
+    const uint32_t kMetadataBytesPerSegment = static_cast<uint32_t>(maxMetadataBytes / segments) + 1;
+    if (kMetadataBytesPerSegment > m_metadataBytesPerSegment)
+    {
+        m_metadataBytesPerSegment = kMetadataBytesPerSegment;
+    }
+    m_batchesFitted = 0;
+}
+
+void BufferPuller::decayMetadataBytes()
+{
+    // The estimate comes from the largest segments seen so far, it is lowered step by step so that smaller segments
+    // can fill the space again. Going too low only costs one refused segment, which learns the size again.
+    const uint32_t kMetadataBytesPerSegment = m_metadataBytesPerSegment;
+    if (kMetadataBytesPerSegment == 0 || ++m_batchesFitted < kMetadataDecayBatches)
+    {
+        return;
+    }
+    m_batchesFitted = 0;
+    m_metadataBytesPerSegment = kMetadataBytesPerSegment - std::max<uint32_t>(1, kMetadataBytesPerSegment / 8);
 }
 
 HaveDataMessage::HaveDataMessage(firebolt::rialto::MediaSourceStatus status, int sourceId,
@@ -646,26 +988,110 @@ void HaveDataMessage::handle()
         return;
     }
 
+    TraceScope trace{"HaveData",
+                     {{"sourceId", m_sourceId},
+                      {"requestId", m_needDataRequestId},
+                      {"status", static_cast<int64_t>(m_status)}}};
     m_player->m_clientBackend->haveData(m_status, m_needDataRequestId);
 }
 
 PullBufferMessage::PullBufferMessage(int sourceId, size_t frameCount, unsigned int needDataRequestId,
-                                     GstElement *rialtoSink, const std::shared_ptr<BufferParser> &bufferParser,
-                                     IMessageQueue &pullerQueue, GStreamerMSEMediaPlayerClient *player)
-    : m_sourceId(sourceId), m_frameCount(frameCount), m_needDataRequestId(needDataRequestId), m_rialtoSink(rialtoSink),
-      m_bufferParser(bufferParser), m_pullerQueue(pullerQueue), m_player(player)
+                                     const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                                     std::chrono::steady_clock::time_point needDataTime, GstElement *rialtoSink,
+                                     const std::shared_ptr<BufferParser> &bufferParser,
+                                     BufferPuller *bufferPuller, GStreamerMSEMediaPlayerClient *player)
+    : m_sourceId(sourceId), m_frameCount(frameCount), m_needDataRequestId(needDataRequestId),
+      m_maxMediaBytes(shmInfo.maxMediaBytes), m_maxMetadataBytes(shmInfo.maxMetadataBytes),
+      m_needDataTime(needDataTime), m_rialtoSink(rialtoSink), m_bufferParser(bufferParser),
+      m_bufferPuller(bufferPuller), m_cancelGeneration(bufferPuller->getCancelGeneration()), m_player(player)
 {
 }
 
+void PullBufferMessage::sendHaveData(firebolt::rialto::MediaSourceStatus status)
+{
+    m_bufferPuller->completeRequest(m_needDataRequestId);
+
+    // rialto client's haveData call is MT safe like addSegment, answering from the puller saves a hop to the backend.
+    // The answer is sent from the lookup, so that the source cannot be removed or attached again meanwhile.
+    bool isAnswered = false;
+    m_player->m_bufferPullers.find(m_sourceId,
+                                   [&](BufferPuller &bufferPuller)
+                                   {
+                                       if (&bufferPuller != m_bufferPuller)
+                                       {
+                                           return;
+                                       }
+                                       TraceScope trace{"HaveData",
+                                                        {{"sourceId", m_sourceId},
+                                                         {"requestId", m_needDataRequestId},
+                                                         {"status", static_cast<int64_t>(status)}}};
+                                       m_player->m_clientBackend->haveData(status, m_needDataRequestId);
+                                       isAnswered = true;
+                                   });
+    if (!isAnswered)
+    {
+        GST_INFO("Source %d is no longer attached, NeedDataRequestId %u is not answered", m_sourceId,
+                 m_needDataRequestId);
+    }
+}
+
+bool PullBufferMessage::isCancelled() const
+{
+    return m_bufferPuller->getCancelGeneration() != m_cancelGeneration;
+}
+
 void PullBufferMessage::handle()
 {
+    Tracer &tracer = Tracer::instance();
+    tracer.complete("NeedDataQueued", m_needDataTime, std::chrono::steady_clock::now(),
+                    {{"sourceId", m_sourceId}, {"requestId", m_needDataRequestId}});
+    TraceScope trace{"PullBuffer",
+                     {{"sourceId", m_sourceId},
+                      {"frames", static_cast<int64_t>(m_frameCount)},
+                      {"requestId", m_needDataRequestId}},
+                     tracer};
+
+    if (isCancelled())
+    {
+        GST_DEBUG_OBJECT(m_rialtoSink, "Need data request %u was cancelled", m_needDataRequestId);
+        return;
+    }
+
+    // Pulling for a superseded request would split the queued samples between the requests, the newer one takes them
+    if (m_bufferPuller->isSuperseded(m_needDataRequestId))
+    {
+        GST_DEBUG_OBJECT(m_rialtoSink, "Need data request %u is superseded", m_needDataRequestId);
+        sendHaveData(firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES);
+        return;
+    }
+
     bool isEos = false;
     unsigned int addedSegments = 0;
-
-    for (unsigned int frame = 0; frame < m_frameCount; ++frame)
+    SinkStatistics &statistics = RIALTO_MSE_BASE_SINK(m_rialtoSink)->priv->m_statistics;
+    FlightRecorder &flightRecorder = RIALTO_MSE_BASE_SINK(m_rialtoSink)->priv->m_flightRecorder;
+    flightRecorder.record(FlightRecorderEvent::NEED_DATA, m_frameCount, m_needDataRequestId);
+    statistics.recordNeedData(m_frameCount);
+
+    // The batch is planned from the space of the request, so that a sample which cannot fit is left queued for the
+    // next request instead of being parsed and refused by addSegment
+    const size_t kMaxSegments = std::min(m_frameCount, m_bufferPuller->getMaxSegments(m_maxMetadataBytes));
+    size_t mediaBytes = 0;
+    size_t bytesPending = 0;
+
+    for (unsigned int frame = 0; frame < kMaxSegments; ++frame)
     {
-        GstSample *sample = rialto_mse_base_sink_get_front_sample(RIALTO_MSE_BASE_SINK(m_rialtoSink));
-        if (!sample)
+        // The server cancels the requests before a seek or a source removal, the remaining frames are not needed
+        if (isCancelled())
+        {
+            GST_DEBUG_OBJECT(m_rialtoSink, "Need data request %u was cancelled after %u segments", m_needDataRequestId,
+                             addedSegments);
+            flightRecorder.record(FlightRecorderEvent::CANCEL_NEED_DATA, addedSegments, m_needDataRequestId);
+            return;
+        }
+
+        GstBuffer *buffer = nullptr;
+        GstCaps *caps = nullptr;
+        if (!rialto_mse_base_sink_get_front_sample(RIALTO_MSE_BASE_SINK(m_rialtoSink), &buffer, &caps))
         {
             if (rialto_mse_base_sink_is_eos(RIALTO_MSE_BASE_SINK(m_rialtoSink)))
             {
@@ -673,15 +1099,23 @@ void PullBufferMessage::handle()
             }
             else
             {
-                // it's not a critical issue. It might be caused by receiving too many need data requests.
+                // it's not a critical issue, the sink has not received the next sample yet.
                 GST_INFO_OBJECT(m_rialtoSink, "Could not get a sample");
             }
             break;
         }
 
+        // A first sample larger than the space is still tried, the server decides what to do with it
+        const size_t kSampleBytes = buffer ? gst_buffer_get_size(buffer) : 0;
+        if (m_maxMediaBytes > 0 && addedSegments > 0 && mediaBytes + kSampleBytes > m_maxMediaBytes)
+        {
+            GST_DEBUG_OBJECT(m_rialtoSink, "Sample of %zu bytes is left for the next request", kSampleBytes);
+            bytesPending = kSampleBytes;
+            break;
+        }
+
         // we pass GstMapInfo's pointers on data buffers to RialtoClient
         // so we need to hold it until RialtoClient copies them to shm
-        GstBuffer *buffer = gst_sample_get_buffer(sample);
         GstMapInfo map;
         if (!gst_buffer_map(buffer, &map, GST_MAP_READ))
         {
@@ -690,8 +1124,8 @@ void PullBufferMessage::handle()
             continue;
         }
 
-        std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> mseData =
-            m_bufferParser->parseBuffer(sample, buffer, map, m_sourceId);
+        const std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &mseData =
+            m_bufferParser->parseBuffer(caps, buffer, map, m_sourceId);
         if (!mseData)
         {
             GST_ERROR_OBJECT(m_rialtoSink, "No data returned from the parser");
@@ -700,19 +1134,43 @@ void PullBufferMessage::handle()
             continue;
         }
 
-        firebolt::rialto::AddSegmentStatus addSegmentStatus = m_player->addSegment(m_needDataRequestId, mseData);
+        firebolt::rialto::AddSegmentStatus addSegmentStatus;
+        {
+            TraceScope addSegmentTrace{"AddSegment",
+                                       {{"sourceId", m_sourceId}, {"bytes", static_cast<int64_t>(map.size)}},
+                                       tracer};
+            addSegmentStatus = m_player->addSegment(m_needDataRequestId, mseData);
+        }
         if (addSegmentStatus == firebolt::rialto::AddSegmentStatus::NO_SPACE)
         {
+            // The media fitted, so the metadata of the segments ran out of space
+            if (m_maxMetadataBytes > 0 && addedSegments > 0 &&
+                (m_maxMediaBytes == 0 || mediaBytes + map.size <= m_maxMediaBytes))
+            {
+                m_bufferPuller->learnMetadataBytes(m_maxMetadataBytes, addedSegments + 1);
+            }
             gst_buffer_unmap(buffer, &map);
             GST_INFO_OBJECT(m_rialtoSink, "There's no space to add sample");
+            statistics.recordNoSpace();
+            bytesPending = kSampleBytes;
             break;
         }
 
+        mediaBytes += map.size;
+        statistics.recordBytesSent(map.size);
+        flightRecorder.record(FlightRecorderEvent::SEGMENT, map.size,
+                              GST_BUFFER_PTS_IS_VALID(buffer) ? static_cast<int64_t>(GST_BUFFER_PTS(buffer)) : -1);
         gst_buffer_unmap(buffer, &map);
         rialto_mse_base_sink_pop_sample(RIALTO_MSE_BASE_SINK(m_rialtoSink));
         addedSegments++;
     }
 
+    // The batch was only capped by the learnt metadata size and it fitted
+    if (addedSegments == kMaxSegments && kMaxSegments < m_frameCount)
+    {
+        m_bufferPuller->decayMetadataBytes();
+    }
+
     firebolt::rialto::MediaSourceStatus status = firebolt::rialto::MediaSourceStatus::OK;
     if (isEos)
     {
@@ -722,25 +1180,31 @@ void PullBufferMessage::handle()
     {
         status = firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES;
     }
+    flightRecorder.record(FlightRecorderEvent::HAVE_DATA, static_cast<int64_t>(status), addedSegments);
+    statistics.recordBytesPending(bytesPending);
+    statistics.recordHaveData(status, addedSegments,
+                              std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                    m_needDataTime));
 
-    m_player->m_backendQueue->postMessage(
-        std::make_shared<HaveDataMessage>(status, m_sourceId, m_needDataRequestId, m_player));
+    sendHaveData(status);
 }
 
 NeedDataMessage::NeedDataMessage(int sourceId, size_t frameCount, unsigned int needDataRequestId,
+                                 const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
                                  GStreamerMSEMediaPlayerClient *player)
-    : m_sourceId(sourceId), m_frameCount(frameCount), m_needDataRequestId(needDataRequestId), m_player(player)
+    : m_sourceId(sourceId), m_frameCount(frameCount), m_needDataRequestId(needDataRequestId), m_shmInfo(shmInfo),
+      m_needDataTime(std::chrono::steady_clock::now()), m_player(player)
 {
 }
 
 void NeedDataMessage::handle()
 {
-    if (!m_player->requestPullBuffer(m_sourceId, m_frameCount, m_needDataRequestId))
+    if (!m_player->requestPullBuffer(m_sourceId, m_frameCount, m_needDataRequestId, m_shmInfo, m_needDataTime))
     {
         GST_ERROR("Failed to pull buffer for sourceId=%d and NeedDataRequestId %u", m_sourceId, m_needDataRequestId);
         m_player->m_backendQueue->postMessage(
-            std::make_shared<HaveDataMessage>(firebolt::rialto::MediaSourceStatus::ERROR, m_sourceId,
-                                              m_needDataRequestId, m_player));
+            m_player->m_haveDataMessages.acquire(firebolt::rialto::MediaSourceStatus::ERROR, m_sourceId,
+                                                 m_needDataRequestId, m_player));
     }
 }
 
@@ -799,3 +1263,32 @@ void SetDurationMessage::handle()
 {
     m_targetDuration = m_newDuration;
 }
+
+CreateBackendMessage::CreateBackendMessage(GStreamerMSEMediaPlayerClient *player) : m_player(player) {}
+
+void CreateBackendMessage::handle()
+{
+    m_player->m_backendCreatedPromise.set_value(m_player->createBackendDo());
+}
+
+void CreateBackendMessage::skip()
+{
+    m_player->m_backendCreatedPromise.set_value(false);
+}
+
+SetSuspendedMessage::SetSuspendedMessage(bool isSuspended, GStreamerMSEMediaPlayerClient *player)
+    : m_isSuspended(isSuspended), m_player(player)
+{
+}
+
+void SetSuspendedMessage::handle()
+{
+    if (m_isSuspended)
+    {
+        m_player->suspendDo();
+    }
+    else
+    {
+        m_player->resumeDo();
+    }
+}
@@ -20,9 +20,12 @@
 
 #include "IMessageQueue.h"
 #include "MediaPlayerClientBackendInterface.h"
+#include "MessagePool.h"
 #include <IMediaPipeline.h>
 #include <MediaCommon.h>
+#include <chrono>
 #include <condition_variable>
+#include <future>
 #include <gst/gst.h>
 #include <mutex>
 #include <thread>
@@ -39,6 +42,7 @@
 #include "BufferParser.h"
 #include "RialtoGStreamerMSEBaseSink.h"
 #include "RialtoGStreamerMSEBaseSinkCallbacks.h"
+#include "SourceTable.h"
 #include <atomic>
 #include <unordered_set>
 
@@ -47,6 +51,8 @@
 
 class GStreamerMSEMediaPlayerClient;
 
+class PullBufferMessage;
+
 class BufferPuller
 {
 public:
@@ -55,13 +61,41 @@ public:
 
     void start();
     void stop();
+    // Called from the rialto client thread and from the backend thread, a request sent again is not pulled twice
     bool requestPullBuffer(int sourceId, size_t frameCount, unsigned int needDataRequestId,
-                           GStreamerMSEMediaPlayerClient *player);
+                           const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                           std::chrono::steady_clock::time_point needDataTime, GStreamerMSEMediaPlayerClient *player);
+    // Called once the request was answered
+    void completeRequest(unsigned int needDataRequestId);
+    // A request is superseded once a request with a newer id was posted, whatever the order of posting, the newer one
+    // takes all the queued samples
+    bool isSuperseded(unsigned int needDataRequestId) const;
+    // Cancels the requests posted so far, the queued pulls are skipped and the one in progress stops at the next frame.
+    // The learnt metadata size is forgotten too, as the server cancels the requests before a seek, a flush or a
+    // source removal, after which the segments may differ.
+    void cancelPulls();
+    uint32_t getCancelGeneration() const;
+    // The number of segments whose metadata fits in the space, as far as learnt from the requests that ran out of it
+    size_t getMaxSegments(uint32_t maxMetadataBytes) const;
+    // Called when the metadata of a number of segments did not fit in the space, while their media did
+    void learnMetadataBytes(uint32_t maxMetadataBytes, size_t segments);
+    // Called when a request took all the segments the learnt metadata size allows, without running out of space
+    void decayMetadataBytes();
 
 private:
     std::unique_ptr<IMessageQueue> m_queue;
     GstElement *m_rialtoSink;
     std::shared_ptr<BufferParser> m_bufferParser;
+    MessagePool<PullBufferMessage> m_pullBufferMessages;
+    std::atomic<unsigned int> m_latestNeedDataRequestId{0};
+    std::atomic<uint32_t> m_cancelGeneration{0};
+    // The size of the metadata written for a segment is not known in advance, it is only updated by the puller thread
+    std::atomic<uint32_t> m_metadataBytesPerSegment{0};
+    std::atomic<uint32_t> m_batchesFitted{0};
+    // The requests posted and not answered yet, only a few are outstanding so a vector keeps the bookkeeping
+    // allocation free
+    std::mutex m_requestsMutex;
+    std::vector<unsigned int> m_ongoingNeedDataRequests;
 };
 
 class HaveDataMessage : public Message
@@ -81,18 +115,29 @@ private:
 class PullBufferMessage : public Message
 {
 public:
-    PullBufferMessage(int sourceId, size_t frameCount, unsigned int needDataRequestId, GstElement *rialtoSink,
-                      const std::shared_ptr<BufferParser> &bufferParser, IMessageQueue &pullerQueue,
+    PullBufferMessage(int sourceId, size_t frameCount, unsigned int needDataRequestId,
+                      const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                      std::chrono::steady_clock::time_point needDataTime, GstElement *rialtoSink,
+                      const std::shared_ptr<BufferParser> &bufferParser, BufferPuller *bufferPuller,
                       GStreamerMSEMediaPlayerClient *player);
     void handle() override;
 
 private:
+    void sendHaveData(firebolt::rialto::MediaSourceStatus status);
+    bool isCancelled() const;
+
     int m_sourceId;
     size_t m_frameCount;
     unsigned int m_needDataRequestId;
+    // The shared memory space of the request, 0 when the server did not tell it
+    uint32_t m_maxMediaBytes;
+    uint32_t m_maxMetadataBytes;
+    std::chrono::steady_clock::time_point m_needDataTime;
     GstElement *m_rialtoSink;
     std::shared_ptr<BufferParser> m_bufferParser;
-    IMessageQueue &m_pullerQueue;
+    BufferPuller *m_bufferPuller;
+    // The cancel generation of the puller when the request was posted
+    uint32_t m_cancelGeneration;
     GStreamerMSEMediaPlayerClient *m_player;
 };
 
@@ -100,13 +145,16 @@ class NeedDataMessage : public Message
 {
 public:
     NeedDataMessage(int sourceId, size_t frameCount, unsigned int needDataRequestId,
-                    GStreamerMSEMediaPlayerClient *player);
+                    const firebolt::rialto::MediaPlayerShmInfo &shmInfo, GStreamerMSEMediaPlayerClient *player);
     void handle() override;
 
 private:
     int m_sourceId;
     size_t m_frameCount;
     unsigned int m_needDataRequestId;
+    firebolt::rialto::MediaPlayerShmInfo m_shmInfo;
+    // When the server asked for the data, to measure the time to answer
+    std::chrono::steady_clock::time_point m_needDataTime;
     GStreamerMSEMediaPlayerClient *m_player;
 };
 
@@ -166,6 +214,28 @@ private:
     int64_t &m_targetDuration;
 };
 
+class CreateBackendMessage : public Message
+{
+public:
+    explicit CreateBackendMessage(GStreamerMSEMediaPlayerClient *player);
+    void handle() override;
+    void skip() override;
+
+private:
+    GStreamerMSEMediaPlayerClient *m_player;
+};
+
+class SetSuspendedMessage : public Message
+{
+public:
+    SetSuspendedMessage(bool isSuspended, GStreamerMSEMediaPlayerClient *player);
+    void handle() override;
+
+private:
+    bool m_isSuspended;
+    GStreamerMSEMediaPlayerClient *m_player;
+};
+
 enum class SeekingState
 {
     IDLE,
@@ -190,8 +260,9 @@ private:
     RialtoMSEBaseSink *m_rialtoSink;
     std::shared_ptr<BufferPuller> m_bufferPuller;
     SeekingState m_seekingState = SeekingState::IDLE;
-    std::unordered_set<uint32_t> m_ongoingNeedDataRequests;
     firebolt::rialto::MediaSourceType m_type = firebolt::rialto::MediaSourceType::UNKNOWN;
+    // Copy of the attached source, to attach it again when resuming
+    std::shared_ptr<firebolt::rialto::IMediaPipeline::MediaSource> m_mediaSource;
 };
 
 class GStreamerMSEMediaPlayerClient : public firebolt::rialto::IMediaPipelineClient,
@@ -201,6 +272,8 @@ class GStreamerMSEMediaPlayerClient : public firebolt::rialto::IMediaPipelineCli
     friend class PullBufferMessage;
     friend class HaveDataMessage;
     friend class QosMessage;
+    friend class CreateBackendMessage;
+    friend class SetSuspendedMessage;
 
 public:
     GStreamerMSEMediaPlayerClient(
@@ -229,6 +302,10 @@ public:
                const std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &mediaSegment);
 
     bool createBackend();
+    // Starts creating the backend on the backend thread, so that it overlaps with the pipeline setup.
+    void createBackendAsync();
+    // Waits for the backend started by createBackendAsync, returns true straight away if it was created synchronously.
+    bool waitForBackend();
     void play();
     void pause();
     void stop();
@@ -243,13 +320,19 @@ public:
     void setVideoRectangle(const std::string &rectangleString);
     std::string getVideoRectangle();
 
-    bool requestPullBuffer(int streamId, size_t frameCount, unsigned int needDataRequestId);
+    bool requestPullBuffer(int streamId, size_t frameCount, unsigned int needDataRequestId,
+                           const firebolt::rialto::MediaPlayerShmInfo &shmInfo,
+                           std::chrono::steady_clock::time_point needDataTime);
     bool handleQos(int sourceId, firebolt::rialto::QosInfo qosInfo);
     bool handleBufferUnderflow(int sourceId);
     void notifySourceStartedSeeking(int32_t sourceId);
     void startPullingDataIfSeekFinished();
     void stopStreaming();
     void destroyClientBackend();
+    // Stops the backend and removes the remaining sources, so that the session can be loaded again by another pipeline.
+    bool prepareForReuse();
+    uint32_t getMaxVideoWidth() const { return m_maxWidth; }
+    uint32_t getMaxVideoHeight() const { return m_maxHeight; }
     bool renderFrame(RialtoMSEBaseSink *sink);
     void setVolume(double volume);
     double getVolume();
@@ -257,11 +340,21 @@ public:
     bool getMute();
     void setAudioStreamsInfo(int32_t audioStreams, bool isAudioOnly);
     void setVideoStreamsInfo(int32_t videoStreams, bool isVideoOnly);
+    // Releases the media pipeline of the server, keeping the position and the attached sources.
+    void suspend();
+    // Creates the media pipeline again and resumes from the samples retained by the sinks.
+    void resume();
 
 private:
     bool areAllStreamsAttached();
+    bool createBackendDo();
+    void suspendDo();
+    void resumeDo();
 
     std::unique_ptr<IMessageQueue> m_backendQueue;
+    // The requests that cannot go straight to a puller are posted to the backend queue, their messages are recycled
+    MessagePool<NeedDataMessage> m_needDataMessages;
+    MessagePool<HaveDataMessage> m_haveDataMessages;
     std::shared_ptr<IMessageQueueFactory> m_messageQueueFactory;
     std::shared_ptr<firebolt::rialto::client::MediaPlayerClientBackendInterface> m_clientBackend;
     int64_t m_position;
@@ -270,19 +363,33 @@ private:
     bool m_mute = false;
     std::mutex m_playerMutex;
     std::unordered_map<int32_t, AttachedSource> m_attachedSources;
+    // The pullers of the attached sources, looked up by the rialto client thread without going through the backend
+    SourceTable<BufferPuller> m_bufferPullers;
     bool m_wasAllSourcesAttachedSent = false;
     int32_t m_audioStreams;
     int32_t m_videoStreams;
-    SeekingState m_serverSeekingState = SeekingState::IDLE;
+    // Read by the rialto client thread, need data requests only go straight to the pullers while no seek is ongoing
+    std::atomic<SeekingState> m_serverSeekingState{SeekingState::IDLE};
 
     struct Rectangle
     {
         unsigned int x, y, width, height;
     } m_videoRectangle;
+    bool m_wasVideoRectangleSet = false;
 
     // To check if the backend message queue and pulling of data to serve backend is stopped or not
     bool m_streamingStopped;
 
     const uint32_t m_maxWidth;
     const uint32_t m_maxHeight;
+
+    // Set once the media player backend exists, a reused client only needs to load it again
+    bool m_isBackendCreated = false;
+    std::promise<bool> m_backendCreatedPromise;
+    std::shared_future<bool> m_backendCreated;
+
+    // Set when the sinks retain samples, so that the server pipeline can be released while the application is inactive
+    const bool m_canSuspend;
+    bool m_isSuspended = false;
+    bool m_isPlayRequested = false;
 };
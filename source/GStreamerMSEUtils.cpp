@@ -17,6 +17,8 @@
  */
 
 #include "GStreamerMSEUtils.h"
+#include <cerrno>
+#include <cstdlib>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -61,3 +63,28 @@ void rialto_mse_sink_setup_supported_caps(GstElementClass *elementClass,
     gst_element_class_add_pad_template(elementClass, sinktempl);
     gst_caps_unref(caps);
 }
+
+std::size_t rialto_mse_sink_get_suspend_retain_bytes()
+{
+    const char *retainBytesStr = getenv("RIALTO_SUSPEND_RETAIN_BYTES");
+    if (!retainBytesStr)
+    {
+        return 0;
+    }
+
+    char *end;
+    errno = 0;
+    unsigned long val = strtoul(retainBytesStr, &end, 10);
+    if (*end != '\0' || errno == ERANGE)
+    {
+        GST_WARNING("Failed to parse 'RIALTO_SUSPEND_RETAIN_BYTES' env variable - '%s'", retainBytesStr);
+        return 0;
+    }
+    return val;
+}
+
+std::string rialto_mse_sink_get_flight_recorder_dir()
+{
+    const char *dir = getenv("RIALTO_FLIGHT_RECORDER_DIR");
+    return dir ? dir : "/tmp";
+}
@@ -21,9 +21,17 @@
 
 #include <gst/gst.h>
 
+#include <cstddef>
 #include <string>
 #include <vector>
 void rialto_mse_sink_setup_supported_caps(GstElementClass *elementClass,
                                           const std::vector<std::string> &supportedMimeType);
 
+// Bytes of already sent samples that each MSE sink keeps to resume after the application was inactive,
+// set with RIALTO_SUSPEND_RETAIN_BYTES. 0 keeps the server pipeline while inactive.
+std::size_t rialto_mse_sink_get_suspend_retain_bytes();
+
+// Directory of the flight recorder dumps, set with RIALTO_FLIGHT_RECORDER_DIR. Empty disables the dumps.
+std::string rialto_mse_sink_get_flight_recorder_dir();
+
 #endif // GSTREAMERMSEUTILS_H
\ No newline at end of file
@@ -17,14 +17,31 @@
  */
 
 #include "GStreamerWebAudioPlayerClient.h"
+#include "Tracing.h"
 #include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <limits>
 #include <string.h>
 #include <thread>
 
 namespace
 {
+/**
+ * @brief The duration of audio data that can be queued before the sample submission blocks.
+ */
+constexpr std::chrono::milliseconds kMaxQueuedDuration{200};
+
+/**
+ * @brief The submission budget while the audio format is unknown, 200 ms of 48 kHz stereo 16 bit audio.
+ */
+constexpr gsize kDefaultMaxQueuedBytes{38400};
+
+/**
+ * @brief The minimum time between two buffer delay queries, the delay is estimated locally in between.
+ */
+constexpr std::chrono::milliseconds kBufferDelayQueryInterval{100};
+
 bool parseGstStructureFormat(const std::string &format, uint32_t &sampleSize, bool &isBigEndian, bool &isSigned,
                              bool &isFloat)
 {
@@ -71,13 +88,41 @@ bool operator!=(const firebolt::rialto::WebAudioPcmConfig &lac, const firebolt::
 }
 } // namespace
 
+NewSampleMessage::NewSampleMessage(GstBuffer *buffer, GStreamerWebAudioPlayerClient *player)
+    : m_buffer{buffer}, m_player{player}
+{
+}
+
+NewSampleMessage::~NewSampleMessage()
+{
+    if (m_buffer)
+    {
+        gst_buffer_unref(m_buffer);
+    }
+}
+
+void NewSampleMessage::handle()
+{
+    m_player->handleNewSample(m_buffer);
+    m_buffer = nullptr;
+}
+
+void NewSampleMessage::skip()
+{
+    m_player->releaseQueuedBytes(gst_buffer_get_size(m_buffer));
+}
+
 GStreamerWebAudioPlayerClient::GStreamerWebAudioPlayerClient(
     std::unique_ptr<firebolt::rialto::client::WebAudioClientBackendInterface> &&webAudioClientBackend,
     std::unique_ptr<IMessageQueue> &&backendQueue, WebAudioSinkCallbacks callbacks,
     std::shared_ptr<ITimerFactory> timerFactory)
     : m_backendQueue{std::move(backendQueue)}, m_clientBackend{std::move(webAudioClientBackend)}, m_isOpen{false},
-      m_dataBuffers{}, m_timerFactory{timerFactory}, m_pushSamplesTimer{nullptr}, m_preferredFrames{0}, m_maximumFrames{0},
-      m_supportDeferredPlay{false}, m_isEos{false}, m_frameSize{0}, m_mimeType{}, m_config{{}}, m_callbacks{callbacks}
+      m_dataBuffers{}, m_queuedBytes{0}, m_maxQueuedBytes{kDefaultMaxQueuedBytes}, m_isFlushing{false},
+      m_timerFactory{timerFactory}, m_pushSamplesTimer{nullptr}, m_preferredFrames{0}, m_maximumFrames{0},
+      m_supportDeferredPlay{false}, m_isPlaying{false}, m_isDrained{true}, m_isPlayPending{false}, m_framesWritten{0},
+      m_openTime{}, m_volume{1.0}, m_cachedFramesWritten{0}, m_cachedDelayFrames{0}, m_delayTime{},
+      m_bufferDelayQueryTime{}, m_cachedRate{0}, m_cachedMaxQueuedFrames{0}, m_isEos{false}, m_wasEosSet{false},
+      m_frameSize{0}, m_mimeType{}, m_config{{}}, m_callbacks{callbacks}
 {
     m_backendQueue->start();
 }
@@ -85,6 +130,7 @@ GStreamerWebAudioPlayerClient::GStreamerWebAudioPlayerClient(
 GStreamerWebAudioPlayerClient::~GStreamerWebAudioPlayerClient()
 {
     m_backendQueue->stop();
+    clearDataBuffers();
 }
 
 bool GStreamerWebAudioPlayerClient::open(GstCaps *caps)
@@ -136,20 +182,43 @@ bool GStreamerWebAudioPlayerClient::open(GstCaps *caps)
             {
                 if (m_isOpen)
                 {
-                    // Destroy the previously created player
-                    m_clientBackend->destroyWebAudioBackend();
+                    // Give up the previously created player
+                    closeWebAudioBackend();
                 }
 
                 uint32_t priority = 1;
+                m_openTime = std::chrono::steady_clock::now();
+                m_framesWritten = 0;
+                m_isDrained = true;
+                m_wasEosSet = false;
                 if (m_clientBackend->createWebAudioBackend(shared_from_this(), audioMimeType, priority, &config))
                 {
                     if (!m_clientBackend->getDeviceInfo(m_preferredFrames, m_maximumFrames, m_supportDeferredPlay))
                     {
                         GST_ERROR("GetDeviceInfo failed, could not process samples");
                     }
+                    if (m_volume != 1.0 && !m_clientBackend->setVolume(m_volume))
+                    {
+                        GST_WARNING("Failed to set the volume");
+                    }
                     m_frameSize = (pcm.sampleSize * pcm.channels) / CHAR_BIT;
                     m_isOpen = true;
 
+                    {
+                        std::lock_guard<std::mutex> lock(m_submitMutex);
+                        m_maxQueuedBytes = std::max<gsize>(m_frameSize * pcm.rate * kMaxQueuedDuration.count() / 1000,
+                                                           m_frameSize);
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(m_delayMutex);
+                        m_cachedFramesWritten = 0;
+                        m_cachedDelayFrames = 0;
+                        m_delayTime = std::chrono::steady_clock::now();
+                        m_bufferDelayQueryTime = {};
+                        m_cachedRate = pcm.rate;
+                        m_cachedMaxQueuedFrames = pcm.rate * kMaxQueuedDuration.count() / 1000;
+                    }
+
                     // Store config
                     m_config.pcm = pcm;
                     m_mimeType = audioMimeType;
@@ -173,9 +242,21 @@ bool GStreamerWebAudioPlayerClient::close()
     m_backendQueue->callInEventLoop(
         [&]()
         {
-            m_clientBackend->destroyWebAudioBackend();
+            closeWebAudioBackend();
             m_pushSamplesTimer.reset();
             m_isOpen = false;
+            m_isPlayPending = false;
+            clearDataBuffers();
+
+            {
+                // Samples queued after this point are dropped, which releases their bytes to a waiting submission
+                std::lock_guard<std::mutex> lock(m_submitMutex);
+                m_maxQueuedBytes = kDefaultMaxQueuedBytes;
+                m_submitCondVar.notify_all();
+            }
+
+            std::lock_guard<std::mutex> lock(m_delayMutex);
+            m_cachedRate = 0;
         });
 
     return true;
@@ -189,13 +270,20 @@ bool GStreamerWebAudioPlayerClient::play()
     m_backendQueue->callInEventLoop(
         [&]()
         {
-            if (m_isOpen)
+            if (!m_isOpen)
+            {
+                GST_ERROR("No web audio backend");
+            }
+            else if (m_supportDeferredPlay || m_framesWritten >= m_preferredFrames)
             {
                 result = m_clientBackend->play();
+                setPlaying(result);
             }
             else
             {
-                GST_ERROR("No web audio backend");
+                GST_INFO("Play delayed until %u frames are primed", m_preferredFrames);
+                m_isPlayPending = true;
+                result = true;
             }
         });
 
@@ -212,7 +300,9 @@ bool GStreamerWebAudioPlayerClient::pause()
         {
             if (m_isOpen)
             {
+                m_isPlayPending = false;
                 result = m_clientBackend->pause();
+                setPlaying(m_isPlaying && !result);
             }
             else
             {
@@ -234,8 +324,10 @@ bool GStreamerWebAudioPlayerClient::setEos()
             if (m_isOpen && !m_isEos)
             {
                 m_isEos = true;
+                m_wasEosSet = true;
                 if (m_dataBuffers.empty())
                 {
+                    playIfPending();
                     result = m_clientBackend->setEos();
                 }
                 else
@@ -263,6 +355,86 @@ bool GStreamerWebAudioPlayerClient::isOpen()
     return result;
 }
 
+bool GStreamerWebAudioPlayerClient::setVolume(double volume)
+{
+    GST_DEBUG("entry:");
+
+    bool result = true;
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            m_volume = volume;
+            if (m_isOpen)
+            {
+                result = m_clientBackend->setVolume(volume);
+            }
+        });
+
+    return result;
+}
+
+double GStreamerWebAudioPlayerClient::getVolume()
+{
+    GST_DEBUG("entry:");
+
+    double volume = 1.0;
+    m_backendQueue->callInEventLoop([&]() { volume = m_volume; });
+
+    return volume;
+}
+
+GstStructure *GStreamerWebAudioPlayerClient::getStats()
+{
+    GST_DEBUG("entry:");
+
+    uint64_t queuedSamples = 0;
+    uint64_t queuedBytes = 0;
+    GstClockTime queuedTime = 0;
+    m_backendQueue->callInEventLoop(
+        [&]()
+        {
+            queuedSamples = m_dataBuffers.size();
+            {
+                std::lock_guard<std::mutex> lock(m_submitMutex);
+                queuedBytes = m_queuedBytes;
+            }
+            if (m_frameSize != 0 && m_config.pcm.rate != 0)
+            {
+                queuedTime = gst_util_uint64_scale(queuedBytes / m_frameSize, GST_SECOND, m_config.pcm.rate);
+            }
+        });
+
+    return m_statistics.createStructure(queuedSamples, queuedBytes, queuedTime);
+}
+
+bool GStreamerWebAudioPlayerClient::getLatency(GstClockTime &minLatency, GstClockTime &maxLatency)
+{
+    std::lock_guard<std::mutex> lock(m_delayMutex);
+    if (0 == m_cachedRate)
+    {
+        return false;
+    }
+
+    const uint32_t kDelayFrames = getEstimatedDelayFrames(std::chrono::steady_clock::now());
+    minLatency = gst_util_uint64_scale(kDelayFrames, GST_SECOND, m_cachedRate);
+    maxLatency = gst_util_uint64_scale(static_cast<guint64>(kDelayFrames) + m_cachedMaxQueuedFrames, GST_SECOND,
+                                       m_cachedRate);
+    return true;
+}
+
+gint64 GStreamerWebAudioPlayerClient::getPosition()
+{
+    std::lock_guard<std::mutex> lock(m_delayMutex);
+    if (0 == m_cachedRate)
+    {
+        return -1;
+    }
+
+    const uint32_t kDelayFrames = getEstimatedDelayFrames(std::chrono::steady_clock::now());
+    const uint64_t kPlayedFrames = (m_cachedFramesWritten > kDelayFrames) ? m_cachedFramesWritten - kDelayFrames : 0;
+    return static_cast<gint64>(gst_util_uint64_scale(kPlayedFrames, GST_SECOND, m_cachedRate));
+}
+
 void GStreamerWebAudioPlayerClient::notifyPushSamplesTimerExpired()
 {
     m_backendQueue->callInEventLoop([&]() { pushSamples(); });
@@ -272,24 +444,112 @@ bool GStreamerWebAudioPlayerClient::notifyNewSample(GstBuffer *buf)
 {
     GST_DEBUG("entry:");
 
-    bool result = false;
+    if (!buf)
+    {
+        return false;
+    }
+
+    const gsize bufferSize = gst_buffer_get_size(buf);
+    {
+        std::unique_lock<std::mutex> lock(m_submitMutex);
+        if (!m_isFlushing && m_queuedBytes >= m_maxQueuedBytes)
+        {
+            GST_DEBUG("Queued web audio data exceeds %" G_GSIZE_FORMAT " bytes, waiting", m_maxQueuedBytes);
+            const auto kWaitStart = std::chrono::steady_clock::now();
+            m_submitCondVar.wait(lock, [this]() { return m_isFlushing || m_queuedBytes < m_maxQueuedBytes; });
+            const auto kWaitEnd = std::chrono::steady_clock::now();
+            m_statistics.recordChainBlocked(
+                std::chrono::duration_cast<std::chrono::microseconds>(kWaitEnd - kWaitStart));
+            Tracer::instance().complete("ChainBlocked", kWaitStart, kWaitEnd);
+        }
+        if (m_isFlushing)
+        {
+            GST_DEBUG("Flushing, dropping the new sample");
+            gst_buffer_unref(buf);
+            return false;
+        }
+        m_queuedBytes += bufferSize;
+    }
+
+    if (!m_backendQueue->postMessage(std::make_shared<NewSampleMessage>(buf, this)))
+    {
+        GST_ERROR("Could not queue the new sample");
+        releaseQueuedBytes(bufferSize);
+        return false;
+    }
+
+    return true;
+}
+
+void GStreamerWebAudioPlayerClient::startFlush()
+{
+    GST_DEBUG("entry:");
+
+    {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+        m_isFlushing = true;
+        m_submitCondVar.notify_all();
+    }
+
     m_backendQueue->callInEventLoop(
         [&]()
         {
-            if (buf)
+            if (m_pushSamplesTimer)
             {
-                if (m_pushSamplesTimer)
-                {
-                    m_pushSamplesTimer->cancel();
-                    m_pushSamplesTimer.reset();
-                }
-                m_dataBuffers.push(buf);
-                pushSamples();
-                result = true;
+                m_pushSamplesTimer->cancel();
+                m_pushSamplesTimer.reset();
             }
+            clearDataBuffers();
         });
+}
 
-    return result;
+void GStreamerWebAudioPlayerClient::stopFlush()
+{
+    GST_DEBUG("entry:");
+
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    m_isFlushing = false;
+}
+
+void GStreamerWebAudioPlayerClient::handleNewSample(GstBuffer *buf)
+{
+    if (!m_isOpen)
+    {
+        // There is no player before the caps are set or after it is closed, nothing would push the sample
+        const gsize kBufferSize = gst_buffer_get_size(buf);
+        GST_WARNING("No web audio backend, dropping the sample of %" G_GSIZE_FORMAT " bytes", kBufferSize);
+        m_statistics.recordDroppedSample(kBufferSize);
+        releaseQueuedBytes(kBufferSize);
+        gst_buffer_unref(buf);
+        return;
+    }
+
+    if (m_pushSamplesTimer)
+    {
+        m_pushSamplesTimer->cancel();
+        m_pushSamplesTimer.reset();
+    }
+    m_dataBuffers.push(buf);
+    pushSamples();
+}
+
+void GStreamerWebAudioPlayerClient::clearDataBuffers()
+{
+    gsize droppedBytes = 0;
+    while (!m_dataBuffers.empty())
+    {
+        droppedBytes += gst_buffer_get_size(m_dataBuffers.front());
+        gst_buffer_unref(m_dataBuffers.front());
+        m_dataBuffers.pop();
+    }
+    releaseQueuedBytes(droppedBytes);
+}
+
+void GStreamerWebAudioPlayerClient::releaseQueuedBytes(gsize bytes)
+{
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    m_queuedBytes = (bytes < m_queuedBytes) ? m_queuedBytes - bytes : 0;
+    m_submitCondVar.notify_all();
 }
 
 void GStreamerWebAudioPlayerClient::pushSamples()
@@ -300,22 +560,38 @@ void GStreamerWebAudioPlayerClient::pushSamples()
         return;
     }
 
+    Tracer &tracer = Tracer::instance();
+    TraceScope trace{"PushSamples", {{"buffers", static_cast<int64_t>(m_dataBuffers.size())}}, tracer};
+
+    // Web audio has no need data, each poll of the available buffer is counted as a request instead
+    const auto kPushStart = std::chrono::steady_clock::now();
     uint32_t availableFrames = 0u;
+    uint32_t pushedFrames = 0u;
+    bool isDataWritten = false;
     do
     {
         if (!m_clientBackend->getBufferAvailable(availableFrames))
         {
             GST_ERROR("getBufferAvailable failed, could not process the samples");
             // clear the queue if getBufferAvailable failed
-            std::queue<GstBuffer *> empty;
-            std::swap(m_dataBuffers, empty);
+            clearDataBuffers();
+        }
+        else if (0 == availableFrames)
+        {
+            m_statistics.recordNoSpace();
         }
-        else if (0 != availableFrames)
+        else
         {
+            m_statistics.recordNeedData(availableFrames);
             bool writeFailure = false;
             GstBuffer *buffer = m_dataBuffers.front();
             gsize bufferSize = gst_buffer_get_size(buffer);
             auto framesToWrite = std::min(availableFrames, static_cast<uint32_t>(bufferSize / m_frameSize));
+            if (m_framesWritten < m_preferredFrames)
+            {
+                // Prime the device with exactly the preferred number of frames
+                framesToWrite = std::min(framesToWrite, static_cast<uint32_t>(m_preferredFrames - m_framesWritten));
+            }
             if (framesToWrite > 0)
             {
                 GstMapInfo bufferMap;
@@ -326,6 +602,7 @@ void GStreamerWebAudioPlayerClient::pushSamples()
                 }
                 else
                 {
+                    TraceScope writeTrace{"WriteBuffer", {{"frames", framesToWrite}}, tracer};
                     if (!m_clientBackend->writeBuffer(framesToWrite, bufferMap.data))
                     {
                         GST_ERROR("Could not map audio buffer, discarding buffer!");
@@ -335,27 +612,66 @@ void GStreamerWebAudioPlayerClient::pushSamples()
                 }
             }
 
+            if (!writeFailure && framesToWrite > 0)
+            {
+                if (0 == m_framesWritten)
+                {
+                    auto timeToFirstSample = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - m_openTime);
+                    m_statistics.recordTimeToFirstSample(timeToFirstSample);
+                    GST_INFO("Time to first sample: %" G_GINT64_FORMAT " us",
+                             static_cast<gint64>(timeToFirstSample.count()));
+                }
+                m_framesWritten += framesToWrite;
+                pushedFrames += framesToWrite;
+                m_statistics.recordBytesSent(framesToWrite * m_frameSize);
+                m_isDrained = false;
+                isDataWritten = true;
+                if (m_framesWritten >= m_preferredFrames)
+                {
+                    playIfPending();
+                }
+            }
+
             if ((!writeFailure) && (framesToWrite * m_frameSize < bufferSize))
             {
                 // Handle any leftover data
-                uint32_t leftoverData = bufferSize - (availableFrames * m_frameSize);
+                uint32_t leftoverData = bufferSize - (framesToWrite * m_frameSize);
                 gst_buffer_resize(buffer, framesToWrite * m_frameSize, leftoverData);
+                releaseQueuedBytes(framesToWrite * m_frameSize);
                 if ((leftoverData / m_frameSize == 0) && (m_dataBuffers.size() > 1))
                 {
-                    // If the leftover data is smaller than a frame, it must be processed with the next buffer
+                    // If the leftover data is smaller than a frame, it must be processed with the next buffer.
+                    // gst_buffer_append takes ownership of both buffers.
                     m_dataBuffers.pop();
                     m_dataBuffers.front() = gst_buffer_append(buffer, m_dataBuffers.front());
-                    gst_buffer_unref(buffer);
+                }
+                else if (0 == framesToWrite)
+                {
+                    // Less than a frame left, wait for more data
+                    break;
                 }
             }
             else
             {
                 m_dataBuffers.pop();
                 gst_buffer_unref(buffer);
+                releaseQueuedBytes(bufferSize);
             }
         }
     } while (!m_dataBuffers.empty() && availableFrames != 0);
 
+    m_statistics.recordHaveData(isDataWritten ? firebolt::rialto::MediaSourceStatus::OK
+                                              : firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES,
+                                pushedFrames,
+                                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                      kPushStart));
+
+    if (isDataWritten)
+    {
+        updateBufferDelay();
+    }
+
     // If we still have samples stored that could not be pushed
     // This avoids any stoppages in the pushing of samples to the server if the consumption of
     // samples is slow.
@@ -366,10 +682,111 @@ void GStreamerWebAudioPlayerClient::pushSamples()
     }
     else if (m_isEos)
     {
+        playIfPending();
         m_clientBackend->setEos();
     }
 }
 
+void GStreamerWebAudioPlayerClient::closeWebAudioBackend()
+{
+    bool isDrained = m_isDrained;
+    if (m_isOpen && !m_isPlaying && !isDrained && !m_wasEosSet)
+    {
+        // A paused player has played out everything written to it once the server holds no more frames
+        uint32_t delayFrames = 0;
+        isDrained = m_clientBackend->getBufferDelay(delayFrames) && 0 == delayFrames;
+    }
+
+    if (m_isOpen && !m_isPlaying && isDrained && !m_wasEosSet)
+    {
+        // Nothing is left to be played, so the player can be reused by a later open. A player which reached EOS
+        // does not accept more data, so it is never reused.
+        m_clientBackend->releaseWebAudioBackend();
+    }
+    else
+    {
+        m_clientBackend->destroyWebAudioBackend();
+    }
+    setPlaying(false);
+}
+
+void GStreamerWebAudioPlayerClient::playIfPending()
+{
+    if (!m_isPlayPending)
+    {
+        return;
+    }
+
+    m_isPlayPending = false;
+    GST_INFO("Device primed with %" G_GUINT64_FORMAT " frames, starting playback",
+             static_cast<guint64>(m_framesWritten));
+    setPlaying(m_clientBackend->play());
+    if (!m_isPlaying)
+    {
+        std::string errMessage = "Failed to play web audio";
+        GST_ERROR("%s", errMessage.c_str());
+        if (m_callbacks.errorCallback)
+        {
+            m_callbacks.errorCallback(errMessage.c_str());
+        }
+    }
+}
+
+void GStreamerWebAudioPlayerClient::setPlaying(bool isPlaying)
+{
+    std::lock_guard<std::mutex> lock(m_delayMutex);
+    // Account for the frames played so far, so that the estimate restarts from the state change
+    const auto kNow = std::chrono::steady_clock::now();
+    m_cachedDelayFrames = getEstimatedDelayFrames(kNow);
+    m_delayTime = kNow;
+    m_isPlaying = isPlaying;
+}
+
+void GStreamerWebAudioPlayerClient::updateBufferDelay()
+{
+    // Querying the server on every push costs a round trip per sample, so in between the queries the frames just
+    // written are added to the estimated delay
+    const auto kNow = std::chrono::steady_clock::now();
+    uint32_t delayFrames = 0;
+    bool isDelayQueried = false;
+    if (kNow - m_bufferDelayQueryTime >= kBufferDelayQueryInterval)
+    {
+        isDelayQueried = m_clientBackend->getBufferDelay(delayFrames);
+        if (isDelayQueried)
+        {
+            m_bufferDelayQueryTime = kNow;
+        }
+        else
+        {
+            GST_WARNING("getBufferDelay failed, latency and position may be inaccurate");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_delayMutex);
+    if (!isDelayQueried)
+    {
+        const uint64_t kEstimatedDelayFrames =
+            getEstimatedDelayFrames(kNow) + (m_framesWritten - m_cachedFramesWritten);
+        delayFrames = static_cast<uint32_t>(
+            std::min<uint64_t>(kEstimatedDelayFrames, std::numeric_limits<uint32_t>::max()));
+    }
+    m_cachedFramesWritten = m_framesWritten;
+    m_cachedDelayFrames = delayFrames;
+    m_delayTime = kNow;
+}
+
+uint32_t GStreamerWebAudioPlayerClient::getEstimatedDelayFrames(std::chrono::steady_clock::time_point now) const
+{
+    if (!m_isPlaying || 0 == m_cachedRate)
+    {
+        return m_cachedDelayFrames;
+    }
+
+    const auto kElapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_delayTime);
+    const uint64_t kPlayedFrames = gst_util_uint64_scale(kElapsed.count(), m_cachedRate, 1000000);
+    return (kPlayedFrames >= m_cachedDelayFrames) ? 0 : m_cachedDelayFrames - static_cast<uint32_t>(kPlayedFrames);
+}
+
 bool GStreamerWebAudioPlayerClient::isNewConfig(const std::string &audioMimeType,
                                                 const firebolt::rialto::WebAudioConfig &config)
 {
@@ -399,6 +816,13 @@ void GStreamerWebAudioPlayerClient::notifyState(firebolt::rialto::WebAudioPlayer
     case firebolt::rialto::WebAudioPlayerState::END_OF_STREAM:
     {
         GST_INFO("Notify end of stream.");
+        m_isDrained = true;
+        m_wasEosSet = true;
+        {
+            std::lock_guard<std::mutex> lock(m_delayMutex);
+            m_cachedDelayFrames = 0;
+            m_delayTime = std::chrono::steady_clock::now();
+        }
         if (m_callbacks.eosCallback)
         {
             m_callbacks.eosCallback();
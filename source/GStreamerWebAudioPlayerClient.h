@@ -20,6 +20,7 @@
 
 #include "IMessageQueue.h"
 #include "ITimer.h"
+#include "SinkStatistics.h"
 #include "WebAudioClientBackendInterface.h"
 #include <MediaCommon.h>
 #include <condition_variable>
@@ -31,6 +32,7 @@
 #include <vector>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -46,9 +48,26 @@ struct WebAudioSinkCallbacks
     std::function<void(firebolt::rialto::WebAudioPlayerState)> stateChangedCallback;
 };
 
+class GStreamerWebAudioPlayerClient;
+
+class NewSampleMessage : public Message
+{
+public:
+    NewSampleMessage(GstBuffer *buffer, GStreamerWebAudioPlayerClient *player);
+    ~NewSampleMessage() override;
+    void handle() override;
+    void skip() override;
+
+private:
+    GstBuffer *m_buffer;
+    GStreamerWebAudioPlayerClient *m_player;
+};
+
 class GStreamerWebAudioPlayerClient : public firebolt::rialto::IWebAudioPlayerClient,
                                       public std::enable_shared_from_this<GStreamerWebAudioPlayerClient>
 {
+    friend class NewSampleMessage;
+
 public:
     /**
      * @brief Constructor.
@@ -85,6 +104,10 @@ public:
     /**
      * @brief Play the web audio.
      *
+     * When deferred play is supported, the server is told to play straight away and starts
+     * as soon as the data lands. Otherwise play is requested once the preferred number of
+     * frames has been written.
+     *
      * @retval true on success.
      */
     bool play();
@@ -110,15 +133,73 @@ public:
      */
     bool isOpen();
 
+    /**
+     * @brief Sets the volume of the web audio. Applied when the player is opened if it is not open yet.
+     *
+     * @param[in] volume : The volume, from 0.0 to 1.0.
+     *
+     * @retval true on success.
+     */
+    bool setVolume(double volume);
+
+    /**
+     * @brief Gets the volume of the web audio.
+     *
+     * @retval the volume, from 0.0 to 1.0.
+     */
+    double getVolume();
+
+    /**
+     * @brief Gets the latency added by the web audio player.
+     *
+     * The minimum is the server buffer delay, the maximum adds the data that can be queued locally.
+     * Uses the values cached on the backend thread, so it does not call the server.
+     *
+     * @param[out] minLatency : The minimum latency.
+     * @param[out] maxLatency : The maximum latency.
+     *
+     * @retval true on success, false if the player is not open.
+     */
+    bool getLatency(GstClockTime &minLatency, GstClockTime &maxLatency);
+
+    /**
+     * @brief Gets the playback position, the frames written minus the server buffer delay.
+     *
+     * Uses the values cached on the backend thread, so it does not call the server.
+     *
+     * @retval the position in nanoseconds or -1 if unknown.
+     */
+    gint64 getPosition();
+
+    /**
+     * @brief Gets the data path statistics, for the "stats" property.
+     *
+     * @retval the new structure, owned by the caller.
+     */
+    GstStructure *getStats();
+
     /**
      * @brief Notifies that there is a new sample in gstreamer.
      *
-     * @param[in] buf : The new sample buffer.
+     * The buffer is queued for the backend thread without waiting for it to be pushed.
+     * The call blocks only when the data already queued exceeds the submission budget.
+     *
+     * @param[in] buf : The new sample buffer, ownership is transferred.
      *
      * @retval true on success.
      */
     bool notifyNewSample(GstBuffer *buf);
 
+    /**
+     * @brief Starts a flush. Wakes a blocked sample submission and drops the queued samples.
+     */
+    void startFlush();
+
+    /**
+     * @brief Stops a flush, so that new samples are accepted again.
+     */
+    void stopFlush();
+
     /**
      * @brief Notify push sample timer expiry.
      */
@@ -140,6 +221,58 @@ private:
      */
     void pushSamples();
 
+    /**
+     * @brief Queues the new sample and pushes it to the server. Called from the backend thread.
+     *
+     * @param[in] buf : The new sample buffer.
+     */
+    void handleNewSample(GstBuffer *buf);
+
+    /**
+     * @brief Returns the player to the pool when it has nothing left to play and has not reached EOS,
+     *        destroys it otherwise.
+     */
+    void closeWebAudioBackend();
+
+    /**
+     * @brief Requests the delayed play, if any. Called from the backend thread.
+     */
+    void playIfPending();
+
+    /**
+     * @brief Sets whether the server has been told to play. Called from the backend thread.
+     *
+     * @param[in] isPlaying : The new playing state.
+     */
+    void setPlaying(bool isPlaying);
+
+    /**
+     * @brief Caches the server buffer delay for the latency and position queries, the server is queried at most
+     *        once per kBufferDelayQueryInterval. Called from the backend thread.
+     */
+    void updateBufferDelay();
+
+    /**
+     * @brief Gets the cached buffer delay, less the frames played since it was cached. Called with m_delayMutex held.
+     *
+     * @param[in] now : The current time.
+     *
+     * @retval the estimated buffer delay in frames.
+     */
+    uint32_t getEstimatedDelayFrames(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Drops all of the queued sample buffers. Called from the backend thread.
+     */
+    void clearDataBuffers();
+
+    /**
+     * @brief Returns the bytes no longer held by the client to the submission budget.
+     *
+     * @param[in] bytes : The number of bytes consumed or dropped.
+     */
+    void releaseQueuedBytes(gsize bytes);
+
     /**
      * @brief Checks the config against that previously stored in the object.
      *
@@ -167,6 +300,31 @@ private:
      */
     std::queue<GstBuffer *> m_dataBuffers;
 
+    /**
+     * @brief Mutex protecting the submission budget.
+     */
+    std::mutex m_submitMutex;
+
+    /**
+     * @brief Signalled when queued bytes are released.
+     */
+    std::condition_variable m_submitCondVar;
+
+    /**
+     * @brief Bytes submitted by the sink and not yet written to the server.
+     */
+    gsize m_queuedBytes;
+
+    /**
+     * @brief Number of queued bytes above which the submission blocks, a default while the player is not open.
+     */
+    gsize m_maxQueuedBytes;
+
+    /**
+     * @brief Whether a flush is ongoing. Samples submitted during a flush are dropped.
+     */
+    bool m_isFlushing;
+
     /**
      * @brief The timer factory.
      */
@@ -193,9 +351,79 @@ private:
     bool m_supportDeferredPlay;
 
     /**
-     * @brief Whether the sink element has received EOS.
+     * @brief Whether the server has been told to play. Written with m_delayMutex held.
+     */
+    bool m_isPlaying;
+
+    /**
+     * @brief Whether all of the data written to the server has been played out.
+     */
+    std::atomic<bool> m_isDrained;
+
+    /**
+     * @brief Whether play has been requested but is waiting for the device to be primed.
+     */
+    bool m_isPlayPending;
+
+    /**
+     * @brief The number of frames written since the web audio player was opened.
+     */
+    uint64_t m_framesWritten;
+
+    /**
+     * @brief The time when the web audio player was opened.
      */
-    bool m_isEos;
+    std::chrono::steady_clock::time_point m_openTime;
+
+    /**
+     * @brief The volume requested by the sink.
+     */
+    double m_volume;
+
+    /**
+     * @brief Protects the values cached for the latency and position queries.
+     */
+    mutable std::mutex m_delayMutex;
+
+    /**
+     * @brief The number of frames written when the buffer delay was cached.
+     */
+    uint64_t m_cachedFramesWritten;
+
+    /**
+     * @brief The cached server buffer delay in frames.
+     */
+    uint32_t m_cachedDelayFrames;
+
+    /**
+     * @brief The time when the buffer delay was cached.
+     */
+    std::chrono::steady_clock::time_point m_delayTime;
+
+    /**
+     * @brief The time when the server buffer delay was last queried. Only used by the backend thread.
+     */
+    std::chrono::steady_clock::time_point m_bufferDelayQueryTime;
+
+    /**
+     * @brief The sample rate of the open player, zero when closed.
+     */
+    uint32_t m_cachedRate;
+
+    /**
+     * @brief The number of frames that can be queued locally.
+     */
+    uint32_t m_cachedMaxQueuedFrames;
+
+    /**
+     * @brief Whether the sink element has received EOS. Cleared by the rialto client thread at end of stream.
+     */
+    std::atomic<bool> m_isEos;
+
+    /**
+     * @brief Whether EOS has been set on or reported by the current player. Such a player is not returned to the pool.
+     */
+    std::atomic<bool> m_wasEosSet;
 
     /**
      * @brief The number of bytes in the frame.
@@ -216,4 +444,9 @@ private:
      * @brief The sink callbacks.
      */
     WebAudioSinkCallbacks m_callbacks;
+
+    /**
+     * @brief The data path statistics.
+     */
+    SinkStatistics m_statistics;
 };
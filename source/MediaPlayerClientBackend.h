@@ -49,52 +49,68 @@ public:
 
     bool isMediaPlayerBackendCreated() const override { return static_cast<bool>(m_mediaPlayerBackend); }
 
+    // The media pipeline is gone while the session is suspended, so the calls below fail instead
+    void destroyMediaPlayerBackend() override { m_mediaPlayerBackend.reset(); }
+
     bool attachSource(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> &source) override
     {
-        return m_mediaPlayerBackend->attachSource(source);
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->attachSource(source);
     }
 
-    bool removeSource(int32_t id) override { return m_mediaPlayerBackend->removeSource(id); }
+    bool removeSource(int32_t id) override { return m_mediaPlayerBackend && m_mediaPlayerBackend->removeSource(id); }
 
-    bool allSourcesAttached() override { return m_mediaPlayerBackend->allSourcesAttached(); }
+    bool allSourcesAttached() override { return m_mediaPlayerBackend && m_mediaPlayerBackend->allSourcesAttached(); }
 
     bool load(firebolt::rialto::MediaType type, const std::string &mimeType, const std::string &url) override
     {
-        return m_mediaPlayerBackend->load(type, mimeType, url);
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->load(type, mimeType, url);
     }
 
-    bool play() override { return m_mediaPlayerBackend->play(); }
-    bool pause() override { return m_mediaPlayerBackend->pause(); }
-    bool stop() override { return m_mediaPlayerBackend->stop(); }
+    bool play() override { return m_mediaPlayerBackend && m_mediaPlayerBackend->play(); }
+    bool pause() override { return m_mediaPlayerBackend && m_mediaPlayerBackend->pause(); }
+    bool stop() override { return m_mediaPlayerBackend && m_mediaPlayerBackend->stop(); }
     bool haveData(firebolt::rialto::MediaSourceStatus status, unsigned int needDataRequestId) override
     {
-        return m_mediaPlayerBackend->haveData(status, needDataRequestId);
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->haveData(status, needDataRequestId);
+    }
+    bool seek(int64_t seekPosition) override
+    {
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->setPosition(seekPosition);
+    }
+    bool setPlaybackRate(double rate) override
+    {
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->setPlaybackRate(rate);
     }
-    bool seek(int64_t seekPosition) override { return m_mediaPlayerBackend->setPosition(seekPosition); }
-    bool setPlaybackRate(double rate) override { return m_mediaPlayerBackend->setPlaybackRate(rate); }
     bool setVideoWindow(unsigned int x, unsigned int y, unsigned int width, unsigned int height) override
     {
-        return m_mediaPlayerBackend->setVideoWindow(x, y, width, height);
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->setVideoWindow(x, y, width, height);
     }
 
     firebolt::rialto::AddSegmentStatus
     addSegment(unsigned int needDataRequestId,
                const std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &mediaSegment) override
     {
+        if (!m_mediaPlayerBackend)
+        {
+            return firebolt::rialto::AddSegmentStatus::ERROR;
+        }
         return m_mediaPlayerBackend->addSegment(needDataRequestId, mediaSegment);
     }
 
-    bool getPosition(int64_t &position) override { return m_mediaPlayerBackend->getPosition(position); }
+    bool getPosition(int64_t &position) override
+    {
+        return m_mediaPlayerBackend && m_mediaPlayerBackend->getPosition(position);
+    }
 
-    bool renderFrame() override { return m_mediaPlayerBackend->renderFrame(); }
+    bool renderFrame() override { return m_mediaPlayerBackend && m_mediaPlayerBackend->renderFrame(); }
 
-    bool setVolume(double volume) override { return m_mediaPlayerBackend->setVolume(volume); }
+    bool setVolume(double volume) override { return m_mediaPlayerBackend && m_mediaPlayerBackend->setVolume(volume); }
 
-    bool getVolume(double &volume) override { return m_mediaPlayerBackend->getVolume(volume); }
+    bool getVolume(double &volume) override { return m_mediaPlayerBackend && m_mediaPlayerBackend->getVolume(volume); }
 
-    bool setMute(bool mute) override { return m_mediaPlayerBackend->setMute(mute); }
+    bool setMute(bool mute) override { return m_mediaPlayerBackend && m_mediaPlayerBackend->setMute(mute); }
 
-    bool getMute(bool &mute) override { return m_mediaPlayerBackend->getMute(mute); }
+    bool getMute(bool &mute) override { return m_mediaPlayerBackend && m_mediaPlayerBackend->getMute(mute); }
 
 private:
     std::unique_ptr<IMediaPipeline> m_mediaPlayerBackend;
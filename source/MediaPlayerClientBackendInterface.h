@@ -31,6 +31,7 @@ public:
     virtual void createMediaPlayerBackend(std::weak_ptr<IMediaPipelineClient> client, uint32_t maxWidth,
                                           uint32_t maxHeight) = 0;
     virtual bool isMediaPlayerBackendCreated() const = 0;
+    virtual void destroyMediaPlayerBackend() = 0;
     virtual bool attachSource(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> &source) = 0;
     virtual bool removeSource(int32_t id) = 0;
     virtual bool allSourcesAttached() = 0;
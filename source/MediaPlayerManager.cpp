@@ -19,9 +19,22 @@
 #include "MediaPlayerManager.h"
 #include "IMessageQueue.h"
 #include "MediaPlayerClientBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iterator>
+
+namespace
+{
+// Lingering sessions keep their server side resources, so only the most recent one is kept
+constexpr std::size_t kMaxLingeringClients{1};
+} // namespace
 
 std::mutex MediaPlayerManager::m_mediaPlayerClientsMutex;
 std::map<const GstObject *, MediaPlayerManager::MediaPlayerClientInfo> MediaPlayerManager::m_mediaPlayerClientsInfo;
+std::list<MediaPlayerManager::LingeringClientInfo> MediaPlayerManager::m_lingeringClients;
+std::unique_ptr<ITimer> MediaPlayerManager::m_lingerTimer;
+bool MediaPlayerManager::m_isExitHandlerRegistered{false};
 
 MediaPlayerManager::MediaPlayerManager() : m_currentGstBinParent(nullptr) {}
 
@@ -44,15 +57,32 @@ bool MediaPlayerManager::attachMediaPlayerClient(const GstObject *gstBinParent,
         createMediaPlayerClient(gstBinParent, maxVideoWidth, maxVideoHeight);
     }
 
-    if (!m_client.lock())
+    std::shared_ptr<GStreamerMSEMediaPlayerClient> client = m_client.lock();
+    if (!client)
     {
         GST_ERROR("Failed to attach the media player client");
         return false;
     }
-    else
+
+    // Join the backend creation, in case it was started by prewarmMediaPlayerClient
+    if (!client->waitForBackend())
     {
-        return true;
+        GST_ERROR("Failed to create the media player client backend");
+        releaseMediaPlayerClient();
+        return false;
     }
+    return true;
+}
+
+void MediaPlayerManager::prewarmMediaPlayerClient(const GstObject *gstBinParent, const uint32_t maxVideoWidth,
+                                                  const uint32_t maxVideoHeight)
+{
+    if (m_client.lock())
+    {
+        return;
+    }
+
+    createMediaPlayerClient(gstBinParent, maxVideoWidth, maxVideoHeight, true);
 }
 
 std::shared_ptr<GStreamerMSEMediaPlayerClient> MediaPlayerManager::getMediaPlayerClient()
@@ -62,79 +92,77 @@ std::shared_ptr<GStreamerMSEMediaPlayerClient> MediaPlayerManager::getMediaPlaye
 
 bool MediaPlayerManager::hasControl()
 {
-    if (m_client.lock())
+    if (!m_controlSlot)
     {
-        std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
-
-        auto it = m_mediaPlayerClientsInfo.find(m_currentGstBinParent);
-        if (it != m_mediaPlayerClientsInfo.end())
-        {
-            if (it->second.controller == this)
-            {
-                return true;
-            }
-            else
-            { // in case there's no controller anymore
-                return acquireControl(it->second);
-            }
-        }
-        else
-        {
-            GST_WARNING("Could not find the attached media player client");
-        }
+        GST_WARNING("No media player client attached");
+        return false;
     }
-    else
+
+    if (m_controlSlot->controller.load(std::memory_order_acquire) == this)
     {
-        GST_WARNING("No media player client attached");
+        return true;
     }
 
-    return false;
+    // in case there's no controller anymore
+    return acquireControl();
 }
 
 void MediaPlayerManager::releaseMediaPlayerClient()
 {
     if (m_client.lock())
     {
-        std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
-
-        auto it = m_mediaPlayerClientsInfo.find(m_currentGstBinParent);
-        if (it != m_mediaPlayerClientsInfo.end())
+        std::shared_ptr<GStreamerMSEMediaPlayerClient> releasedClient;
         {
+            std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
+
+            auto it = m_mediaPlayerClientsInfo.find(m_currentGstBinParent);
+            if (it == m_mediaPlayerClientsInfo.end())
+            {
+                GST_ERROR("Could not find the attached media player client");
+                return;
+            }
+
             it->second.refCount--;
             if (it->second.refCount == 0)
             {
-                it->second.client->stopStreaming();
-                it->second.client->destroyClientBackend();
+                releasedClient = it->second.client;
                 m_mediaPlayerClientsInfo.erase(it);
             }
             else
             {
-                if (it->second.controller == this)
-                    it->second.controller = nullptr;
+                const MediaPlayerManager *controller = this;
+                it->second.controlSlot->controller.compare_exchange_strong(controller, nullptr,
+                                                                           std::memory_order_acq_rel);
             }
             m_client.reset();
+            m_controlSlot.reset();
             m_currentGstBinParent = nullptr;
         }
-        else
+
+        // The client is not in the map anymore, so the server calls are made without blocking the other pipelines
+        if (releasedClient)
         {
-            GST_ERROR("Could not find the attached media player client");
+            const std::chrono::milliseconds lingerTime = getLingerTime();
+            if (lingerTime.count() > 0 && releasedClient->prepareForReuse())
+            {
+                lingerClient(releasedClient, lingerTime);
+            }
+            else
+            {
+                destroyClient(releasedClient);
+            }
         }
     }
 }
 
-bool MediaPlayerManager::acquireControl(MediaPlayerClientInfo &mediaPlayerClientInfo)
+bool MediaPlayerManager::acquireControl()
 {
-    if (mediaPlayerClientInfo.controller == nullptr)
-    {
-        mediaPlayerClientInfo.controller = this;
-        return true;
-    }
-
-    return false;
+    const MediaPlayerManager *controller = nullptr;
+    return m_controlSlot->controller.compare_exchange_strong(controller, this, std::memory_order_acq_rel);
 }
 
 void MediaPlayerManager::createMediaPlayerClient(const GstObject *gstBinParent, const uint32_t maxVideoWidth,
-                                                 const uint32_t maxVideoHeight)
+                                                 const uint32_t maxVideoHeight, const bool isAsync)
 {
     std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
 
@@ -143,28 +171,49 @@ void MediaPlayerManager::createMediaPlayerClient(const GstObject *gstBinParent,
     {
         it->second.refCount++;
         m_client = it->second.client;
+        m_controlSlot = it->second.controlSlot;
         m_currentGstBinParent = gstBinParent;
     }
     else
     {
-        std::shared_ptr<firebolt::rialto::client::MediaPlayerClientBackendInterface> clientBackend =
-            std::make_shared<firebolt::rialto::client::MediaPlayerClientBackend>();
-        std::shared_ptr<GStreamerMSEMediaPlayerClient> client =
-            std::make_shared<GStreamerMSEMediaPlayerClient>(IMessageQueueFactory::createFactory(), clientBackend,
-                                                            maxVideoWidth, maxVideoHeight);
+        std::shared_ptr<GStreamerMSEMediaPlayerClient> client = takeLingeringClient(maxVideoWidth, maxVideoHeight);
+        if (client)
+        {
+            GST_INFO("Reusing the lingering media player client");
+        }
+        else
+        {
+            std::shared_ptr<firebolt::rialto::client::MediaPlayerClientBackendInterface> clientBackend =
+                std::make_shared<firebolt::rialto::client::MediaPlayerClientBackend>();
+            client = std::make_shared<GStreamerMSEMediaPlayerClient>(IMessageQueueFactory::createFactory(),
+                                                                     clientBackend, maxVideoWidth, maxVideoHeight);
+        }
 
-        if (client->createBackend())
+        bool isCreated = true;
+        if (isAsync)
+        {
+            // The result is checked when the client is attached
+            client->createBackendAsync();
+        }
+        else
+        {
+            isCreated = client->createBackend();
+        }
+
+        if (isCreated)
         {
             // Store the new client in global map
             MediaPlayerClientInfo newClientInfo;
             newClientInfo.client = client;
-            newClientInfo.controller = this;
+            newClientInfo.controlSlot = std::make_shared<ControlSlot>();
+            newClientInfo.controlSlot->controller = this;
             newClientInfo.refCount = 1;
             m_mediaPlayerClientsInfo.insert(
                 std::pair<const GstObject *, MediaPlayerClientInfo>(gstBinParent, newClientInfo));
 
             // Store client info in object
             m_client = client;
+            m_controlSlot = newClientInfo.controlSlot;
             m_currentGstBinParent = gstBinParent;
         }
         else
@@ -174,3 +223,140 @@ void MediaPlayerManager::createMediaPlayerClient(const GstObject *gstBinParent,
         }
     }
 }
+
+std::chrono::milliseconds MediaPlayerManager::getLingerTime()
+{
+    const char *lingerTimeStr = getenv("RIALTO_CLIENT_LINGER_MS");
+    if (!lingerTimeStr)
+    {
+        return std::chrono::milliseconds{0};
+    }
+
+    char *end;
+    errno = 0;
+    unsigned long val = strtoul(lingerTimeStr, &end, 10);
+    if (*end != '\0' || errno == ERANGE)
+    {
+        GST_WARNING("Failed to parse 'RIALTO_CLIENT_LINGER_MS' env variable - '%s'", lingerTimeStr);
+        return std::chrono::milliseconds{0};
+    }
+    return std::chrono::milliseconds{val};
+}
+
+void MediaPlayerManager::lingerClient(const std::shared_ptr<GStreamerMSEMediaPlayerClient> &client,
+                                      const std::chrono::milliseconds &lingerTime)
+{
+    std::list<LingeringClientInfo> evictedClients;
+    std::unique_ptr<ITimer> cancelledTimer;
+    {
+        std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
+
+        while (m_lingeringClients.size() >= kMaxLingeringClients)
+        {
+            evictedClients.splice(evictedClients.end(), m_lingeringClients, m_lingeringClients.begin());
+        }
+        m_lingeringClients.push_back(LingeringClientInfo{client, std::chrono::steady_clock::now() + lingerTime});
+
+        // The timer cancels itself once there is nothing left to expire
+        if (!m_lingerTimer || !m_lingerTimer->isActive())
+        {
+            // Its callback may still be running, so it is joined once the lock is released
+            cancelledTimer = std::move(m_lingerTimer);
+            std::shared_ptr<ITimerFactory> timerFactory = ITimerFactory::getFactory();
+            if (timerFactory)
+            {
+                m_lingerTimer = timerFactory->createTimer(lingerTime, &MediaPlayerManager::destroyExpiredClients,
+                                                          TimerType::PERIODIC);
+            }
+        }
+
+        // The timer thread and the lingering sessions must not outlive the static objects they use
+        if (!m_isExitHandlerRegistered)
+        {
+            m_isExitHandlerRegistered = std::atexit(&MediaPlayerManager::destroyLingeringClients) == 0;
+        }
+    }
+
+    for (const auto &evictedClient : evictedClients)
+    {
+        destroyClient(evictedClient.client);
+    }
+}
+
+std::shared_ptr<GStreamerMSEMediaPlayerClient> MediaPlayerManager::takeLingeringClient(const uint32_t maxVideoWidth,
+                                                                                       const uint32_t maxVideoHeight)
+{
+    const uint32_t width = maxVideoWidth == 0 ? DEFAULT_MAX_VIDEO_WIDTH : maxVideoWidth;
+    const uint32_t height = maxVideoHeight == 0 ? DEFAULT_MAX_VIDEO_HEIGHT : maxVideoHeight;
+    const auto now = std::chrono::steady_clock::now();
+
+    auto it = std::find_if(m_lingeringClients.begin(), m_lingeringClients.end(),
+                           [&](const LingeringClientInfo &info)
+                           {
+                               return info.expiryTime > now && info.client->getMaxVideoWidth() == width &&
+                                      info.client->getMaxVideoHeight() == height;
+                           });
+    if (it == m_lingeringClients.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<GStreamerMSEMediaPlayerClient> client = it->client;
+    m_lingeringClients.erase(it);
+    return client;
+}
+
+void MediaPlayerManager::destroyExpiredClients()
+{
+    std::list<LingeringClientInfo> expiredClients;
+    {
+        std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = m_lingeringClients.begin(); it != m_lingeringClients.end();)
+        {
+            auto next = std::next(it);
+            if (it->expiryTime <= now)
+            {
+                expiredClients.splice(expiredClients.end(), m_lingeringClients, it);
+            }
+            it = next;
+        }
+
+        if (m_lingeringClients.empty() && m_lingerTimer)
+        {
+            m_lingerTimer->cancel();
+        }
+    }
+
+    for (const auto &expiredClient : expiredClients)
+    {
+        GST_INFO("Destroying the lingering media player client");
+        destroyClient(expiredClient.client);
+    }
+}
+
+void MediaPlayerManager::destroyLingeringClients()
+{
+    std::unique_ptr<ITimer> lingerTimer;
+    std::list<LingeringClientInfo> lingeringClients;
+    {
+        std::lock_guard<std::mutex> guard(m_mediaPlayerClientsMutex);
+        lingerTimer = std::move(m_lingerTimer);
+        lingeringClients.swap(m_lingeringClients);
+    }
+
+    // Joins a callback in progress, which finds no timer to cancel
+    lingerTimer.reset();
+    for (const auto &lingeringClient : lingeringClients)
+    {
+        GST_INFO("Destroying the lingering media player client on exit");
+        destroyClient(lingeringClient.client);
+    }
+}
+
+void MediaPlayerManager::destroyClient(const std::shared_ptr<GStreamerMSEMediaPlayerClient> &client)
+{
+    client->stopStreaming();
+    client->destroyClientBackend();
+}
@@ -20,7 +20,12 @@
 #define MEDIAPLAYERMANAGER_H
 
 #include "GStreamerMSEMediaPlayerClient.h"
+#include "ITimer.h"
+#include <atomic>
+#include <chrono>
+#include <list>
 #include <map>
+#include <memory>
 
 class MediaPlayerManager
 {
@@ -31,26 +36,61 @@ public:
     std::shared_ptr<GStreamerMSEMediaPlayerClient> getMediaPlayerClient();
     bool attachMediaPlayerClient(const GstObject *gstBinParent, const uint32_t maxVideoWidth = 0,
                                  const uint32_t maxVideoHeight = 0);
+    void prewarmMediaPlayerClient(const GstObject *gstBinParent, const uint32_t maxVideoWidth = 0,
+                                  const uint32_t maxVideoHeight = 0);
     void releaseMediaPlayerClient();
     bool hasControl();
 
 private:
+    /**
+     * @brief The controller of a shared media player client.
+     *
+     * Shared by all of the managers attached to the client, so that the control can be checked and
+     * taken without locking the global map.
+     */
+    struct ControlSlot
+    {
+        std::atomic<const MediaPlayerManager *> controller{nullptr};
+    };
+
     struct MediaPlayerClientInfo
     {
         std::shared_ptr<GStreamerMSEMediaPlayerClient> client;
-        void *controller;
+        std::shared_ptr<ControlSlot> controlSlot;
         uint32_t refCount;
     };
 
+    /**
+     * @brief A released client kept alive for the next pipeline, see RIALTO_CLIENT_LINGER_MS.
+     */
+    struct LingeringClientInfo
+    {
+        std::shared_ptr<GStreamerMSEMediaPlayerClient> client;
+        std::chrono::steady_clock::time_point expiryTime;
+    };
+
     void createMediaPlayerClient(const GstObject *gstBinParent, const uint32_t maxVideoWidth,
-                                 const uint32_t maxVideoHeight);
-    bool acquireControl(MediaPlayerClientInfo &mediaPlayerClientInfo);
+                                 const uint32_t maxVideoHeight, const bool isAsync = false);
+    bool acquireControl();
+
+    static std::chrono::milliseconds getLingerTime();
+    static void lingerClient(const std::shared_ptr<GStreamerMSEMediaPlayerClient> &client,
+                             const std::chrono::milliseconds &lingerTime);
+    static std::shared_ptr<GStreamerMSEMediaPlayerClient> takeLingeringClient(const uint32_t maxVideoWidth,
+                                                                              const uint32_t maxVideoHeight);
+    static void destroyExpiredClients();
+    static void destroyLingeringClients();
+    static void destroyClient(const std::shared_ptr<GStreamerMSEMediaPlayerClient> &client);
 
     std::weak_ptr<GStreamerMSEMediaPlayerClient> m_client;
+    std::shared_ptr<ControlSlot> m_controlSlot;
     const GstObject *m_currentGstBinParent;
 
     static std::mutex m_mediaPlayerClientsMutex;
     static std::map<const GstObject *, MediaPlayerClientInfo> m_mediaPlayerClientsInfo;
+    static std::list<LingeringClientInfo> m_lingeringClients;
+    static std::unique_ptr<ITimer> m_lingerTimer;
+    static bool m_isExitHandlerRegistered;
 };
 
 #endif // MEDIAPLAYERMANAGER_H
\ No newline at end of file
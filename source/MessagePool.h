@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Recycles the messages of one type, so that posting them does not allocate once the pool is warm.
+ *
+ * A message is reused when the pool holds the only reference to it, that is once the queue has handled or skipped it.
+ * The pool grows to the number of messages in flight at the same time.
+ */
+template <typename T> class MessagePool
+{
+public:
+    /**
+     * @brief Gets a message constructed from the arguments, reusing a released one if there is one.
+     */
+    template <typename... Args> std::shared_ptr<T> acquire(Args &&...args)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const std::shared_ptr<T> &message : m_messages)
+        {
+            if (message.use_count() == 1)
+            {
+                // Pairs with the release of the last reference by the queue, its use of the message happened before
+                std::atomic_thread_fence(std::memory_order_acquire);
+                *message = T(std::forward<Args>(args)...);
+                return message;
+            }
+        }
+        m_messages.push_back(std::make_shared<T>(std::forward<Args>(args)...));
+        return m_messages.back();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<T>> m_messages;
+};
@@ -87,8 +87,8 @@ std::shared_ptr<Message> MessageQueue::waitForMessage()
     {
         m_condVar.wait(lock);
     }
-    std::shared_ptr<Message> message = m_queue.front();
-    m_queue.pop_front();
+    std::shared_ptr<Message> message = std::move(m_queue.front());
+    m_queue.pop();
     return message;
 }
 
@@ -100,7 +100,7 @@ bool MessageQueue::postMessage(const std::shared_ptr<Message> &msg)
         GST_ERROR("Message queue is not running");
         return false;
     }
-    m_queue.push_back(msg);
+    m_queue.push(msg);
     m_condVar.notify_all();
 
     return true;
@@ -155,6 +155,6 @@ void MessageQueue::doClear()
     while (!m_queue.empty())
     {
         m_queue.front()->skip();
-        m_queue.pop_front();
+        m_queue.pop();
     }
 }
@@ -19,8 +19,8 @@
 #pragma once
 
 #include "IMessageQueue.h"
+#include "RingQueue.h"
 #include <condition_variable>
-#include <deque>
 #include <functional>
 #include <gst/gst.h>
 #include <memory>
@@ -71,7 +71,7 @@ protected:
 protected:
     std::condition_variable m_condVar;
     std::mutex m_mutex;
-    std::deque<std::shared_ptr<Message>> m_queue;
+    RingQueue<std::shared_ptr<Message>> m_queue;
     std::thread m_workerThread;
     bool m_running;
 };
@@ -20,7 +20,7 @@
 #include "GStreamerEMEUtils.h"
 #include "GStreamerMSEUtils.h"
 #include "RialtoGStreamerMSEBaseSinkPrivate.h"
-#include <IMediaPipelineCapabilities.h>
+#include "SupportedMimeTypesCache.h"
 #include <gst/audio/audio.h>
 #include <gst/gst.h>
 #include <gst/pbutils/pbutils.h>
@@ -110,6 +110,14 @@ static GstStateChangeReturn rialto_mse_audio_sink_change_state(GstElement *eleme
         return result;
     }
 
+    if (GST_STATE_CHANGE_NULL_TO_READY == transition)
+    {
+        // Rialto is running now, so start creating the media player session while the rest of the pipeline
+        // is set up. It is joined when the media player client is attached.
+        GstObject *parentObject = rialto_mse_base_get_oldest_gst_bin_parent(element);
+        priv->m_mediaPlayerManager.prewarmMediaPlayerClient(parentObject);
+    }
+
     return result;
 }
 
@@ -382,13 +390,10 @@ static void rialto_mse_audio_sink_class_init(RialtoMSEAudioSinkClass *klass)
                                     g_param_spec_boolean("mute", "Mute", "Mute status of this stream", FALSE,
                                                          GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
-    std::unique_ptr<firebolt::rialto::IMediaPipelineCapabilities> mediaPlayerCapabilities =
-        firebolt::rialto::IMediaPipelineCapabilitiesFactory::createFactory()->createMediaPipelineCapabilities();
-    if (mediaPlayerCapabilities)
+    std::vector<std::string> supportedMimeTypes;
+    if (SupportedMimeTypesCache::instance().getSupportedMimeTypes(firebolt::rialto::MediaSourceType::AUDIO,
+                                                                  supportedMimeTypes))
     {
-        std::vector<std::string> supportedMimeTypes =
-            mediaPlayerCapabilities->getSupportedMimeTypes(firebolt::rialto::MediaSourceType::AUDIO);
-
         rialto_mse_sink_setup_supported_caps(elementClass, supportedMimeTypes);
     }
     else
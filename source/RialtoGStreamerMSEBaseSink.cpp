@@ -20,11 +20,17 @@
 
 #include "RialtoGStreamerMSEBaseSink.h"
 #include "ControlBackend.h"
+#include "GStreamerMSEUtils.h"
 #include "GStreamerUtils.h"
 #include "RialtoGStreamerMSEBaseSinkPrivate.h"
+#include "SupportedMimeTypesCache.h"
+#include "Tracing.h"
 #include <IMediaPipeline.h>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <gst/gst.h>
+#include <unistd.h>
 
 GST_DEBUG_CATEGORY_STATIC(RialtoMSEBaseSinkDebug);
 #define GST_CAT_DEFAULT RialtoMSEBaseSinkDebug
@@ -50,12 +56,16 @@ enum
     PROP_IS_SINGLE_PATH_STREAM,
     PROP_N_STREAMS,
     PROP_HAS_DRM,
+    PROP_STATS,
+    PROP_QUEUE_HIGH_WATERMARK,
+    PROP_QUEUE_LOW_WATERMARK,
     PROP_LAST
 };
 
 enum
 {
     SIGNAL_UNDERFLOW,
+    SIGNAL_DUMP_FLIGHT_RECORDER,
     SIGNAL_LAST
 };
 
@@ -81,8 +91,31 @@ static void rialto_mse_base_async_done(RialtoMSEBaseSink *sink)
                              gst_message_new_async_done(GST_OBJECT_CAST(sink), GST_CLOCK_TIME_NONE));
 }
 
+static gchar *rialto_mse_base_sink_dump_flight_recorder(RialtoMSEBaseSink *sink)
+{
+    const std::string kDir{rialto_mse_sink_get_flight_recorder_dir()};
+    if (kDir.empty())
+    {
+        return nullptr;
+    }
+
+    gchar *name = gst_object_get_name(GST_OBJECT_CAST(sink));
+    gchar *filePath = g_strdup_printf("%s/rialto-flight-recorder-%d-%s.bin", kDir.c_str(), static_cast<int>(getpid()),
+                                      name ? name : "sink");
+    g_free(name);
+    if (!sink->priv->m_flightRecorder.dump(filePath))
+    {
+        g_free(filePath);
+        return nullptr;
+    }
+
+    GST_WARNING_OBJECT(sink, "Flight recorder dumped to %s", filePath);
+    return filePath;
+}
+
 static void rialto_mse_base_sink_eos_handler(RialtoMSEBaseSink *sink)
 {
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::EOS);
     GstState currentState = GST_STATE(sink);
     if ((currentState != GST_STATE_PAUSED) && (currentState != GST_STATE_PLAYING))
     {
@@ -103,8 +136,20 @@ static void rialto_mse_base_sink_eos_handler(RialtoMSEBaseSink *sink)
 
 static void rialto_mse_base_sink_error_handler(RialtoMSEBaseSink *sink, const char *message)
 {
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::ERROR);
+
+    // The path of the dump goes with the error, for the application to collect it
+    GstStructure *details = nullptr;
+    gchar *flightRecorderFile = rialto_mse_base_sink_dump_flight_recorder(sink);
+    if (flightRecorderFile)
+    {
+        details = gst_structure_new("rialto-flight-recorder", "file", G_TYPE_STRING, flightRecorderFile, nullptr);
+        g_free(flightRecorderFile);
+    }
+
     GError *gError{g_error_new_literal(GST_STREAM_ERROR, 0, message)};
-    gst_element_post_message(GST_ELEMENT_CAST(sink), gst_message_new_error(GST_OBJECT_CAST(sink), gError, message));
+    gst_element_post_message(GST_ELEMENT_CAST(sink),
+                             gst_message_new_error_with_details(GST_OBJECT_CAST(sink), gError, message, details));
     g_error_free(gError);
 }
 
@@ -119,6 +164,7 @@ static void rialto_mse_base_sink_rialto_state_changed_handler(RialtoMSEBaseSink
     GstState next = GST_STATE_NEXT(sink);
     GstState pending = GST_STATE_PENDING(sink);
     GstState postNext = next == pending ? GST_STATE_VOID_PENDING : pending;
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::SERVER_STATE, static_cast<int64_t>(state));
 
     GST_DEBUG_OBJECT(sink,
                      "Received server's state change to %u. Sink's states are: current state: %s next state: %s "
@@ -151,6 +197,28 @@ static void rialto_mse_base_sink_seek_completed_handler(RialtoMSEBaseSink *sink)
     sink->priv->m_seekCondVariable.notify_all();
 }
 
+static void rialto_mse_base_sink_application_state_changed_handler(RialtoMSEBaseSink *sink,
+                                                                   firebolt::rialto::ApplicationState state)
+{
+    std::shared_ptr<GStreamerMSEMediaPlayerClient> client = sink->priv->m_mediaPlayerManager.getMediaPlayerClient();
+    if (!client)
+    {
+        return;
+    }
+
+    // Every sink of the pipeline gets the notification, the client handles it once
+    if (state == firebolt::rialto::ApplicationState::INACTIVE)
+    {
+        GST_INFO_OBJECT(sink, "Application is inactive, suspending the media player client");
+        client->suspend();
+    }
+    else if (state == firebolt::rialto::ApplicationState::RUNNING)
+    {
+        GST_INFO_OBJECT(sink, "Application is running, resuming the media player client");
+        client->resume();
+    }
+}
+
 static void rialto_mse_base_sink_init(RialtoMSEBaseSink *sink)
 {
     GST_INFO_OBJECT(sink, "Init: %" GST_PTR_FORMAT, sink);
@@ -158,6 +226,12 @@ static void rialto_mse_base_sink_init(RialtoMSEBaseSink *sink)
     new (sink->priv) RialtoMSEBaseSinkPrivate();
 
     sink->priv->m_rialtoControlClient = std::make_unique<firebolt::rialto::client::ControlBackend>();
+    sink->priv->m_retainLimitBytes = rialto_mse_sink_get_suspend_retain_bytes();
+    if (sink->priv->m_retainLimitBytes > 0)
+    {
+        sink->priv->m_rialtoControlClient->setApplicationStateCallback(
+            std::bind(rialto_mse_base_sink_application_state_changed_handler, sink, std::placeholders::_1));
+    }
 
     RialtoGStreamerMSEBaseSinkCallbacks callbacks;
     callbacks.eosCallback = std::bind(rialto_mse_base_sink_eos_handler, sink);
@@ -202,6 +276,33 @@ static void rialto_mse_base_sink_get_property(GObject *object, guint propId, GVa
     case PROP_HAS_DRM:
         g_value_set_boolean(value, sink->priv->m_hasDrm);
         break;
+    case PROP_STATS:
+    {
+        GstClockTime queuedTime = 0;
+        if (!sink->priv->m_samples.empty())
+        {
+            GstBuffer *front = sink->priv->m_samples.front().buffer;
+            GstBuffer *back = sink->priv->m_samples.back().buffer;
+            if (GST_BUFFER_PTS_IS_VALID(front) && GST_BUFFER_PTS_IS_VALID(back) &&
+                GST_BUFFER_PTS(back) >= GST_BUFFER_PTS(front))
+            {
+                queuedTime = GST_BUFFER_PTS(back) - GST_BUFFER_PTS(front);
+                if (GST_BUFFER_DURATION_IS_VALID(back))
+                {
+                    queuedTime += GST_BUFFER_DURATION(back);
+                }
+            }
+        }
+        g_value_take_boxed(value, sink->priv->m_statistics.createStructure(sink->priv->m_samples.size(),
+                                                                           sink->priv->m_queuedBytes, queuedTime));
+        break;
+    }
+    case PROP_QUEUE_HIGH_WATERMARK:
+        g_value_set_uint(value, static_cast<guint>(sink->priv->m_queueHighWatermark));
+        break;
+    case PROP_QUEUE_LOW_WATERMARK:
+        g_value_set_uint(value, static_cast<guint>(sink->priv->m_queueLowWatermark));
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
         break;
@@ -230,6 +331,14 @@ static void rialto_mse_base_sink_set_property(GObject *object, guint propId, con
     case PROP_HAS_DRM:
         sink->priv->m_hasDrm = g_value_get_boolean(value) != FALSE;
         break;
+    case PROP_QUEUE_HIGH_WATERMARK:
+        sink->priv->m_queueHighWatermark = g_value_get_uint(value);
+        // A blocked chain function rechecks the queue against the new mark
+        sink->priv->m_needDataCondVariable.notify_all();
+        break;
+    case PROP_QUEUE_LOW_WATERMARK:
+        sink->priv->m_queueLowWatermark = g_value_get_uint(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
         break;
@@ -303,6 +412,7 @@ static void rialto_mse_base_sink_change_playback_rate(RialtoMSEBaseSink *sink, G
 static void rialto_mse_base_sink_flush_start(RialtoMSEBaseSink *sink)
 {
     std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::FLUSH, 1);
     if (!sink->priv->m_isFlushOngoing)
     {
         GST_INFO_OBJECT(sink, "Starting flushing");
@@ -316,6 +426,7 @@ static void rialto_mse_base_sink_flush_stop(RialtoMSEBaseSink *sink, bool resetT
 {
     GST_INFO_OBJECT(sink, "Stopping flushing");
     std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::FLUSH, 0);
     sink->priv->m_isFlushOngoing = false;
 
     if (resetTime)
@@ -334,6 +445,7 @@ static void rialto_mse_base_sink_seek(RialtoMSEBaseSink *sink)
         return;
     }
 
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::SEEK, sink->priv->m_lastSegment.start);
     client->notifySourceStartedSeeking(sink->priv->m_sourceId);
 
     if (sink->priv->m_mediaPlayerManager.hasControl())
@@ -440,6 +552,7 @@ static gboolean rialto_mse_base_sink_send_event(GstElement *element, GstEvent *e
                     std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
                     gst_segment_init(&sink->priv->m_lastSegment, GST_FORMAT_TIME);
                     sink->priv->m_lastSegment.start = seekPosition;
+                    sink->priv->m_sampleTables.setSegment(sink->priv->m_lastSegment);
                 }
             }
         }
@@ -471,6 +584,7 @@ static GstStateChangeReturn rialto_mse_base_sink_change_state(GstElement *elemen
     GstState next_state = GST_STATE_TRANSITION_NEXT(transition);
     GST_INFO_OBJECT(sink, "State change: (%s) -> (%s)", gst_element_state_get_name(current_state),
                     gst_element_state_get_name(next_state));
+    priv->m_flightRecorder.record(FlightRecorderEvent::STATE_CHANGE, transition);
 
     GstStateChangeReturn status = GST_STATE_CHANGE_SUCCESS;
     std::shared_ptr<GStreamerMSEMediaPlayerClient> client = sink->priv->m_mediaPlayerManager.getMediaPlayerClient();
@@ -489,6 +603,7 @@ static GstStateChangeReturn rialto_mse_base_sink_change_state(GstElement *elemen
             return GST_STATE_CHANGE_FAILURE;
         }
         GST_INFO_OBJECT(sink, "Control: Rialto client reached running state");
+        SupportedMimeTypesCache::instance().refreshInBackground();
         break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
     {
@@ -556,7 +671,8 @@ static GstStateChangeReturn rialto_mse_base_sink_change_state(GstElement *elemen
         }
         break;
     case GST_STATE_CHANGE_READY_TO_NULL:
-        if (priv->m_mediaPlayerManager.hasControl())
+        // The client may have been prewarmed without being attached, so make sure its backend exists
+        if (priv->m_mediaPlayerManager.hasControl() && client->waitForBackend())
         {
             client->stop();
         }
@@ -600,6 +716,12 @@ static void rialto_mse_base_sink_class_init(RialtoMSEBaseSinkClass *klass)
                                                (GSignalFlags)(G_SIGNAL_RUN_LAST), 0, nullptr, nullptr,
                                                g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+    g_signals[SIGNAL_DUMP_FLIGHT_RECORDER] =
+        g_signal_new_class_handler("dump-flight-recorder", G_TYPE_FROM_CLASS(klass),
+                                   (GSignalFlags)(G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION),
+                                   G_CALLBACK(rialto_mse_base_sink_dump_flight_recorder), nullptr, nullptr, nullptr,
+                                   G_TYPE_STRING, 0);
+
     g_object_class_install_property(gobjectClass, PROP_LOCATION,
                                     g_param_spec_string("location", "location", "Location to read from", nullptr,
                                                         GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
@@ -620,20 +742,46 @@ static void rialto_mse_base_sink_class_init(RialtoMSEBaseSinkClass *klass)
     g_object_class_install_property(gobjectClass, PROP_HAS_DRM,
                                     g_param_spec_boolean("has-drm", "has drm", "has drm", TRUE,
                                                          GParamFlags(G_PARAM_READWRITE)));
+
+    g_object_class_install_property(gobjectClass, PROP_STATS,
+                                    g_param_spec_boxed("stats", "Statistics", "Statistics of the data path",
+                                                       GST_TYPE_STRUCTURE,
+                                                       GParamFlags(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobjectClass, PROP_QUEUE_HIGH_WATERMARK,
+                                    g_param_spec_uint("queue-high-watermark", "Queue high watermark",
+                                                      "Number of queued samples at which the chain function blocks", 1,
+                                                      G_MAXUINT, RialtoMSEBaseSinkPrivate::kDefaultQueueHighWatermark,
+                                                      GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobjectClass, PROP_QUEUE_LOW_WATERMARK,
+                                    g_param_spec_uint("queue-low-watermark", "Queue low watermark",
+                                                      "Number of queued samples at which a blocked chain function is "
+                                                      "woken, capped below the high watermark",
+                                                      0, G_MAXUINT, RialtoMSEBaseSinkPrivate::kDefaultQueueLowWatermark,
+                                                      GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 }
 
 GstFlowReturn rialto_mse_base_sink_chain(GstPad *pad, GstObject *parent, GstBuffer *buf)
 {
-    size_t MAX_INTERNAL_BUFFERS_QUEUE_SIZE = 24;
     RialtoMSEBaseSink *sink = RIALTO_MSE_BASE_SINK(parent);
     GST_LOG_OBJECT(sink, "Handling buffer %p with PTS %" GST_TIME_FORMAT, buf, GST_TIME_ARGS(GST_BUFFER_PTS(buf)));
 
     std::unique_lock<std::mutex> lock(sink->priv->m_sinkMutex);
 
-    if (sink->priv->m_samples.size() >= MAX_INTERNAL_BUFFERS_QUEUE_SIZE)
+    if (sink->priv->m_samples.size() >= sink->priv->m_queueHighWatermark)
     {
         GST_DEBUG_OBJECT(sink, "Waiting for more space in buffers queue\n");
-        sink->priv->m_needDataCondVariable.wait(lock);
+        const auto kWaitStart = std::chrono::steady_clock::now();
+        auto canQueue = [sink]()
+        { return sink->priv->m_samples.size() < sink->priv->m_queueHighWatermark || sink->priv->m_isFlushOngoing; };
+        sink->priv->m_isChainWaiting = true;
+        sink->priv->m_needDataCondVariable.wait(lock, canQueue);
+        sink->priv->m_isChainWaiting = false;
+        const auto kWaitEnd = std::chrono::steady_clock::now();
+        sink->priv->m_statistics.recordChainBlocked(
+            std::chrono::duration_cast<std::chrono::microseconds>(kWaitEnd - kWaitStart));
+        Tracer::instance().complete("ChainBlocked", kWaitStart, kWaitEnd, {{"sourceId", sink->priv->m_sourceId}});
     }
 
     if (sink->priv->m_isFlushOngoing)
@@ -643,13 +791,11 @@ GstFlowReturn rialto_mse_base_sink_chain(GstPad *pad, GstObject *parent, GstBuff
         return GST_FLOW_FLUSHING;
     }
 
-    GstSample *sample = gst_sample_new(buf, sink->priv->m_caps, &sink->priv->m_lastSegment, nullptr);
-    if (sample)
-        sink->priv->m_samples.push(sample);
-    else
-        GST_ERROR_OBJECT(sink, "Failed to create a sample");
-
-    gst_buffer_unref(buf);
+    // The record takes the reference of the buffer, the caps and segment are shared through their generations
+    sink->priv->m_samples.push(sink->priv->m_sampleTables.createRecord(buf));
+    sink->priv->m_queuedBytes += gst_buffer_get_size(buf);
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::QUEUE_LEVEL, sink->priv->m_samples.size(),
+                                        sink->priv->m_queuedBytes);
 
     return GST_FLOW_OK;
 }
@@ -687,6 +833,7 @@ bool rialto_mse_base_sink_event(GstPad *pad, GstObject *parent, GstEvent *event)
     {
         std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
         gst_event_copy_segment(event, &sink->priv->m_lastSegment);
+        sink->priv->m_sampleTables.setSegment(sink->priv->m_lastSegment);
         break;
     }
     case GST_EVENT_EOS:
@@ -701,17 +848,10 @@ bool rialto_mse_base_sink_event(GstPad *pad, GstObject *parent, GstEvent *event)
         gst_event_parse_caps(event, &caps);
         {
             std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
-            if (sink->priv->m_caps)
-            {
-                if (!gst_caps_is_equal(caps, sink->priv->m_caps))
-                {
-                    gst_caps_unref(sink->priv->m_caps);
-                    sink->priv->m_caps = gst_caps_copy(caps);
-                }
-            }
-            else
+            GstCaps *currentCaps = sink->priv->m_sampleTables.getCurrentCaps();
+            if (!currentCaps || !gst_caps_is_equal(caps, currentCaps))
             {
-                sink->priv->m_caps = gst_caps_copy(caps);
+                sink->priv->m_sampleTables.setCaps(gst_caps_copy(caps));
             }
         }
         break;
@@ -761,31 +901,134 @@ bool rialto_mse_base_sink_event(GstPad *pad, GstObject *parent, GstEvent *event)
     return TRUE;
 }
 
-GstSample *rialto_mse_base_sink_get_front_sample(RialtoMSEBaseSink *sink)
+bool rialto_mse_base_sink_get_front_sample(RialtoMSEBaseSink *sink, GstBuffer **buffer, GstCaps **caps)
 {
     std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
     if (!sink->priv->m_samples.empty())
     {
-        GstSample *sample = sink->priv->m_samples.front();
-        GstBuffer *buffer = gst_sample_get_buffer(sample);
-        GST_LOG_OBJECT(sink, "Pulling buffer %p with PTS %" GST_TIME_FORMAT, buffer,
-                       GST_TIME_ARGS(GST_BUFFER_PTS(buffer)));
+        const SampleRecord &record = sink->priv->m_samples.front();
+        GST_LOG_OBJECT(sink, "Pulling buffer %p with PTS %" GST_TIME_FORMAT, record.buffer,
+                       GST_TIME_ARGS(record.buffer ? GST_BUFFER_PTS(record.buffer) : GST_CLOCK_TIME_NONE));
 
-        return sample;
+        *buffer = record.buffer;
+        *caps = sink->priv->m_sampleTables.getCaps(record);
+        return true;
     }
 
-    return nullptr;
+    return false;
+}
+
+static void rialto_mse_base_sink_retain_sample_unlocked(RialtoMSEBaseSinkPrivate *priv, const SampleRecord &record)
+{
+    if (priv->m_retainedSamples.empty() && GST_BUFFER_FLAG_IS_SET(record.buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    {
+        // Resuming has to start from a key frame
+        RialtoMSEBaseSinkPrivate::releaseRecord(record);
+        return;
+    }
+
+    priv->m_retainedSamples.push(record);
+    priv->m_retainedBytes += gst_buffer_get_size(record.buffer);
+
+    auto dropFront = [priv]()
+    {
+        const SampleRecord front = priv->m_retainedSamples.front();
+        priv->m_retainedBytes -= gst_buffer_get_size(front.buffer);
+        priv->m_retainedSamples.pop();
+        RialtoMSEBaseSinkPrivate::releaseRecord(front);
+    };
+
+    // Compact by dropping whole groups of pictures, so that the queue still starts with a key frame
+    while (priv->m_retainedBytes > priv->m_retainLimitBytes && !priv->m_retainedSamples.empty())
+    {
+        dropFront();
+        while (!priv->m_retainedSamples.empty() &&
+               GST_BUFFER_FLAG_IS_SET(priv->m_retainedSamples.front().buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+        {
+            dropFront();
+        }
+    }
 }
 
 void rialto_mse_base_sink_pop_sample(RialtoMSEBaseSink *sink)
 {
     std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
-    sink->priv->m_needDataCondVariable.notify_all();
     if (!sink->priv->m_samples.empty())
     {
-        gst_sample_unref(sink->priv->m_samples.front());
+        const SampleRecord record = sink->priv->m_samples.front();
+        sink->priv->m_samples.pop();
+        const size_t kSampleBytes = record.buffer ? gst_buffer_get_size(record.buffer) : 0;
+        sink->priv->m_queuedBytes -= std::min(kSampleBytes, sink->priv->m_queuedBytes);
+        if (sink->priv->m_retainLimitBytes > 0 && record.buffer)
+        {
+            rialto_mse_base_sink_retain_sample_unlocked(sink->priv, record);
+        }
+        else
+        {
+            RialtoMSEBaseSinkPrivate::releaseRecord(record);
+        }
+        sink->priv->releaseUnusedGenerationsUnlocked();
+    }
+
+    // Waking the chain function for every sample would switch threads at the frame rate while the queue is full
+    if (sink->priv->m_isChainWaiting && sink->priv->m_samples.size() <= sink->priv->getQueueLowWatermarkUnlocked())
+    {
+        sink->priv->m_needDataCondVariable.notify_all();
+    }
+}
+
+GstClockTime rialto_mse_base_sink_restore_retained_samples(RialtoMSEBaseSink *sink, int64_t position)
+{
+    std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
+    RingQueue<SampleRecord> &retainedSamples = sink->priv->m_retainedSamples;
+    const GstClockTime kPosition = static_cast<GstClockTime>(std::max<int64_t>(position, 0));
+
+    // Start from the last key frame before the position, the server drops the frames before the position
+    size_t start = 0;
+    for (size_t i = 0; i < retainedSamples.size(); ++i)
+    {
+        GstBuffer *buffer = retainedSamples[i].buffer;
+        if (GST_BUFFER_PTS_IS_VALID(buffer) && GST_BUFFER_PTS(buffer) > kPosition)
+        {
+            break;
+        }
+        if (!GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+        {
+            start = i;
+        }
+    }
+
+    GstClockTime firstPts = GST_CLOCK_TIME_NONE;
+    RingQueue<SampleRecord> samples;
+    samples.reserve(retainedSamples.size() + sink->priv->m_samples.size());
+    for (size_t i = 0; !retainedSamples.empty(); ++i)
+    {
+        const SampleRecord record = retainedSamples.front();
+        retainedSamples.pop();
+        if (i < start)
+        {
+            RialtoMSEBaseSinkPrivate::releaseRecord(record);
+            continue;
+        }
+        if (i == start)
+        {
+            firstPts = GST_BUFFER_PTS(record.buffer);
+        }
+        sink->priv->m_queuedBytes += gst_buffer_get_size(record.buffer);
+        samples.push(record);
+    }
+    sink->priv->m_retainedBytes = 0;
+
+    GST_INFO_OBJECT(sink, "Restored %zu samples from %" GST_TIME_FORMAT, samples.size(), GST_TIME_ARGS(firstPts));
+    while (!sink->priv->m_samples.empty())
+    {
+        samples.push(sink->priv->m_samples.front());
         sink->priv->m_samples.pop();
     }
+    sink->priv->m_samples.swap(samples);
+    sink->priv->releaseUnusedGenerationsUnlocked();
+
+    return firstPts;
 }
 
 bool rialto_mse_base_sink_is_eos(RialtoMSEBaseSink *sink)
@@ -837,6 +1080,9 @@ void rialto_mse_base_handle_rialto_server_error(RialtoMSEBaseSink *sink)
 void rialto_mse_base_handle_rialto_server_sent_buffer_underflow(RialtoMSEBaseSink *sink)
 {
     GST_WARNING_OBJECT(sink, "Sending underflow signal");
+    sink->priv->m_statistics.recordUnderflow();
+    sink->priv->m_flightRecorder.record(FlightRecorderEvent::UNDERFLOW);
+    g_free(rialto_mse_base_sink_dump_flight_recorder(sink));
     g_signal_emit(G_OBJECT(sink), g_signals[SIGNAL_UNDERFLOW], 0);
 }
 
@@ -55,8 +55,11 @@ class MediaPlayerBackend;
 
 GType rialto_mse_base_sink_get_type(void);
 
-GstSample *rialto_mse_base_sink_get_front_sample(RialtoMSEBaseSink *sink);
+// Gets the first queued buffer and the caps it was received with, both valid until the sample is popped
+bool rialto_mse_base_sink_get_front_sample(RialtoMSEBaseSink *sink, GstBuffer **buffer, GstCaps **caps);
 void rialto_mse_base_sink_pop_sample(RialtoMSEBaseSink *sink);
+// Puts the retained samples back in front of the queue, returns the timestamp of the first one
+GstClockTime rialto_mse_base_sink_restore_retained_samples(RialtoMSEBaseSink *sink, int64_t position);
 bool rialto_mse_base_sink_is_eos(RialtoMSEBaseSink *sink);
 
 void rialto_mse_base_handle_rialto_server_state_changed(RialtoMSEBaseSink *sink, firebolt::rialto::PlaybackState state);
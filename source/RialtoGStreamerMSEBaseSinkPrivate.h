@@ -23,12 +23,16 @@
 #include <string>
 
 #include "ControlBackendInterface.h"
+#include "FlightRecorder.h"
 #include "MediaPlayerManager.h"
 #include "RialtoGStreamerMSEBaseSinkCallbacks.h"
+#include "RingQueue.h"
+#include "SampleRecords.h"
+#include "SinkStatistics.h"
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 G_BEGIN_DECLS
 
@@ -37,12 +41,7 @@ struct _RialtoMSEBaseSinkPrivate
     _RialtoMSEBaseSinkPrivate() : m_sourceId(-1), m_isFlushOngoing(false), m_isStateCommitNeeded(false), m_hasDrm(true)
     {
     }
-    ~_RialtoMSEBaseSinkPrivate()
-    {
-        if (m_caps)
-            gst_caps_unref(m_caps);
-        clearBuffersUnlocked();
-    }
+    ~_RialtoMSEBaseSinkPrivate() { clearBuffersUnlocked(); }
 
     void clearBuffersUnlocked()
     {
@@ -50,18 +49,62 @@ struct _RialtoMSEBaseSinkPrivate
         m_needDataCondVariable.notify_all();
         while (!m_samples.empty())
         {
-            GstSample *sample = m_samples.front();
+            releaseRecord(m_samples.front());
             m_samples.pop();
-            gst_sample_unref(sample);
         }
+        m_queuedBytes = 0;
+        clearRetainedSamplesUnlocked();
+    }
+
+    void clearRetainedSamplesUnlocked()
+    {
+        while (!m_retainedSamples.empty())
+        {
+            releaseRecord(m_retainedSamples.front());
+            m_retainedSamples.pop();
+        }
+        m_retainedBytes = 0;
+        releaseUnusedGenerationsUnlocked();
+    }
+
+    // The low watermark is kept below the high one, so that a blocked chain function is always woken
+    size_t getQueueLowWatermarkUnlocked() const
+    {
+        return std::min(m_queueLowWatermark, m_queueHighWatermark - 1);
+    }
+
+    static void releaseRecord(const SampleRecord &record)
+    {
+        if (record.buffer)
+            gst_buffer_unref(record.buffer);
+    }
+
+    // The retained samples were sent before the queued ones, the oldest record is the first one retained
+    void releaseUnusedGenerationsUnlocked()
+    {
+        if (!m_retainedSamples.empty())
+            m_sampleTables.releaseUnused(&m_retainedSamples.front());
+        else if (!m_samples.empty())
+            m_sampleTables.releaseUnused(&m_samples.front());
+        else
+            m_sampleTables.releaseUnused(nullptr);
     }
 
     GstPad *m_sinkPad = nullptr;
     GstSegment m_lastSegment;
-    GstCaps *m_caps = nullptr;
+    // The caps and segments of the queued samples, the current caps are the last ones
+    SampleRecordTables m_sampleTables;
 
     std::atomic<int32_t> m_sourceId;
-    std::queue<GstSample *> m_samples;
+    RingQueue<SampleRecord> m_samples;
+    size_t m_queuedBytes = 0;
+    // The chain function blocks when the queue reaches the high watermark, it is woken once the puller has drained
+    // the queue down to the low watermark instead of after every sample
+    static constexpr size_t kDefaultQueueHighWatermark = 24;
+    static constexpr size_t kDefaultQueueLowWatermark = 12;
+    size_t m_queueHighWatermark = kDefaultQueueHighWatermark;
+    size_t m_queueLowWatermark = kDefaultQueueLowWatermark;
+    bool m_isChainWaiting = false;
     bool m_isEos = false;
     std::atomic<bool> m_isFlushOngoing;
     std::atomic<bool> m_isStateCommitNeeded;
@@ -83,5 +126,13 @@ struct _RialtoMSEBaseSinkPrivate
     bool m_isSinglePathStream = false;
     int32_t m_numOfStreams = 1;
     std::atomic<bool> m_hasDrm;
+
+    // Samples already sent to the server, starting with a key frame, kept to resume after the application was inactive
+    RingQueue<SampleRecord> m_retainedSamples;
+    size_t m_retainedBytes = 0;
+    size_t m_retainLimitBytes = 0;
+
+    SinkStatistics m_statistics;
+    FlightRecorder m_flightRecorder;
 };
 G_END_DECLS
@@ -21,7 +21,7 @@
 #include "GStreamerMSEUtils.h"
 #include "RialtoGStreamerMSEBaseSinkPrivate.h"
 #include "RialtoGStreamerMSEVideoSinkPrivate.h"
-#include <IMediaPipelineCapabilities.h>
+#include "SupportedMimeTypesCache.h"
 #include <gst/gst.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -116,6 +116,14 @@ static GstStateChangeReturn rialto_mse_video_sink_change_state(GstElement *eleme
         return result;
     }
 
+    if (GST_STATE_CHANGE_NULL_TO_READY == transition)
+    {
+        // Rialto is running now, so start creating the media player session while the rest of the pipeline
+        // is set up. It is joined when the media player client is attached.
+        GstObject *parentObject = rialto_mse_base_get_oldest_gst_bin_parent(element);
+        basePriv->m_mediaPlayerManager.prewarmMediaPlayerClient(parentObject, priv->maxWidth, priv->maxHeight);
+    }
+
     return result;
 }
 
@@ -389,13 +397,10 @@ static void rialto_mse_video_sink_class_init(RialtoMSEVideoSinkClass *klass)
                                                          "allow frame stepping on preroll into pause", FALSE,
                                                          G_PARAM_READWRITE));
 
-    std::unique_ptr<firebolt::rialto::IMediaPipelineCapabilities> mediaPlayerCapabilities =
-        firebolt::rialto::IMediaPipelineCapabilitiesFactory::createFactory()->createMediaPipelineCapabilities();
-    if (mediaPlayerCapabilities)
+    std::vector<std::string> supportedMimeTypes;
+    if (SupportedMimeTypesCache::instance().getSupportedMimeTypes(firebolt::rialto::MediaSourceType::VIDEO,
+                                                                  supportedMimeTypes))
     {
-        std::vector<std::string> supportedMimeTypes =
-            mediaPlayerCapabilities->getSupportedMimeTypes(firebolt::rialto::MediaSourceType::VIDEO);
-
         rialto_mse_sink_setup_supported_caps(elementClass, supportedMimeTypes);
     }
     else
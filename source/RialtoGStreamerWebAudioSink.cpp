@@ -37,6 +37,8 @@ enum
 {
     PROP_0,
     PROP_TS_OFFSET,
+    PROP_VOLUME,
+    PROP_STATS,
     PROP_LAST
 };
 
@@ -172,6 +174,9 @@ static GstStateChangeReturn rialto_web_audio_sink_change_state(GstElement *eleme
         GST_DEBUG("GST_STATE_CHANGE_PAUSED_TO_PLAYING");
         if (!sink->priv->m_webAudioClient->isOpen())
         {
+            // The server player is created from the pcm config of the caps, so there is nothing to play before they
+            // arrive. The caps handler plays as soon as the player is opened, which a device supporting deferred
+            // play accepts before any data is written.
             GST_INFO_OBJECT(sink, "Delay playing until the caps are recieved and the player is opened");
             sink->priv->m_isPlayingDelayed = true;
             result = GST_STATE_CHANGE_ASYNC;
@@ -284,6 +289,20 @@ static gboolean rialto_web_audio_sink_event(GstPad *pad, GstObject *parent, GstE
         gst_event_unref(event);
         break;
     }
+    case GST_EVENT_FLUSH_START:
+    {
+        GST_DEBUG("GST_EVENT_FLUSH_START");
+        sink->priv->m_webAudioClient->startFlush();
+        result = gst_pad_event_default(pad, parent, event);
+        break;
+    }
+    case GST_EVENT_FLUSH_STOP:
+    {
+        GST_DEBUG("GST_EVENT_FLUSH_STOP");
+        sink->priv->m_webAudioClient->stopFlush();
+        result = gst_pad_event_default(pad, parent, event);
+        break;
+    }
     default:
         result = gst_pad_event_default(pad, parent, event);
         break;
@@ -291,8 +310,69 @@ static gboolean rialto_web_audio_sink_event(GstPad *pad, GstObject *parent, GstE
     return result;
 }
 
+static gboolean rialto_web_audio_sink_query(GstElement *element, GstQuery *query)
+{
+    RialtoWebAudioSink *sink = RIALTO_WEB_AUDIO_SINK(element);
+    GST_DEBUG_OBJECT(sink, "handling query '%s'", GST_QUERY_TYPE_NAME(query));
+    switch (GST_QUERY_TYPE(query))
+    {
+    case GST_QUERY_LATENCY:
+    {
+        GstClockTime minLatency = 0;
+        GstClockTime maxLatency = 0;
+        if (!sink->priv->m_webAudioClient->getLatency(minLatency, maxLatency))
+        {
+            break;
+        }
+
+        gboolean isLive = FALSE;
+        GstClockTime upstreamMinLatency = 0;
+        GstClockTime upstreamMaxLatency = GST_CLOCK_TIME_NONE;
+        GstPad *sinkPad = gst_element_get_static_pad(element, "sink");
+        if (sinkPad && gst_pad_peer_query(sinkPad, query))
+        {
+            gst_query_parse_latency(query, &isLive, &upstreamMinLatency, &upstreamMaxLatency);
+        }
+        if (sinkPad)
+        {
+            gst_object_unref(sinkPad);
+        }
+
+        minLatency += upstreamMinLatency;
+        maxLatency = GST_CLOCK_TIME_IS_VALID(upstreamMaxLatency) ? maxLatency + upstreamMaxLatency : GST_CLOCK_TIME_NONE;
+        GST_DEBUG_OBJECT(sink, "Latency: min %" GST_TIME_FORMAT ", max %" GST_TIME_FORMAT, GST_TIME_ARGS(minLatency),
+                         GST_TIME_ARGS(maxLatency));
+        gst_query_set_latency(query, isLive, minLatency, maxLatency);
+        return TRUE;
+    }
+    case GST_QUERY_POSITION:
+    {
+        GstFormat fmt;
+        gst_query_parse_position(query, &fmt, NULL);
+        if (GST_FORMAT_TIME != fmt)
+        {
+            break;
+        }
+
+        gint64 position = sink->priv->m_webAudioClient->getPosition();
+        GST_DEBUG_OBJECT(sink, "Queried position is %" GST_TIME_FORMAT, GST_TIME_ARGS(position));
+        if (position < 0)
+        {
+            return FALSE;
+        }
+        gst_query_set_position(query, fmt, position);
+        return TRUE;
+    }
+    default:
+        break;
+    }
+
+    return GST_ELEMENT_CLASS(parent_class)->query(element, query);
+}
+
 static void rialto_web_audio_sink_get_property(GObject *object, guint propId, GValue *value, GParamSpec *pspec)
 {
+    RialtoWebAudioSink *sink = RIALTO_WEB_AUDIO_SINK(object);
     switch (propId)
     {
     case PROP_TS_OFFSET:
@@ -301,6 +381,26 @@ static void rialto_web_audio_sink_get_property(GObject *object, guint propId, GV
                                 "synchronisation of sources");
         break;
     }
+    case PROP_VOLUME:
+    {
+        if (!sink->priv->m_webAudioClient)
+        {
+            GST_WARNING_OBJECT(object, "missing web audio client");
+            return;
+        }
+        g_value_set_double(value, sink->priv->m_webAudioClient->getVolume());
+        break;
+    }
+    case PROP_STATS:
+    {
+        if (!sink->priv->m_webAudioClient)
+        {
+            GST_WARNING_OBJECT(object, "missing web audio client");
+            return;
+        }
+        g_value_take_boxed(value, sink->priv->m_webAudioClient->getStats());
+        break;
+    }
 
     default:
     {
@@ -312,6 +412,7 @@ static void rialto_web_audio_sink_get_property(GObject *object, guint propId, GV
 
 static void rialto_web_audio_sink_set_property(GObject *object, guint propId, const GValue *value, GParamSpec *pspec)
 {
+    RialtoWebAudioSink *sink = RIALTO_WEB_AUDIO_SINK(object);
     switch (propId)
     {
     case PROP_TS_OFFSET:
@@ -320,6 +421,19 @@ static void rialto_web_audio_sink_set_property(GObject *object, guint propId, co
                                 "synchronisation of sources");
         break;
     }
+    case PROP_VOLUME:
+    {
+        if (!sink->priv->m_webAudioClient)
+        {
+            GST_WARNING_OBJECT(object, "missing web audio client");
+            return;
+        }
+        if (!sink->priv->m_webAudioClient->setVolume(g_value_get_double(value)))
+        {
+            GST_ERROR_OBJECT(object, "Failed to set the volume");
+        }
+        break;
+    }
     default:
     {
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
@@ -336,6 +450,11 @@ static GstFlowReturn rialto_web_audio_sink_chain(GstPad *pad, GstObject *parent,
     {
         return GST_FLOW_OK;
     }
+    else if (GST_PAD_IS_FLUSHING(pad))
+    {
+        GST_DEBUG_OBJECT(sink, "Sample dropped by flush");
+        return GST_FLOW_FLUSHING;
+    }
     else
     {
         GST_ERROR_OBJECT(sink, "Failed to push sample");
@@ -418,12 +537,20 @@ static void rialto_web_audio_sink_class_init(RialtoWebAudioSinkClass *klass)
 
     elementClass->change_state = rialto_web_audio_sink_change_state;
     elementClass->send_event = rialto_web_audio_sink_send_event;
+    elementClass->query = rialto_web_audio_sink_query;
 
     g_object_class_install_property(gobjectClass, PROP_TS_OFFSET,
                                     g_param_spec_int64("ts-offset",
                                                        "ts-offset", "Not supported, RialtoWebAudioSink does not require the synchronisation of sources",
                                                        G_MININT64, G_MAXINT64, 0,
                                                        GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+    g_object_class_install_property(gobjectClass, PROP_VOLUME,
+                                    g_param_spec_double("volume", "Volume", "Volume of this stream", 0, 1.0, 1.0,
+                                                        GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+    g_object_class_install_property(gobjectClass, PROP_STATS,
+                                    g_param_spec_boxed("stats", "Statistics", "Statistics of the data path",
+                                                       GST_TYPE_STRUCTURE,
+                                                       GParamFlags(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
     rialto_web_audio_sink_setup_supported_caps(elementClass);
 
     gst_element_class_set_details_simple(elementClass, "Rialto Web Audio Sink", "Decoder/Audio/Sink/Audio",
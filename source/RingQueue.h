@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A FIFO queue in a ring buffer.
+ *
+ * Unlike std::deque, pushing and popping never allocates once the queue has grown to its working size, the storage
+ * is only reallocated when the queue is full.
+ */
+template <typename T> class RingQueue
+{
+public:
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    T &front() { return m_items[m_head]; }
+    const T &front() const { return m_items[m_head]; }
+    T &back() { return m_items[getIndex(m_size - 1)]; }
+    const T &back() const { return m_items[getIndex(m_size - 1)]; }
+
+    /**
+     * @brief Gets the item at the position from the front of the queue.
+     */
+    T &operator[](size_t position) { return m_items[getIndex(position)]; }
+    const T &operator[](size_t position) const { return m_items[getIndex(position)]; }
+
+    void push(T item)
+    {
+        if (m_size == m_items.size())
+        {
+            grow();
+        }
+        m_items[getIndex(m_size)] = std::move(item);
+        ++m_size;
+    }
+
+    void pop()
+    {
+        // Release what the item holds now, not when the slot is reused
+        m_items[m_head] = T{};
+        m_head = (m_head + 1) % m_items.size();
+        --m_size;
+    }
+
+    void clear()
+    {
+        while (!empty())
+        {
+            pop();
+        }
+    }
+
+    /**
+     * @brief Reserves the storage for a number of items, so that the queue does not allocate until it holds more.
+     */
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_items.size())
+        {
+            reallocate(capacity);
+        }
+    }
+
+    void swap(RingQueue &other)
+    {
+        m_items.swap(other.m_items);
+        std::swap(m_head, other.m_head);
+        std::swap(m_size, other.m_size);
+    }
+
+private:
+    static constexpr size_t kMinCapacity{16};
+
+    size_t getIndex(size_t position) const { return (m_head + position) % m_items.size(); }
+
+    void grow() { reallocate(std::max(kMinCapacity, m_items.size() * 2)); }
+
+    void reallocate(size_t capacity)
+    {
+        std::vector<T> items(capacity);
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            items[i] = std::move((*this)[i]);
+        }
+        m_items.swap(items);
+        m_head = 0;
+    }
+
+    std::vector<T> m_items;
+    size_t m_head{0};
+    size_t m_size{0};
+};
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SampleRecords.h"
+
+namespace
+{
+// The generations increase with wrap around, the offset from the first kept generation is the position in the table
+size_t getPosition(uint32_t generation, uint32_t firstGeneration)
+{
+    return static_cast<uint32_t>(generation - firstGeneration);
+}
+} // namespace
+
+SampleRecordTables::SampleRecordTables()
+{
+    GstSegment segment;
+    gst_segment_init(&segment, GST_FORMAT_TIME);
+    m_caps.push(nullptr);
+    m_segments.push(segment);
+}
+
+SampleRecordTables::~SampleRecordTables()
+{
+    while (!m_caps.empty())
+    {
+        if (m_caps.front())
+            gst_caps_unref(m_caps.front());
+        m_caps.pop();
+    }
+}
+
+void SampleRecordTables::setCaps(GstCaps *caps)
+{
+    m_caps.push(caps);
+}
+
+void SampleRecordTables::setSegment(const GstSegment &segment)
+{
+    m_segments.push(segment);
+}
+
+GstCaps *SampleRecordTables::getCurrentCaps() const
+{
+    return m_caps.back();
+}
+
+SampleRecord SampleRecordTables::createRecord(GstBuffer *buffer) const
+{
+    return SampleRecord{buffer, static_cast<uint32_t>(m_firstCapsGeneration + m_caps.size() - 1),
+                        static_cast<uint32_t>(m_firstSegmentGeneration + m_segments.size() - 1)};
+}
+
+GstCaps *SampleRecordTables::getCaps(const SampleRecord &record) const
+{
+    return m_caps[getPosition(record.capsGeneration, m_firstCapsGeneration)];
+}
+
+const GstSegment &SampleRecordTables::getSegment(const SampleRecord &record) const
+{
+    return m_segments[getPosition(record.segmentGeneration, m_firstSegmentGeneration)];
+}
+
+void SampleRecordTables::releaseUnused(const SampleRecord *oldestRecord)
+{
+    const size_t kCapsToKeep{oldestRecord ? m_caps.size() - getPosition(oldestRecord->capsGeneration,
+                                                                         m_firstCapsGeneration)
+                                          : 1};
+    while (m_caps.size() > kCapsToKeep)
+    {
+        if (m_caps.front())
+            gst_caps_unref(m_caps.front());
+        m_caps.pop();
+        ++m_firstCapsGeneration;
+    }
+
+    const size_t kSegmentsToKeep{oldestRecord ? m_segments.size() - getPosition(oldestRecord->segmentGeneration,
+                                                                                m_firstSegmentGeneration)
+                                              : 1};
+    while (m_segments.size() > kSegmentsToKeep)
+    {
+        m_segments.pop();
+        ++m_firstSegmentGeneration;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include "RingQueue.h"
+#include <cstdint>
+#include <gst/gst.h>
+
+/**
+ * @brief A buffer queued by a sink, with the generations of the caps and of the segment in effect when it arrived.
+ *
+ * The caps and the segments are kept once in SampleRecordTables, as they only change on CAPS and SEGMENT events.
+ */
+struct SampleRecord
+{
+    GstBuffer *buffer{nullptr};
+    uint32_t capsGeneration{0};
+    uint32_t segmentGeneration{0};
+};
+
+/**
+ * @brief The side tables of the caps and segments referenced by the sample records of a sink.
+ *
+ * A new generation is added on each CAPS or SEGMENT event, the generations no longer referenced by a queued record
+ * are released by releaseUnused(). The current generation is always kept. Not thread safe, the sink mutex guards it.
+ */
+class SampleRecordTables
+{
+public:
+    SampleRecordTables();
+    ~SampleRecordTables();
+    SampleRecordTables(const SampleRecordTables &) = delete;
+    SampleRecordTables &operator=(const SampleRecordTables &) = delete;
+
+    /**
+     * @brief Starts a caps generation.
+     *
+     * @param[in] caps : The new caps, the tables take the ownership
+     */
+    void setCaps(GstCaps *caps);
+
+    /**
+     * @brief Starts a segment generation.
+     *
+     * @param[in] segment : The new segment, copied into the table
+     */
+    void setSegment(const GstSegment &segment);
+
+    /**
+     * @brief Gets the caps of the current generation.
+     *
+     * @retval the caps, nullptr before the first caps.
+     */
+    GstCaps *getCurrentCaps() const;
+
+    /**
+     * @brief Creates the record of a buffer received with the current caps and segment.
+     *
+     * @param[in] buffer : The buffer, the record takes the ownership of the reference
+     *
+     * @retval the record.
+     */
+    SampleRecord createRecord(GstBuffer *buffer) const;
+
+    /**
+     * @brief Gets the caps of a record, valid as long as the record is queued.
+     */
+    GstCaps *getCaps(const SampleRecord &record) const;
+
+    /**
+     * @brief Gets the segment of a record, valid as long as the record is queued.
+     */
+    const GstSegment &getSegment(const SampleRecord &record) const;
+
+    /**
+     * @brief Releases the generations older than the oldest queued record.
+     *
+     * @param[in] oldestRecord : The oldest queued record, nullptr when no record is queued
+     */
+    void releaseUnused(const SampleRecord *oldestRecord);
+
+    /**
+     * @brief Gets the number of generations kept, for the tests.
+     */
+    size_t getCapsGenerationCount() const { return m_caps.size(); }
+    size_t getSegmentGenerationCount() const { return m_segments.size(); }
+
+private:
+    RingQueue<GstCaps *> m_caps;
+    uint32_t m_firstCapsGeneration{0};
+    RingQueue<GstSegment> m_segments;
+    uint32_t m_firstSegmentGeneration{0};
+};
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SinkStatistics.h"
+#include <algorithm>
+
+namespace
+{
+size_t getLatencyBucket(uint64_t latencyUs, size_t bucketCount)
+{
+    size_t bucket = 0;
+    while (latencyUs > 1 && bucket + 1 < bucketCount)
+    {
+        latencyUs >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+} // namespace
+
+void SinkStatistics::recordNeedData(size_t frameCount)
+{
+    m_needDataRequests.fetch_add(1, std::memory_order_relaxed);
+    m_framesRequested.fetch_add(frameCount, std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordHaveData(firebolt::rialto::MediaSourceStatus status, size_t frameCount,
+                                    std::chrono::microseconds latency)
+{
+    m_framesDelivered.fetch_add(frameCount, std::memory_order_relaxed);
+    if (status == firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES)
+    {
+        m_noAvailableSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (status == firebolt::rialto::MediaSourceStatus::EOS)
+    {
+        m_eos.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t kLatencyUs = static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(latency.count(), 0));
+    m_haveDataCount.fetch_add(1, std::memory_order_relaxed);
+    m_latencySumUs.fetch_add(kLatencyUs, std::memory_order_relaxed);
+    m_latencyHistogram[getLatencyBucket(kLatencyUs, kLatencyBuckets)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = m_latencyMinUs.load(std::memory_order_relaxed);
+    while (kLatencyUs < current &&
+           !m_latencyMinUs.compare_exchange_weak(current, kLatencyUs, std::memory_order_relaxed))
+    {
+    }
+    current = m_latencyMaxUs.load(std::memory_order_relaxed);
+    while (kLatencyUs > current &&
+           !m_latencyMaxUs.compare_exchange_weak(current, kLatencyUs, std::memory_order_relaxed))
+    {
+    }
+}
+
+void SinkStatistics::recordNoSpace()
+{
+    m_noSpace.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordBytesPending(size_t bytes)
+{
+    m_bytesPending.store(bytes, std::memory_order_relaxed);
+    if (bytes > 0)
+    {
+        m_spaceDeferred.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SinkStatistics::recordBytesSent(size_t bytes)
+{
+    m_bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordChainBlocked(std::chrono::microseconds duration)
+{
+    m_chainBlockedUs.fetch_add(static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(duration.count(), 0)),
+                               std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordUnderflow()
+{
+    m_underflows.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordTimeToFirstSample(std::chrono::microseconds duration)
+{
+    m_timeToFirstSampleUs.store(static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(duration.count(), 0)),
+                                std::memory_order_relaxed);
+}
+
+void SinkStatistics::recordDroppedSample(size_t bytes)
+{
+    m_samplesDropped.fetch_add(1, std::memory_order_relaxed);
+    m_bytesDropped.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+uint64_t SinkStatistics::getLatencyPercentile(double percentile) const
+{
+    uint64_t count = 0;
+    std::array<uint64_t, kLatencyBuckets> histogram;
+    for (size_t i = 0; i < kLatencyBuckets; ++i)
+    {
+        histogram[i] = m_latencyHistogram[i].load(std::memory_order_relaxed);
+        count += histogram[i];
+    }
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // The percentile is the upper bound of its bucket, capped by the maximum seen
+    const uint64_t kRank = static_cast<uint64_t>(percentile * static_cast<double>(count - 1)) + 1;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kLatencyBuckets; ++i)
+    {
+        cumulative += histogram[i];
+        if (cumulative >= kRank)
+        {
+            return std::min<uint64_t>((uint64_t{2} << i) - 1, m_latencyMaxUs.load(std::memory_order_relaxed));
+        }
+    }
+    return m_latencyMaxUs.load(std::memory_order_relaxed);
+}
+
+GstStructure *SinkStatistics::createStructure(uint64_t queuedSamples, uint64_t queuedBytes,
+                                              GstClockTime queuedTime) const
+{
+    const uint64_t kHaveDataCount = m_haveDataCount.load(std::memory_order_relaxed);
+    const uint64_t kLatencyMinUs = kHaveDataCount ? m_latencyMinUs.load(std::memory_order_relaxed) : 0;
+    const uint64_t kLatencyAvgUs = kHaveDataCount ? m_latencySumUs.load(std::memory_order_relaxed) / kHaveDataCount
+                                                  : 0;
+
+    return gst_structure_new("rialto-sink-stats", "queued-samples", G_TYPE_UINT64, queuedSamples, "queued-bytes",
+                             G_TYPE_UINT64, queuedBytes, "queued-time", G_TYPE_UINT64, queuedTime,
+                             "need-data-requests", G_TYPE_UINT64, m_needDataRequests.load(std::memory_order_relaxed),
+                             "frames-requested", G_TYPE_UINT64, m_framesRequested.load(std::memory_order_relaxed),
+                             "frames-delivered", G_TYPE_UINT64, m_framesDelivered.load(std::memory_order_relaxed),
+                             "no-space", G_TYPE_UINT64, m_noSpace.load(std::memory_order_relaxed),
+                             "bytes-pending", G_TYPE_UINT64, m_bytesPending.load(std::memory_order_relaxed),
+                             "space-deferred", G_TYPE_UINT64, m_spaceDeferred.load(std::memory_order_relaxed),
+                             "no-available-samples", G_TYPE_UINT64,
+                             m_noAvailableSamples.load(std::memory_order_relaxed), "eos", G_TYPE_UINT64,
+                             m_eos.load(std::memory_order_relaxed), "latency-min-us", G_TYPE_UINT64, kLatencyMinUs,
+                             "latency-avg-us", G_TYPE_UINT64, kLatencyAvgUs, "latency-max-us", G_TYPE_UINT64,
+                             m_latencyMaxUs.load(std::memory_order_relaxed), "latency-p99-us", G_TYPE_UINT64,
+                             getLatencyPercentile(0.99), "bytes-sent", G_TYPE_UINT64,
+                             m_bytesSent.load(std::memory_order_relaxed), "chain-blocked-us", G_TYPE_UINT64,
+                             m_chainBlockedUs.load(std::memory_order_relaxed), "underflows", G_TYPE_UINT64,
+                             m_underflows.load(std::memory_order_relaxed), "time-to-first-sample-us", G_TYPE_UINT64,
+                             m_timeToFirstSampleUs.load(std::memory_order_relaxed), "samples-dropped", G_TYPE_UINT64,
+                             m_samplesDropped.load(std::memory_order_relaxed), "bytes-dropped", G_TYPE_UINT64,
+                             m_bytesDropped.load(std::memory_order_relaxed), nullptr);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <MediaCommon.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <gst/gst.h>
+
+/**
+ * @brief Runtime statistics of the data path of a sink, exposed by its "stats" property.
+ *
+ * The counters are updated with relaxed atomics, so they can be recorded from any thread without locking.
+ * A snapshot is not consistent across counters, which is fine for monitoring.
+ */
+class SinkStatistics
+{
+public:
+    /**
+     * @brief Records a request for data from the server.
+     *
+     * @param[in] frameCount : The number of frames requested
+     */
+    void recordNeedData(size_t frameCount);
+
+    /**
+     * @brief Records the answer to a request for data.
+     *
+     * @param[in] status      : The status sent to the server
+     * @param[in] frameCount  : The number of frames delivered
+     * @param[in] latency     : The time from the request to the answer
+     */
+    void recordHaveData(firebolt::rialto::MediaSourceStatus status, size_t frameCount,
+                        std::chrono::microseconds latency);
+
+    /**
+     * @brief Records a sample that could not be added, because the server had no space for it.
+     */
+    void recordNoSpace();
+
+    /**
+     * @brief Records the bytes a request left queued, because the next sample did not fit in its shared memory.
+     *
+     * @param[in] bytes : The size of the sample left for the next request, 0 when nothing was left for lack of space
+     */
+    void recordBytesPending(size_t bytes);
+
+    /**
+     * @brief Records the bytes of a sample sent to the server.
+     *
+     * @param[in] bytes : The size of the sample
+     */
+    void recordBytesSent(size_t bytes);
+
+    /**
+     * @brief Records the time the chain function was blocked on a full queue.
+     *
+     * @param[in] duration : The blocking time
+     */
+    void recordChainBlocked(std::chrono::microseconds duration);
+
+    /**
+     * @brief Records a buffer underflow reported by the server.
+     */
+    void recordUnderflow();
+
+    /**
+     * @brief Records the time from opening the player to writing its first sample. A later open records it again.
+     *
+     * @param[in] duration : The time to first sample
+     */
+    void recordTimeToFirstSample(std::chrono::microseconds duration);
+
+    /**
+     * @brief Records a sample dropped because there was no player to write it to.
+     *
+     * @param[in] bytes : The size of the sample
+     */
+    void recordDroppedSample(size_t bytes);
+
+    /**
+     * @brief Creates the "stats" structure.
+     *
+     * @param[in] queuedSamples : The number of samples queued in the sink
+     * @param[in] queuedBytes   : The size of the samples queued in the sink
+     * @param[in] queuedTime    : The duration of the samples queued in the sink
+     *
+     * @retval the new structure, owned by the caller.
+     */
+    GstStructure *createStructure(uint64_t queuedSamples, uint64_t queuedBytes, GstClockTime queuedTime) const;
+
+private:
+    // Latency histogram buckets, bucket n holds latencies below 2^(n+1) us
+    static constexpr size_t kLatencyBuckets{32};
+
+    uint64_t getLatencyPercentile(double percentile) const;
+
+    std::atomic<uint64_t> m_needDataRequests{0};
+    std::atomic<uint64_t> m_framesRequested{0};
+    std::atomic<uint64_t> m_framesDelivered{0};
+    std::atomic<uint64_t> m_noSpace{0};
+    std::atomic<uint64_t> m_bytesPending{0};
+    std::atomic<uint64_t> m_spaceDeferred{0};
+    std::atomic<uint64_t> m_noAvailableSamples{0};
+    std::atomic<uint64_t> m_eos{0};
+    std::atomic<uint64_t> m_haveDataCount{0};
+    std::atomic<uint64_t> m_latencyMinUs{UINT64_MAX};
+    std::atomic<uint64_t> m_latencyMaxUs{0};
+    std::atomic<uint64_t> m_latencySumUs{0};
+    std::array<std::atomic<uint64_t>, kLatencyBuckets> m_latencyHistogram{};
+    std::atomic<uint64_t> m_bytesSent{0};
+    std::atomic<uint64_t> m_chainBlockedUs{0};
+    std::atomic<uint64_t> m_underflows{0};
+    std::atomic<uint64_t> m_timeToFirstSampleUs{0};
+    std::atomic<uint64_t> m_samplesDropped{0};
+    std::atomic<uint64_t> m_bytesDropped{0};
+};
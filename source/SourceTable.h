@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Maps the ids of the attached sources to objects that other threads look up without locking.
+ *
+ * The table is only modified by one thread, while any thread can look up a source. A lookup pins the slot of the
+ * source while it uses the object, and a removal waits until the slot is no longer pinned before releasing it.
+ * There are only a few sources, so the slots are scanned.
+ */
+template <typename T, size_t kSlots = 4> class SourceTable
+{
+public:
+    /**
+     * @brief Adds the object of a source.
+     *
+     * @retval false if the table is full.
+     */
+    bool insert(int32_t sourceId, const std::shared_ptr<T> &value)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.sourceId.load() == kNoSource)
+            {
+                // A lookup may still hold the slot after checking a stale id, it does not touch the value then
+                waitForReaders(slot);
+                slot.value = value;
+                slot.sourceId.store(sourceId);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Removes the object of a source, once no lookup uses it.
+     */
+    void erase(int32_t sourceId)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.sourceId.load() == sourceId)
+            {
+                slot.sourceId.store(kNoSource);
+                waitForReaders(slot);
+                slot.value.reset();
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.sourceId.load() != kNoSource)
+            {
+                erase(slot.sourceId.load());
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the function with the object of a source, the object is not removed until the function returns.
+     *
+     * @retval false if there is no such source.
+     */
+    template <typename Function> bool find(int32_t sourceId, Function &&function) const
+    {
+        for (const Slot &slot : m_slots)
+        {
+            if (slot.sourceId.load(std::memory_order_relaxed) != sourceId)
+            {
+                continue;
+            }
+            // The id is checked again once the slot is pinned, as it may have been removed in between
+            slot.readers.fetch_add(1);
+            if (slot.sourceId.load() == sourceId)
+            {
+                function(*slot.value);
+                slot.readers.fetch_sub(1);
+                return true;
+            }
+            slot.readers.fetch_sub(1);
+        }
+        return false;
+    }
+
+private:
+    static constexpr int32_t kNoSource{-1};
+
+    struct Slot
+    {
+        std::atomic<int32_t> sourceId{kNoSource};
+        mutable std::atomic<uint32_t> readers{0};
+        std::shared_ptr<T> value;
+    };
+
+    static void waitForReaders(const Slot &slot)
+    {
+        while (slot.readers.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::array<Slot, kSlots> m_slots;
+};
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SupportedMimeTypesCache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gst/gst.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+const std::string kAudioTypeStr{"audio"};
+const std::string kVideoTypeStr{"video"};
+const std::string kCacheFileName{"rialto-mime-types"};
+
+const char *getEnv(const char *name)
+{
+    const char *value = getenv(name);
+    return value ? value : "";
+}
+} // namespace
+
+SupportedMimeTypesCache::SupportedMimeTypesCache(
+    const std::shared_ptr<firebolt::rialto::IMediaPipelineCapabilitiesFactory> &capabilitiesFactory,
+    const std::string &cacheFilePath, const std::string &serverKey)
+    : m_capabilitiesFactory{capabilitiesFactory}, m_cacheFilePath{cacheFilePath}, m_serverKey{serverKey},
+      m_isLoaded{false}, m_isRefreshNeeded{false}, m_isRefreshCancelled{std::make_shared<std::atomic<bool>>(false)}
+{
+}
+
+SupportedMimeTypesCache::~SupportedMimeTypesCache()
+{
+    // The refresh is not joined, so that a slow server does not hold up the exit of the process
+    *m_isRefreshCancelled = true;
+}
+
+SupportedMimeTypesCache &SupportedMimeTypesCache::instance()
+{
+    static SupportedMimeTypesCache cache{firebolt::rialto::IMediaPipelineCapabilitiesFactory::createFactory(),
+                                         getCacheFilePath(), getEnv("RIALTO_SOCKET_PATH")};
+    return cache;
+}
+
+std::string SupportedMimeTypesCache::getCacheFilePath()
+{
+    const char *cacheFilePath = getenv("RIALTO_MIME_TYPES_CACHE_FILE");
+    if (cacheFilePath)
+    {
+        return cacheFilePath;
+    }
+
+    const std::string kRuntimeDir{getEnv("XDG_RUNTIME_DIR")};
+    return (kRuntimeDir.empty() ? "/tmp" : kRuntimeDir) + "/" + kCacheFileName;
+}
+
+bool SupportedMimeTypesCache::getSupportedMimeTypes(firebolt::rialto::MediaSourceType type,
+                                                    std::vector<std::string> &mimeTypes)
+{
+    if (m_cacheFilePath.empty())
+    {
+        // No cache, ask the server for this type only
+        std::unique_ptr<firebolt::rialto::IMediaPipelineCapabilities> mediaPlayerCapabilities =
+            m_capabilitiesFactory ? m_capabilitiesFactory->createMediaPipelineCapabilities() : nullptr;
+        if (!mediaPlayerCapabilities)
+        {
+            return false;
+        }
+        mimeTypes = mediaPlayerCapabilities->getSupportedMimeTypes(type);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isLoaded)
+    {
+        if (readCacheFile(m_mimeTypes))
+        {
+            GST_INFO("Using the supported mime types cached in %s", m_cacheFilePath.c_str());
+            m_isLoaded = true;
+            m_isRefreshNeeded = true;
+        }
+        else if (queryServer(m_capabilitiesFactory, m_mimeTypes))
+        {
+            m_isLoaded = true;
+            writeCacheFile(m_cacheFilePath, m_serverKey, m_mimeTypes);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    auto it = m_mimeTypes.find(type);
+    mimeTypes = it != m_mimeTypes.end() ? it->second : std::vector<std::string>{};
+    return true;
+}
+
+bool SupportedMimeTypesCache::readCacheFile(MimeTypes &mimeTypes) const
+{
+    std::ifstream file{m_cacheFilePath};
+    std::string serverKey;
+    if (!file.is_open() || !std::getline(file, serverKey))
+    {
+        return false;
+    }
+    if (serverKey != m_serverKey)
+    {
+        GST_INFO("The supported mime types were cached for another server");
+        return false;
+    }
+
+    MimeTypes cachedMimeTypes{{firebolt::rialto::MediaSourceType::AUDIO, {}},
+                              {firebolt::rialto::MediaSourceType::VIDEO, {}}};
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream{line};
+        std::string typeStr;
+        std::string mimeType;
+        if (!(lineStream >> typeStr >> mimeType))
+        {
+            GST_WARNING("Malformed line in the mime types cache: '%s'", line.c_str());
+            return false;
+        }
+
+        if (typeStr == kAudioTypeStr)
+        {
+            cachedMimeTypes[firebolt::rialto::MediaSourceType::AUDIO].push_back(mimeType);
+        }
+        else if (typeStr == kVideoTypeStr)
+        {
+            cachedMimeTypes[firebolt::rialto::MediaSourceType::VIDEO].push_back(mimeType);
+        }
+        else
+        {
+            GST_WARNING("Unknown source type in the mime types cache: '%s'", typeStr.c_str());
+            return false;
+        }
+    }
+
+    mimeTypes = std::move(cachedMimeTypes);
+    return true;
+}
+
+void SupportedMimeTypesCache::writeCacheFile(const std::string &cacheFilePath, const std::string &serverKey,
+                                             const MimeTypes &mimeTypes)
+{
+    std::ostringstream content;
+    content << serverKey << '\n';
+    for (const auto &[type, typeMimeTypes] : mimeTypes)
+    {
+        const std::string &typeStr = type == firebolt::rialto::MediaSourceType::AUDIO ? kAudioTypeStr : kVideoTypeStr;
+        for (const std::string &mimeType : typeMimeTypes)
+        {
+            content << typeStr << ' ' << mimeType << '\n';
+        }
+    }
+    const std::string kContent{content.str()};
+
+    // Write to a uniquely named temporary file first, so that a concurrent reader never sees a partial cache and
+    // concurrent writers never share a file
+    std::string tmpFilePath{cacheFilePath + ".XXXXXX"};
+    const int kFd = mkstemp(tmpFilePath.data());
+    if (kFd < 0)
+    {
+        GST_WARNING("Failed to create a temporary file for %s", cacheFilePath.c_str());
+        return;
+    }
+
+    // mkstemp makes the file private, the cache is shared with the other clients of the server
+    bool isWritten = fchmod(kFd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0;
+    std::size_t writtenBytes = 0;
+    while (isWritten && writtenBytes < kContent.size())
+    {
+        const ssize_t kResult = write(kFd, kContent.data() + writtenBytes, kContent.size() - writtenBytes);
+        isWritten = kResult > 0;
+        writtenBytes += isWritten ? static_cast<std::size_t>(kResult) : 0;
+    }
+    isWritten = (close(kFd) == 0) && isWritten;
+
+    if (!isWritten)
+    {
+        GST_WARNING("Failed to write %s", tmpFilePath.c_str());
+        std::remove(tmpFilePath.c_str());
+        return;
+    }
+
+    if (std::rename(tmpFilePath.c_str(), cacheFilePath.c_str()) != 0)
+    {
+        GST_WARNING("Failed to update %s", cacheFilePath.c_str());
+        std::remove(tmpFilePath.c_str());
+    }
+}
+
+bool SupportedMimeTypesCache::queryServer(
+    const std::shared_ptr<firebolt::rialto::IMediaPipelineCapabilitiesFactory> &capabilitiesFactory,
+    MimeTypes &mimeTypes)
+{
+    std::unique_ptr<firebolt::rialto::IMediaPipelineCapabilities> mediaPlayerCapabilities =
+        capabilitiesFactory ? capabilitiesFactory->createMediaPipelineCapabilities() : nullptr;
+    if (!mediaPlayerCapabilities)
+    {
+        return false;
+    }
+
+    mimeTypes[firebolt::rialto::MediaSourceType::AUDIO] =
+        mediaPlayerCapabilities->getSupportedMimeTypes(firebolt::rialto::MediaSourceType::AUDIO);
+    mimeTypes[firebolt::rialto::MediaSourceType::VIDEO] =
+        mediaPlayerCapabilities->getSupportedMimeTypes(firebolt::rialto::MediaSourceType::VIDEO);
+    return true;
+}
+
+void SupportedMimeTypesCache::refreshInBackground()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isRefreshNeeded)
+    {
+        m_isRefreshNeeded = false;
+        startRefresh();
+    }
+}
+
+void SupportedMimeTypesCache::startRefresh()
+{
+    // The pad templates are already built, the refreshed types are used from the next start
+    std::thread(
+        [capabilitiesFactory = m_capabilitiesFactory, cacheFilePath = m_cacheFilePath, serverKey = m_serverKey,
+         isCancelled = m_isRefreshCancelled]()
+        {
+            MimeTypes mimeTypes;
+            if (queryServer(capabilitiesFactory, mimeTypes) && !*isCancelled)
+            {
+                writeCacheFile(cacheFilePath, serverKey, mimeTypes);
+            }
+        })
+        .detach();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <IMediaPipelineCapabilities.h>
+#include <MediaCommon.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Caches the mime types supported by RialtoServer in a file.
+ *
+ * The file is $XDG_RUNTIME_DIR/rialto-mime-types, or /tmp/rialto-mime-types without a runtime directory. The
+ * RIALTO_MIME_TYPES_CACHE_FILE environment variable overrides the path, an empty value disables the cache. The
+ * file is keyed by the server socket, so a cache written for another server is ignored. When the cache is used,
+ * the server is queried again in the background once a sink is started, and the file is updated for the next start.
+ */
+class SupportedMimeTypesCache
+{
+public:
+    SupportedMimeTypesCache(
+        const std::shared_ptr<firebolt::rialto::IMediaPipelineCapabilitiesFactory> &capabilitiesFactory,
+        const std::string &cacheFilePath, const std::string &serverKey);
+    ~SupportedMimeTypesCache();
+
+    SupportedMimeTypesCache(const SupportedMimeTypesCache &) = delete;
+    SupportedMimeTypesCache &operator=(const SupportedMimeTypesCache &) = delete;
+
+    static SupportedMimeTypesCache &instance();
+
+    /**
+     * @brief Gets the path of the cache file from the environment.
+     *
+     * @retval the path, empty when the cache is disabled.
+     */
+    static std::string getCacheFilePath();
+
+    /**
+     * @brief Gets the supported mime types, from the cache file if possible.
+     *
+     * @param[in]  type      : The type of the source
+     * @param[out] mimeTypes : The supported mime types
+     *
+     * @retval true on success.
+     */
+    bool getSupportedMimeTypes(firebolt::rialto::MediaSourceType type, std::vector<std::string> &mimeTypes);
+
+    /**
+     * @brief Refreshes the cache file from the server on a detached thread, if the mime types were read from it.
+     *
+     * Called when a sink is started rather than when the types are registered, so that short lived processes
+     * like gst-inspect never leave a thread inside the rialto client at exit. Only the first call refreshes.
+     */
+    void refreshInBackground();
+
+private:
+    using MimeTypes = std::map<firebolt::rialto::MediaSourceType, std::vector<std::string>>;
+
+    bool readCacheFile(MimeTypes &mimeTypes) const;
+    static void writeCacheFile(const std::string &cacheFilePath, const std::string &serverKey,
+                               const MimeTypes &mimeTypes);
+    static bool
+    queryServer(const std::shared_ptr<firebolt::rialto::IMediaPipelineCapabilitiesFactory> &capabilitiesFactory,
+                MimeTypes &mimeTypes);
+
+    /**
+     * @brief Starts the refresh thread. Called with m_mutex held.
+     *
+     * The thread uses copies of the settings, so it never waits for nor outlives the cache object. A refresh still
+     * running when the cache is destroyed does not write the file.
+     */
+    void startRefresh();
+
+    std::shared_ptr<firebolt::rialto::IMediaPipelineCapabilitiesFactory> m_capabilitiesFactory;
+    const std::string m_cacheFilePath;
+    const std::string m_serverKey;
+    std::mutex m_mutex;
+    bool m_isLoaded;
+    bool m_isRefreshNeeded;
+    MimeTypes m_mimeTypes;
+    std::shared_ptr<std::atomic<bool>> m_isRefreshCancelled;
+};
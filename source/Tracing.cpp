@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Tracing.h"
+#include <cinttypes>
+#include <cstdlib>
+#include <gst/gst.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+const char *getEnv(const char *name)
+{
+    const char *value = getenv(name);
+    return value ? value : "";
+}
+
+// The trace event format uses microseconds
+double toMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1000.0;
+}
+} // namespace
+
+Tracer::Tracer(const std::string &filePath) : m_file{nullptr}, m_isFirstEvent{true}
+{
+    if (filePath.empty())
+    {
+        return;
+    }
+
+    m_file = fopen(filePath.c_str(), "w");
+    if (!m_file)
+    {
+        GST_WARNING("Failed to open the trace file %s", filePath.c_str());
+        return;
+    }
+    GST_INFO("Writing the trace events to %s", filePath.c_str());
+    fputs("[\n", m_file);
+}
+
+Tracer::~Tracer()
+{
+    if (m_file)
+    {
+        fputs("\n]\n", m_file);
+        fclose(m_file);
+    }
+}
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer{getEnv("RIALTO_SINKS_TRACE_FILE")};
+    return tracer;
+}
+
+void Tracer::instant(const char *name, std::initializer_list<TraceArg> args)
+{
+    if (isEnabled())
+    {
+        write(name, 'i', std::chrono::steady_clock::now(), nullptr, args.begin(), args.size());
+    }
+}
+
+void Tracer::complete(const char *name, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end, std::initializer_list<TraceArg> args)
+{
+    if (isEnabled())
+    {
+        const std::chrono::steady_clock::duration kDuration{end - start};
+        write(name, 'X', start, &kDuration, args.begin(), args.size());
+    }
+}
+
+void Tracer::write(const char *name, char phase, std::chrono::steady_clock::time_point start,
+                   const std::chrono::steady_clock::duration *duration, const TraceArg *args, size_t argsCount)
+{
+    // Formatted outside of the lock, the few arguments used always fit in the buffer
+    char event[512];
+    int length = snprintf(event, sizeof(event), "{\"name\":\"%s\",\"cat\":\"rialto\",\"ph\":\"%c\",\"ts\":%.3f", name,
+                          phase, toMicroseconds(start.time_since_epoch()));
+    if (duration)
+    {
+        length += snprintf(event + length, sizeof(event) - length, ",\"dur\":%.3f", toMicroseconds(*duration));
+    }
+    else
+    {
+        length += snprintf(event + length, sizeof(event) - length, ",\"s\":\"t\"");
+    }
+    length += snprintf(event + length, sizeof(event) - length, ",\"pid\":%d,\"tid\":%ld,\"args\":{",
+                       static_cast<int>(getpid()), static_cast<long>(syscall(SYS_gettid)));
+    for (size_t i = 0; i < argsCount; ++i)
+    {
+        length += snprintf(event + length, sizeof(event) - length, "%s\"%s\":%" PRId64, i ? "," : "", args[i].name,
+                           args[i].value);
+    }
+    snprintf(event + length, sizeof(event) - length, "}}");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isFirstEvent)
+    {
+        fputs(",\n", m_file);
+    }
+    m_isFirstEvent = false;
+    fputs(event, m_file);
+}
+
+TraceScope::TraceScope(const char *name, std::initializer_list<TraceArg> args, Tracer &tracer)
+    : m_tracer{tracer}, m_name{name}, m_args{}, m_argsCount{0}
+{
+    if (!m_tracer.isEnabled())
+    {
+        return;
+    }
+
+    for (const TraceArg &arg : args)
+    {
+        if (m_argsCount < kMaxArgs)
+        {
+            m_args[m_argsCount++] = arg;
+        }
+    }
+    m_start = std::chrono::steady_clock::now();
+}
+
+TraceScope::~TraceScope()
+{
+    if (m_tracer.isEnabled())
+    {
+        const std::chrono::steady_clock::duration kDuration{std::chrono::steady_clock::now() - m_start};
+        m_tracer.write(m_name, 'X', m_start, &kDuration, m_args, m_argsCount);
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief A named integer argument of a trace event.
+ */
+struct TraceArg
+{
+    const char *name;
+    int64_t value;
+};
+
+/**
+ * @brief Writes trace events of the data path in the Chrome trace event JSON format.
+ *
+ * Opt-in with the RIALTO_SINKS_TRACE_FILE environment variable, the file can be loaded in Perfetto
+ * or chrome://tracing. When disabled, a trace point costs a single check of isEnabled().
+ */
+class Tracer
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] filePath : The file to write the events to, tracing is disabled if empty.
+     */
+    explicit Tracer(const std::string &filePath);
+    ~Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    static Tracer &instance();
+
+    /**
+     * @brief Whether the events are written.
+     *
+     * @retval true if tracing is enabled.
+     */
+    bool isEnabled() const { return m_file != nullptr; }
+
+    /**
+     * @brief Writes an event without duration.
+     *
+     * @param[in] name : The name of the event, a string literal
+     * @param[in] args : The arguments of the event
+     */
+    void instant(const char *name, std::initializer_list<TraceArg> args = {});
+
+    /**
+     * @brief Writes an event with duration.
+     *
+     * @param[in] name  : The name of the event, a string literal
+     * @param[in] start : The start of the event
+     * @param[in] end   : The end of the event
+     * @param[in] args  : The arguments of the event
+     */
+    void complete(const char *name, std::chrono::steady_clock::time_point start,
+                  std::chrono::steady_clock::time_point end, std::initializer_list<TraceArg> args = {});
+
+private:
+    friend class TraceScope;
+
+    void write(const char *name, char phase, std::chrono::steady_clock::time_point start,
+               const std::chrono::steady_clock::duration *duration, const TraceArg *args, size_t argsCount);
+
+    std::mutex m_mutex;
+    FILE *m_file;
+    bool m_isFirstEvent;
+};
+
+/**
+ * @brief Writes an event with the duration of its scope.
+ */
+class TraceScope
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] name   : The name of the event, a string literal
+     * @param[in] args   : The arguments of the event, at most kMaxArgs
+     * @param[in] tracer : The tracer to write the event to
+     */
+    explicit TraceScope(const char *name, std::initializer_list<TraceArg> args = {},
+                        Tracer &tracer = Tracer::instance());
+    ~TraceScope();
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    static constexpr size_t kMaxArgs{4};
+
+    Tracer &m_tracer;
+    const char *m_name;
+    std::chrono::steady_clock::time_point m_start;
+    TraceArg m_args[kMaxArgs];
+    size_t m_argsCount;
+};
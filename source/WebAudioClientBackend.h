@@ -18,6 +18,8 @@
 #pragma once
 
 #include "WebAudioClientBackendInterface.h"
+#include "WebAudioMixer.h"
+#include "WebAudioPlayerPool.h"
 #include <IWebAudioPlayer.h>
 #include <IWebAudioPlayerClient.h>
 #include <gst/gst.h>
@@ -28,15 +30,26 @@ namespace firebolt::rialto::client
 class WebAudioClientBackend final : public WebAudioClientBackendInterface
 {
 public:
-    WebAudioClientBackend() : m_webAudioPlayerBackend(nullptr) {}
-    ~WebAudioClientBackend() final { m_webAudioPlayerBackend.reset(); }
+    WebAudioClientBackend()
+        : m_webAudioPlayerBackend(nullptr), m_playerPool(WebAudioPlayerPool::instance()),
+          m_useSharedMixer(WebAudioMixer::isEnabled()), m_isMixerInput(false)
+    {
+    }
+    ~WebAudioClientBackend() final { destroyWebAudioBackend(); }
 
     bool createWebAudioBackend(std::weak_ptr<IWebAudioPlayerClient> client, const std::string &audioMimeType,
                                const uint32_t priority, const WebAudioConfig *config) override
     {
-        m_webAudioPlayerBackend =
-            firebolt::rialto::IWebAudioPlayerFactory::createFactory()->createWebAudioPlayer(client, audioMimeType,
-                                                                                            priority, config);
+        m_isMixerInput = m_useSharedMixer && WebAudioMixer::isSupported(audioMimeType, config);
+        if (m_isMixerInput)
+        {
+            std::shared_ptr<WebAudioMixer> mixer = WebAudioMixer::getMixer(audioMimeType, priority, *config);
+            m_webAudioPlayerBackend = mixer ? mixer->createInput(client) : nullptr;
+        }
+        else
+        {
+            m_webAudioPlayerBackend = m_playerPool->acquire(client, audioMimeType, priority, config);
+        }
 
         if (!m_webAudioPlayerBackend)
         {
@@ -45,7 +58,24 @@ public:
         }
         return true;
     }
-    void destroyWebAudioBackend() override { m_webAudioPlayerBackend.reset(); }
+    void destroyWebAudioBackend() override
+    {
+        if (m_isMixerInput)
+        {
+            m_webAudioPlayerBackend.reset();
+            return;
+        }
+        m_playerPool->destroy(std::move(m_webAudioPlayerBackend));
+    }
+    void releaseWebAudioBackend() override
+    {
+        if (m_isMixerInput)
+        {
+            m_webAudioPlayerBackend.reset();
+            return;
+        }
+        m_playerPool->release(std::move(m_webAudioPlayerBackend));
+    }
 
     bool play() override { return m_webAudioPlayerBackend->play(); }
     bool pause() override { return m_webAudioPlayerBackend->pause(); }
@@ -69,5 +99,8 @@ public:
 
 private:
     std::unique_ptr<IWebAudioPlayer> m_webAudioPlayerBackend;
+    std::shared_ptr<WebAudioPlayerPool> m_playerPool;
+    const bool m_useSharedMixer;
+    bool m_isMixerInput;
 };
 } // namespace firebolt::rialto::client
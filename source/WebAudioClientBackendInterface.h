@@ -29,6 +29,7 @@ public:
     virtual bool createWebAudioBackend(std::weak_ptr<IWebAudioPlayerClient> client, const std::string &audioMimeType,
                                        const uint32_t priority, const WebAudioConfig *config) = 0;
     virtual void destroyWebAudioBackend() = 0;
+    virtual void releaseWebAudioBackend() = 0;
 
     virtual bool play() = 0;
     virtual bool pause() = 0;
@@ -0,0 +1,510 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "WebAudioMixer.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <gst/gst.h>
+
+namespace
+{
+const std::string kPcmMimeType{"audio/x-raw"};
+constexpr std::chrono::milliseconds kMixPeriod{10};
+constexpr uint32_t kMaxUnderrunPeriods{1};
+constexpr uint32_t kInputBufferDurationMs{200};
+
+bool isS16le(const firebolt::rialto::WebAudioPcmConfig &pcm)
+{
+    return pcm.sampleSize == 16 && pcm.isSigned && !pcm.isFloat && !pcm.isBigEndian;
+}
+
+bool isF32le(const firebolt::rialto::WebAudioPcmConfig &pcm)
+{
+    return pcm.sampleSize == 32 && pcm.isFloat && !pcm.isBigEndian;
+}
+
+std::string getMixerKey(const std::string &audioMimeType, uint32_t priority,
+                        const firebolt::rialto::WebAudioPcmConfig &pcm)
+{
+    return audioMimeType + "/" + std::to_string(priority) + "/" + std::to_string(pcm.rate) + "/" +
+           std::to_string(pcm.channels) + "/" + std::to_string(pcm.sampleSize) + (pcm.isFloat ? "F" : "S");
+}
+} // namespace
+
+namespace firebolt::rialto::client
+{
+std::mutex WebAudioMixer::m_mixersMutex;
+std::map<std::string, std::weak_ptr<WebAudioMixer>> WebAudioMixer::m_mixers;
+
+WebAudioMixerInput::WebAudioMixerInput(const std::shared_ptr<WebAudioMixer> &mixer,
+                                       std::weak_ptr<IWebAudioPlayerClient> client, uint32_t capacityFrames)
+    : m_mixer{mixer}, m_client{client}, m_samples(capacityFrames * mixer->m_frameSize), m_capacityFrames{capacityFrames},
+      m_readFrame{0}, m_queuedFrames{0}, m_volume{1.0}, m_isPlaying{false}, m_isEos{false}, m_isEosNotified{false},
+      m_underrunPeriods{0}, m_eosFrame{0}
+{
+}
+
+WebAudioMixerInput::~WebAudioMixerInput()
+{
+    m_mixer->removeInput(this);
+}
+
+bool WebAudioMixerInput::play()
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    m_isPlaying = true;
+    m_underrunPeriods = 0;
+    m_pendingStates.push_back(WebAudioPlayerState::PLAYING);
+    m_mixer->startMixing();
+    return true;
+}
+
+bool WebAudioMixerInput::pause()
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    m_isPlaying = false;
+    m_pendingStates.push_back(WebAudioPlayerState::PAUSED);
+    m_mixer->startMixing();
+    return true;
+}
+
+bool WebAudioMixerInput::setEos()
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    m_isEos = true;
+    if (0 == m_queuedFrames)
+    {
+        // The last frame of the input is in what the mixer has written so far
+        m_eosFrame = m_mixer->m_framesWritten;
+    }
+    m_mixer->startMixing();
+    return true;
+}
+
+bool WebAudioMixerInput::getBufferAvailable(uint32_t &availableFrames, std::shared_ptr<WebAudioShmInfo> &webAudioShmInfo)
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    availableFrames = m_capacityFrames - m_queuedFrames;
+    return true;
+}
+
+bool WebAudioMixerInput::getBufferDelay(uint32_t &delayFrames)
+{
+    uint32_t serverDelayFrames = 0;
+    if (!m_mixer->m_player->getBufferDelay(serverDelayFrames))
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    delayFrames = m_queuedFrames + serverDelayFrames;
+    return true;
+}
+
+bool WebAudioMixerInput::writeBuffer(const uint32_t numberOfFrames, void *data)
+{
+    const uint32_t kFrameSize = m_mixer->m_frameSize;
+    const uint8_t *source = static_cast<const uint8_t *>(data);
+
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    if (numberOfFrames > m_capacityFrames - m_queuedFrames)
+    {
+        GST_ERROR("Not enough space in the mixer input for %u frames", numberOfFrames);
+        return false;
+    }
+
+    const uint32_t kWriteFrame = (m_readFrame + m_queuedFrames) % m_capacityFrames;
+    const uint32_t kFirstFrames = std::min(numberOfFrames, m_capacityFrames - kWriteFrame);
+    std::memcpy(m_samples.data() + kWriteFrame * kFrameSize, source, kFirstFrames * kFrameSize);
+    std::memcpy(m_samples.data(), source + kFirstFrames * kFrameSize, (numberOfFrames - kFirstFrames) * kFrameSize);
+    m_queuedFrames += numberOfFrames;
+
+    if (m_isEosNotified)
+    {
+        // New stream after the previous one has ended
+        m_isEos = false;
+        m_isEosNotified = false;
+    }
+    return true;
+}
+
+bool WebAudioMixerInput::getDeviceInfo(uint32_t &preferredFrames, uint32_t &maximumFrames, bool &supportDeferredPlay)
+{
+    preferredFrames = m_mixer->m_preferredFrames;
+    maximumFrames = m_capacityFrames;
+    // The input only starts contributing to the mix once the data lands
+    supportDeferredPlay = true;
+    return true;
+}
+
+bool WebAudioMixerInput::setVolume(double volume)
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    m_volume = volume;
+    return true;
+}
+
+bool WebAudioMixerInput::getVolume(double &volume)
+{
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    volume = m_volume;
+    return true;
+}
+
+std::weak_ptr<IWebAudioPlayerClient> WebAudioMixerInput::getClient()
+{
+    return m_client;
+}
+
+WebAudioMixer::WebAudioMixer(const std::shared_ptr<ITimerFactory> &timerFactory, const std::string &audioMimeType,
+                             uint32_t priority, const WebAudioConfig &config)
+    : m_timerFactory{timerFactory}, m_audioMimeType{audioMimeType}, m_priority{priority}, m_config{config},
+      m_frameSize{(config.pcm.sampleSize * config.pcm.channels) / CHAR_BIT}, m_player{nullptr}, m_preferredFrames{0},
+      m_maximumFrames{0}, m_inputCapacityFrames{0}, m_isPlayerPlaying{false}, m_framesWritten{0}
+{
+}
+
+WebAudioMixer::~WebAudioMixer()
+{
+    m_mixTimer.reset();
+    m_player.reset();
+}
+
+bool WebAudioMixer::isEnabled()
+{
+    const char *kSharedMixerStr = getenv("RIALTO_WEB_AUDIO_SHARED_MIXER");
+    return kSharedMixerStr && std::string(kSharedMixerStr) != "0";
+}
+
+bool WebAudioMixer::isSupported(const std::string &audioMimeType, const WebAudioConfig *config)
+{
+    return audioMimeType == kPcmMimeType && config && config->pcm.channels > 0 &&
+           (isS16le(config->pcm) || isF32le(config->pcm));
+}
+
+std::shared_ptr<WebAudioMixer> WebAudioMixer::getMixer(const std::string &audioMimeType, uint32_t priority,
+                                                       const WebAudioConfig &config)
+{
+    const std::string kKey{getMixerKey(audioMimeType, priority, config.pcm)};
+    std::unique_lock<std::mutex> lock(m_mixersMutex);
+    auto it = m_mixers.find(kKey);
+    if (it != m_mixers.end())
+    {
+        std::shared_ptr<WebAudioMixer> mixer = it->second.lock();
+        if (mixer)
+        {
+            return mixer;
+        }
+    }
+
+    std::shared_ptr<WebAudioMixer> mixer =
+        std::make_shared<WebAudioMixer>(ITimerFactory::getFactory(), audioMimeType, priority, config);
+    if (!mixer->init())
+    {
+        return nullptr;
+    }
+    m_mixers[kKey] = mixer;
+    return mixer;
+}
+
+bool WebAudioMixer::init()
+{
+    m_player = IWebAudioPlayerFactory::createFactory()->createWebAudioPlayer(weak_from_this(), m_audioMimeType,
+                                                                             m_priority, &m_config);
+    if (!m_player)
+    {
+        GST_ERROR("Could not create the shared web audio player");
+        return false;
+    }
+
+    bool supportDeferredPlay = false;
+    if (!m_player->getDeviceInfo(m_preferredFrames, m_maximumFrames, supportDeferredPlay))
+    {
+        GST_WARNING("GetDeviceInfo failed for the shared web audio player");
+    }
+
+    m_inputCapacityFrames =
+        std::max({m_config.pcm.rate * kInputBufferDurationMs / 1000, 2 * m_preferredFrames, m_maximumFrames, 1u});
+    m_mixedSamples.resize(m_inputCapacityFrames * m_config.pcm.channels);
+    m_outputSamples.resize(m_inputCapacityFrames * m_frameSize);
+    return true;
+}
+
+std::unique_ptr<IWebAudioPlayer> WebAudioMixer::createInput(std::weak_ptr<IWebAudioPlayerClient> client)
+{
+    auto input = std::make_unique<WebAudioMixerInput>(shared_from_this(), client, m_inputCapacityFrames);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_inputs.push_back(input.get());
+    GST_INFO("Web audio mixer input added, %zu inputs", m_inputs.size());
+    return input;
+}
+
+void WebAudioMixer::removeInput(WebAudioMixerInput *input)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_inputs.erase(std::remove(m_inputs.begin(), m_inputs.end(), input), m_inputs.end());
+}
+
+void WebAudioMixer::notifyState(WebAudioPlayerState state)
+{
+    if (WebAudioPlayerState::FAILURE == state)
+    {
+        GST_ERROR("Shared web audio player failed");
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (WebAudioMixerInput *input : m_inputs)
+        {
+            input->m_pendingStates.push_back(WebAudioPlayerState::FAILURE);
+        }
+        startMixing();
+    }
+}
+
+void WebAudioMixer::startMixing()
+{
+    // Called with m_mutex held, never from the mix timer thread. A timer which cancelled itself has returned from
+    // its last mix, so replacing it does not wait for m_mutex.
+    if (!m_mixTimer || !m_mixTimer->isActive())
+    {
+        m_mixTimer = m_timerFactory->createTimer(kMixPeriod, [this]() { mix(); }, TimerType::PERIODIC);
+    }
+}
+
+bool WebAudioMixer::isIdle() const
+{
+    return !m_isPlayerPlaying && !isEosPending() &&
+           std::none_of(m_inputs.begin(), m_inputs.end(), [](const WebAudioMixerInput *input)
+                        { return input->m_isPlaying || !input->m_pendingStates.empty(); });
+}
+
+void WebAudioMixer::mix()
+{
+    // The frames of a drained input may still be queued in the server, its EOS waits for them to be played
+    uint64_t playedFrames = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (isEosPending())
+        {
+            const uint64_t kFramesWritten = m_framesWritten;
+            lock.unlock();
+            uint32_t delayFrames = 0;
+            if (!m_player->getBufferDelay(delayFrames))
+            {
+                GST_WARNING("getBufferDelay failed for the shared web audio player, EOS may be notified early");
+            }
+            playedFrames = kFramesWritten > delayFrames ? kFramesWritten - delayFrames : 0;
+        }
+    }
+
+    // The mix only takes the frames all of the playing inputs have, so that an input whose producer is a bit late
+    // is not padded with silence. An input which has underrun for longer than a period is not waited for, nor is
+    // one at EOS, as no more frames are coming.
+    std::vector<Notification> notifications;
+    bool shouldPlay = false;
+    bool isWaitingForInput = false;
+    uint32_t queuedFrames = 0;
+    uint32_t commonQueuedFrames = std::numeric_limits<uint32_t>::max();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        collectNotifications(notifications, playedFrames);
+        for (WebAudioMixerInput *input : m_inputs)
+        {
+            if (!input->m_isPlaying)
+            {
+                continue;
+            }
+            shouldPlay = true;
+            queuedFrames = std::max(queuedFrames, input->m_queuedFrames);
+            input->m_underrunPeriods =
+                (0 == input->m_queuedFrames) ? std::min(input->m_underrunPeriods + 1, kMaxUnderrunPeriods + 1) : 0;
+            if (!input->m_isEos && input->m_underrunPeriods <= kMaxUnderrunPeriods)
+            {
+                isWaitingForInput = true;
+                commonQueuedFrames = std::min(commonQueuedFrames, input->m_queuedFrames);
+            }
+        }
+    }
+    if (isWaitingForInput)
+    {
+        queuedFrames = commonQueuedFrames;
+    }
+
+    for (const auto &[client, state] : notifications)
+    {
+        std::shared_ptr<IWebAudioPlayerClient> inputClient = client.lock();
+        if (inputClient)
+        {
+            inputClient->notifyState(state);
+        }
+    }
+
+    if (shouldPlay != m_isPlayerPlaying)
+    {
+        if (shouldPlay ? m_player->play() : m_player->pause())
+        {
+            m_isPlayerPlaying = shouldPlay;
+        }
+        else
+        {
+            GST_ERROR("Failed to change the state of the shared web audio player");
+        }
+    }
+
+    {
+        // Nothing to mix nor to notify until an input is played again, which restarts the timer
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (isIdle())
+        {
+            m_mixTimer->cancel();
+            return;
+        }
+    }
+
+    if (!m_isPlayerPlaying || 0 == queuedFrames)
+    {
+        return;
+    }
+
+    uint32_t availableFrames = 0;
+    std::shared_ptr<WebAudioShmInfo> webAudioShmInfo;
+    if (!m_player->getBufferAvailable(availableFrames, webAudioShmInfo))
+    {
+        GST_ERROR("getBufferAvailable failed for the shared web audio player");
+        return;
+    }
+
+    uint32_t framesToMix = std::min({availableFrames, queuedFrames, m_inputCapacityFrames});
+    if (0 == framesToMix)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        mixInputs(framesToMix);
+    }
+
+    if (!m_player->writeBuffer(framesToMix, m_outputSamples.data()))
+    {
+        GST_ERROR("Failed to write the mixed samples");
+    }
+}
+
+bool WebAudioMixer::isEosPending() const
+{
+    return std::any_of(m_inputs.begin(), m_inputs.end(),
+                       [](const WebAudioMixerInput *input)
+                       { return input->m_isEos && !input->m_isEosNotified && 0 == input->m_queuedFrames; });
+}
+
+void WebAudioMixer::collectNotifications(std::vector<Notification> &notifications, uint64_t playedFrames)
+{
+    for (WebAudioMixerInput *input : m_inputs)
+    {
+        for (const auto &state : input->m_pendingStates)
+        {
+            notifications.emplace_back(input->m_client, state);
+        }
+        input->m_pendingStates.clear();
+
+        if (input->m_isEos && !input->m_isEosNotified && 0 == input->m_queuedFrames &&
+            playedFrames >= input->m_eosFrame)
+        {
+            input->m_isEosNotified = true;
+            notifications.emplace_back(input->m_client, WebAudioPlayerState::END_OF_STREAM);
+        }
+    }
+}
+
+uint32_t WebAudioMixer::mixInputs(uint32_t frames)
+{
+    const uint32_t kChannels = m_config.pcm.channels;
+    std::fill(m_mixedSamples.begin(), m_mixedSamples.begin() + frames * kChannels, 0.0f);
+
+    for (WebAudioMixerInput *input : m_inputs)
+    {
+        if (!input->m_isPlaying || 0 == input->m_queuedFrames)
+        {
+            continue;
+        }
+        const uint32_t kFramesToRead = std::min(frames, input->m_queuedFrames);
+        const uint32_t kFirstFrames = std::min(kFramesToRead, input->m_capacityFrames - input->m_readFrame);
+        const float kVolume = static_cast<float>(input->m_volume);
+        accumulate(input->m_samples.data() + input->m_readFrame * m_frameSize, kFirstFrames * kChannels, kVolume,
+                   m_mixedSamples.data());
+        accumulate(input->m_samples.data(), (kFramesToRead - kFirstFrames) * kChannels, kVolume,
+                   m_mixedSamples.data() + kFirstFrames * kChannels);
+        input->m_readFrame = (input->m_readFrame + kFramesToRead) % input->m_capacityFrames;
+        input->m_queuedFrames -= kFramesToRead;
+        if (input->m_isEos && 0 == input->m_queuedFrames)
+        {
+            input->m_eosFrame = m_framesWritten + frames;
+        }
+    }
+    m_framesWritten += frames;
+
+    convert(m_mixedSamples.data(), frames * kChannels, m_outputSamples.data());
+    return frames;
+}
+
+// The loops below are kept branch free so that the compiler can vectorise them.
+// Samples are little endian, as on all of the supported platforms.
+void WebAudioMixer::accumulate(const uint8_t *samples, uint32_t samplesCount, float volume, float *mixed) const
+{
+    if (m_config.pcm.isFloat)
+    {
+        for (uint32_t i = 0; i < samplesCount; ++i)
+        {
+            float sample;
+            std::memcpy(&sample, samples + i * sizeof(float), sizeof(float));
+            mixed[i] += volume * sample;
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < samplesCount; ++i)
+        {
+            int16_t sample;
+            std::memcpy(&sample, samples + i * sizeof(int16_t), sizeof(int16_t));
+            mixed[i] += volume * static_cast<float>(sample);
+        }
+    }
+}
+
+void WebAudioMixer::convert(const float *mixed, uint32_t samplesCount, uint8_t *output) const
+{
+    if (m_config.pcm.isFloat)
+    {
+        for (uint32_t i = 0; i < samplesCount; ++i)
+        {
+            const float kSample = std::min(std::max(mixed[i], -1.0f), 1.0f);
+            std::memcpy(output + i * sizeof(float), &kSample, sizeof(float));
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < samplesCount; ++i)
+        {
+            const int16_t kSample = static_cast<int16_t>(std::min(std::max(mixed[i], -32768.0f), 32767.0f));
+            std::memcpy(output + i * sizeof(int16_t), &kSample, sizeof(int16_t));
+        }
+    }
+}
+} // namespace firebolt::rialto::client
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include "ITimer.h"
+#include <IWebAudioPlayer.h>
+#include <IWebAudioPlayerClient.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace firebolt::rialto::client
+{
+class WebAudioMixer;
+
+/**
+ * @brief One sink's input of the shared mixer.
+ *
+ * Implements IWebAudioPlayer so that the web audio backend can use it in place of a server player.
+ * The written frames are queued locally and mixed into the shared stream; play, pause and EOS
+ * only apply to this input and are reported to its own client.
+ */
+class WebAudioMixerInput : public IWebAudioPlayer
+{
+    friend class WebAudioMixer;
+
+public:
+    WebAudioMixerInput(const std::shared_ptr<WebAudioMixer> &mixer, std::weak_ptr<IWebAudioPlayerClient> client,
+                       uint32_t capacityFrames);
+    ~WebAudioMixerInput() override;
+
+    bool play() override;
+    bool pause() override;
+    bool setEos() override;
+    bool getBufferAvailable(uint32_t &availableFrames, std::shared_ptr<WebAudioShmInfo> &webAudioShmInfo) override;
+    bool getBufferDelay(uint32_t &delayFrames) override;
+    bool writeBuffer(const uint32_t numberOfFrames, void *data) override;
+    bool getDeviceInfo(uint32_t &preferredFrames, uint32_t &maximumFrames, bool &supportDeferredPlay) override;
+    bool setVolume(double volume) override;
+    bool getVolume(double &volume) override;
+    std::weak_ptr<IWebAudioPlayerClient> getClient() override;
+
+private:
+    std::shared_ptr<WebAudioMixer> m_mixer;
+    std::weak_ptr<IWebAudioPlayerClient> m_client;
+    std::vector<uint8_t> m_samples;
+    uint32_t m_capacityFrames;
+    uint32_t m_readFrame;
+    uint32_t m_queuedFrames;
+    double m_volume;
+    bool m_isPlaying;
+    bool m_isEos;
+    bool m_isEosNotified;
+    /**
+     * @brief The number of consecutive mix periods the playing input had no frames queued. The mix waits for the
+     *        input during one period, then pads it with silence.
+     */
+    uint32_t m_underrunPeriods;
+    /**
+     * @brief The number of frames written by the mixer once the last frame of the input was mixed, set when EOS is
+     *        set and the input is drained. EOS is notified once the server has played that many frames.
+     */
+    uint64_t m_eosFrame;
+    std::vector<WebAudioPlayerState> m_pendingStates;
+};
+
+/**
+ * @brief Mixes the pcm of the web audio sinks sharing a config into one server stream.
+ *
+ * Opt-in with the RIALTO_WEB_AUDIO_SHARED_MIXER environment variable. Only S16LE and F32LE are mixed,
+ * other formats keep a server player per sink.
+ */
+class WebAudioMixer : public IWebAudioPlayerClient, public std::enable_shared_from_this<WebAudioMixer>
+{
+    friend class WebAudioMixerInput;
+
+public:
+    WebAudioMixer(const std::shared_ptr<ITimerFactory> &timerFactory, const std::string &audioMimeType,
+                  uint32_t priority, const WebAudioConfig &config);
+    ~WebAudioMixer() override;
+
+    static bool isEnabled();
+    static bool isSupported(const std::string &audioMimeType, const WebAudioConfig *config);
+
+    /**
+     * @brief Gets the mixer shared by the sinks with the given config, creating it if needed.
+     *
+     * @retval the mixer or null on error.
+     */
+    static std::shared_ptr<WebAudioMixer> getMixer(const std::string &audioMimeType, uint32_t priority,
+                                                   const WebAudioConfig &config);
+
+    /**
+     * @brief Creates the server player. Mixing starts once an input is played.
+     *
+     * @retval true on success.
+     */
+    bool init();
+
+    std::unique_ptr<IWebAudioPlayer> createInput(std::weak_ptr<IWebAudioPlayerClient> client);
+
+    void notifyState(WebAudioPlayerState state) override;
+
+    /**
+     * @brief Mixes the queued input frames into the server stream. Called periodically from the mixer timer.
+     */
+    void mix();
+
+private:
+    using Notification = std::pair<std::weak_ptr<IWebAudioPlayerClient>, WebAudioPlayerState>;
+
+    void removeInput(WebAudioMixerInput *input);
+    void startMixing();
+    bool isIdle() const;
+    bool isEosPending() const;
+    void collectNotifications(std::vector<Notification> &notifications, uint64_t playedFrames);
+    uint32_t mixInputs(uint32_t frames);
+    void accumulate(const uint8_t *samples, uint32_t samplesCount, float volume, float *mixed) const;
+    void convert(const float *mixed, uint32_t samplesCount, uint8_t *output) const;
+
+    std::shared_ptr<ITimerFactory> m_timerFactory;
+    const std::string m_audioMimeType;
+    const uint32_t m_priority;
+    const WebAudioConfig m_config;
+    const uint32_t m_frameSize;
+    std::unique_ptr<IWebAudioPlayer> m_player;
+    uint32_t m_preferredFrames;
+    uint32_t m_maximumFrames;
+    uint32_t m_inputCapacityFrames;
+    bool m_isPlayerPlaying;
+    uint64_t m_framesWritten;
+    std::mutex m_mutex;
+    std::vector<WebAudioMixerInput *> m_inputs;
+    std::vector<float> m_mixedSamples;
+    std::vector<uint8_t> m_outputSamples;
+    std::unique_ptr<ITimer> m_mixTimer;
+
+    static std::mutex m_mixersMutex;
+    static std::map<std::string, std::weak_ptr<WebAudioMixer>> m_mixers;
+};
+} // namespace firebolt::rialto::client
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "WebAudioPlayerPool.h"
+#include <gst/gst.h>
+#include <iterator>
+
+namespace
+{
+const std::string kPcmMimeType{"audio/x-raw"};
+constexpr std::size_t kMaxIdlePlayers{2};
+constexpr std::chrono::milliseconds kIdleTimeout{5000};
+
+bool isSamePcmConfig(const firebolt::rialto::WebAudioPcmConfig &lhs, const firebolt::rialto::WebAudioPcmConfig &rhs)
+{
+    return lhs.rate == rhs.rate && lhs.channels == rhs.channels && lhs.sampleSize == rhs.sampleSize &&
+           lhs.isBigEndian == rhs.isBigEndian && lhs.isSigned == rhs.isSigned && lhs.isFloat == rhs.isFloat;
+}
+} // namespace
+
+namespace firebolt::rialto::client
+{
+WebAudioPlayerClientProxy::WebAudioPlayerClientProxy(std::weak_ptr<IWebAudioPlayerClient> client) : m_client{client} {}
+
+void WebAudioPlayerClientProxy::setClient(std::weak_ptr<IWebAudioPlayerClient> client)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_client = client;
+}
+
+void WebAudioPlayerClientProxy::notifyState(WebAudioPlayerState state)
+{
+    std::shared_ptr<IWebAudioPlayerClient> client;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        client = m_client.lock();
+    }
+    if (client)
+    {
+        client->notifyState(state);
+    }
+}
+
+WebAudioPlayerPool::WebAudioPlayerPool(const std::shared_ptr<ITimerFactory> &timerFactory, std::size_t maxIdlePlayers,
+                                       std::chrono::milliseconds idleTimeout)
+    : m_timerFactory{timerFactory}, m_maxIdlePlayers{maxIdlePlayers}, m_idleTimeout{idleTimeout}
+{
+}
+
+WebAudioPlayerPool::~WebAudioPlayerPool()
+{
+    clear();
+}
+
+std::shared_ptr<WebAudioPlayerPool> WebAudioPlayerPool::instance()
+{
+    static std::shared_ptr<WebAudioPlayerPool> pool{
+        std::make_shared<WebAudioPlayerPool>(ITimerFactory::getFactory(), kMaxIdlePlayers, kIdleTimeout)};
+    return pool;
+}
+
+std::unique_ptr<IWebAudioPlayer> WebAudioPlayerPool::acquire(std::weak_ptr<IWebAudioPlayerClient> client,
+                                                             const std::string &audioMimeType, uint32_t priority,
+                                                             const WebAudioConfig *config)
+{
+    const bool isPoolable = (audioMimeType == kPcmMimeType) && config;
+    std::unique_ptr<IWebAudioPlayer> player;
+    std::list<IdlePlayer> expired;
+    std::unique_ptr<ITimer> expiryTimer;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        removeExpired(expired);
+        if (isPoolable)
+        {
+            for (auto it = m_idlePlayers.begin(); it != m_idlePlayers.end(); ++it)
+            {
+                if (it->info.audioMimeType == audioMimeType && it->info.priority == priority &&
+                    isSamePcmConfig(it->info.config.pcm, config->pcm))
+                {
+                    it->info.clientProxy->setClient(client);
+                    player = std::move(it->player);
+                    m_acquiredPlayers.emplace(player.get(), std::move(it->info));
+                    m_idlePlayers.erase(it);
+                    break;
+                }
+            }
+        }
+        if (m_idlePlayers.empty())
+        {
+            expiryTimer = std::move(m_expiryTimer);
+        }
+    }
+
+    if (player)
+    {
+        GST_INFO("Reusing an idle web audio player");
+        // The previous owner may have changed the volume, and a new owner only sets it when it is not the default
+        if (!player->setVolume(1.0))
+        {
+            GST_WARNING("Failed to reset the volume of the reused web audio player");
+        }
+        return player;
+    }
+
+    std::shared_ptr<WebAudioPlayerClientProxy> clientProxy{std::make_shared<WebAudioPlayerClientProxy>(client)};
+    player = IWebAudioPlayerFactory::createFactory()->createWebAudioPlayer(clientProxy, audioMimeType, priority, config);
+    if (!player)
+    {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_acquiredPlayers.emplace(player.get(), PlayerInfo{clientProxy, audioMimeType, priority, isPoolable,
+                                                       config ? *config : WebAudioConfig{}});
+    return player;
+}
+
+void WebAudioPlayerPool::release(std::unique_ptr<IWebAudioPlayer> &&player)
+{
+    std::unique_ptr<IWebAudioPlayer> releasedPlayer{std::move(player)};
+    std::list<IdlePlayer> removed;
+    std::unique_ptr<ITimer> cancelledTimer;
+    if (!releasedPlayer)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_acquiredPlayers.find(releasedPlayer.get());
+    if (it == m_acquiredPlayers.end())
+    {
+        GST_WARNING("Released web audio player does not belong to the pool");
+        return;
+    }
+    if (!it->second.isPoolable || 0 == m_maxIdlePlayers)
+    {
+        m_acquiredPlayers.erase(it);
+        return;
+    }
+
+    it->second.clientProxy->setClient(std::weak_ptr<IWebAudioPlayerClient>{});
+    m_idlePlayers.push_front(
+        IdlePlayer{std::move(releasedPlayer), std::move(it->second), std::chrono::steady_clock::now()});
+    m_acquiredPlayers.erase(it);
+
+    removeExpired(removed);
+    while (m_idlePlayers.size() > m_maxIdlePlayers)
+    {
+        // Drop the least recently used player
+        removed.splice(removed.end(), m_idlePlayers, std::prev(m_idlePlayers.end()));
+    }
+
+    if (m_expiryTimer && !m_expiryTimer->isActive())
+    {
+        // Cancelled by the expiry callback when the pool ran empty, it is destroyed once the lock is released
+        cancelledTimer = std::move(m_expiryTimer);
+    }
+    if (!m_expiryTimer && m_timerFactory)
+    {
+        m_expiryTimer =
+            m_timerFactory->createTimer(m_idleTimeout, [this]() { onExpiryTimer(); }, TimerType::PERIODIC);
+    }
+    lock.unlock();
+}
+
+void WebAudioPlayerPool::destroy(std::unique_ptr<IWebAudioPlayer> &&player)
+{
+    std::unique_ptr<IWebAudioPlayer> destroyedPlayer{std::move(player)};
+    if (!destroyedPlayer)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_acquiredPlayers.erase(destroyedPlayer.get());
+    lock.unlock();
+}
+
+std::size_t WebAudioPlayerPool::getIdlePlayersCount() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_idlePlayers.size();
+}
+
+void WebAudioPlayerPool::clear()
+{
+    std::list<IdlePlayer> removed;
+    std::unique_ptr<ITimer> expiryTimer;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        removed.swap(m_idlePlayers);
+        expiryTimer = std::move(m_expiryTimer);
+    }
+}
+
+void WebAudioPlayerPool::removeExpired(std::list<IdlePlayer> &expired)
+{
+    const auto now = std::chrono::steady_clock::now();
+    while (!m_idlePlayers.empty() && now - m_idlePlayers.back().idleSince >= m_idleTimeout)
+    {
+        GST_INFO("Destroying a web audio player left idle for too long");
+        expired.splice(expired.end(), m_idlePlayers, std::prev(m_idlePlayers.end()));
+    }
+}
+
+void WebAudioPlayerPool::onExpiryTimer()
+{
+    std::list<IdlePlayer> expired;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    removeExpired(expired);
+    if (m_idlePlayers.empty() && m_expiryTimer)
+    {
+        // Nothing is left to expire. The timer cannot be destroyed from its own callback, so it is only cancelled.
+        m_expiryTimer->cancel();
+    }
+    lock.unlock();
+}
+} // namespace firebolt::rialto::client
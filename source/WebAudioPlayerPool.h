@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include "ITimer.h"
+#include <IWebAudioPlayer.h>
+#include <IWebAudioPlayerClient.h>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace firebolt::rialto::client
+{
+/**
+ * @brief Forwards the notifications of a pooled web audio player to its current owner.
+ */
+class WebAudioPlayerClientProxy : public IWebAudioPlayerClient
+{
+public:
+    explicit WebAudioPlayerClientProxy(std::weak_ptr<IWebAudioPlayerClient> client);
+
+    void setClient(std::weak_ptr<IWebAudioPlayerClient> client);
+    void notifyState(WebAudioPlayerState state) override;
+
+private:
+    std::mutex m_mutex;
+    std::weak_ptr<IWebAudioPlayerClient> m_client;
+};
+
+/**
+ * @brief Per-process pool of idle web audio players.
+ *
+ * Players released by a sink are kept for a while, keyed by mime type, priority and pcm config,
+ * so that the next sink opening the same config does not pay for the server side creation.
+ * The pool keeps at most maxIdlePlayers, dropping the least recently used, and destroys
+ * the players left idle for longer than idleTimeout.
+ */
+class WebAudioPlayerPool
+{
+public:
+    WebAudioPlayerPool(const std::shared_ptr<ITimerFactory> &timerFactory, std::size_t maxIdlePlayers,
+                       std::chrono::milliseconds idleTimeout);
+    ~WebAudioPlayerPool();
+
+    WebAudioPlayerPool(const WebAudioPlayerPool &) = delete;
+    WebAudioPlayerPool &operator=(const WebAudioPlayerPool &) = delete;
+
+    static std::shared_ptr<WebAudioPlayerPool> instance();
+
+    /**
+     * @brief Takes a matching idle player from the pool or creates a new one.
+     *
+     * @retval the player or null on error.
+     */
+    std::unique_ptr<IWebAudioPlayer> acquire(std::weak_ptr<IWebAudioPlayerClient> client,
+                                             const std::string &audioMimeType, uint32_t priority,
+                                             const WebAudioConfig *config);
+
+    /**
+     * @brief Returns an acquired player to the pool. The player must be paused with no data queued.
+     */
+    void release(std::unique_ptr<IWebAudioPlayer> &&player);
+
+    /**
+     * @brief Destroys an acquired player without keeping it for reuse.
+     */
+    void destroy(std::unique_ptr<IWebAudioPlayer> &&player);
+
+    std::size_t getIdlePlayersCount() const;
+
+    /**
+     * @brief Destroys all of the idle players.
+     */
+    void clear();
+
+private:
+    struct PlayerInfo
+    {
+        std::shared_ptr<WebAudioPlayerClientProxy> clientProxy;
+        std::string audioMimeType;
+        uint32_t priority;
+        bool isPoolable;
+        WebAudioConfig config;
+    };
+
+    struct IdlePlayer
+    {
+        std::unique_ptr<IWebAudioPlayer> player;
+        PlayerInfo info;
+        std::chrono::steady_clock::time_point idleSince;
+    };
+
+    void removeExpired(std::list<IdlePlayer> &expired);
+    void onExpiryTimer();
+
+    std::shared_ptr<ITimerFactory> m_timerFactory;
+    const std::size_t m_maxIdlePlayers;
+    const std::chrono::milliseconds m_idleTimeout;
+    mutable std::mutex m_mutex;
+    std::list<IdlePlayer> m_idlePlayers;
+    std::map<const IWebAudioPlayer *, PlayerInfo> m_acquiredPlayers;
+    std::unique_ptr<ITimer> m_expiryTimer;
+};
+} // namespace firebolt::rialto::client
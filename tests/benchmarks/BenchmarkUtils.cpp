@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BenchmarkUtils.h"
+#include "ControlMock.h"
+#include "MediaPipelineCapabilitiesMock.h"
+#include "RialtoGStreamerEMEProtectionMetadata.h"
+#include "RialtoGStreamerMSEAudioSink.h"
+#include <gst/base/gstbytewriter.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using firebolt::rialto::ApplicationState;
+using firebolt::rialto::ControlFactoryMock;
+using firebolt::rialto::ControlMock;
+using firebolt::rialto::IControlFactory;
+using firebolt::rialto::IMediaPipelineCapabilities;
+using firebolt::rialto::IMediaPipelineCapabilitiesFactory;
+using firebolt::rialto::MediaPipelineCapabilitiesFactoryMock;
+using firebolt::rialto::MediaPipelineCapabilitiesMock;
+using testing::_;
+using testing::AnyNumber;
+using testing::DoAll;
+using testing::NiceMock;
+using testing::Return;
+using testing::SetArgReferee;
+using testing::StrictMock;
+
+namespace
+{
+constexpr int kMksId{1};
+constexpr uint16_t kClearBytes{16};
+const std::vector<uint8_t> kKeyId(16, 0xab);
+const std::vector<uint8_t> kInitVector(16, 0xcd);
+const std::vector<std::string> kSupportedMimeTypes{"audio/mp4", "audio/aac", "video/h264", "video/h265"};
+
+std::shared_ptr<StrictMock<ControlMock>> gControlMock;
+
+GstBuffer *createBufferWithData(const std::vector<uint8_t> &data)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, data.size(), nullptr);
+    gst_buffer_fill(buffer, 0, data.data(), data.size());
+    return buffer;
+}
+} // namespace
+
+void initialiseBenchmarks()
+{
+    std::shared_ptr<StrictMock<MediaPipelineCapabilitiesFactoryMock>> capabilitiesFactoryMock{
+        std::dynamic_pointer_cast<StrictMock<MediaPipelineCapabilitiesFactoryMock>>(
+            IMediaPipelineCapabilitiesFactory::createFactory())};
+    EXPECT_CALL(*capabilitiesFactoryMock, createMediaPipelineCapabilities())
+        .Times(AnyNumber())
+        .WillRepeatedly(
+            []() -> std::unique_ptr<IMediaPipelineCapabilities>
+            {
+                auto capabilitiesMock{std::make_unique<NiceMock<MediaPipelineCapabilitiesMock>>()};
+                ON_CALL(*capabilitiesMock, getSupportedMimeTypes(_)).WillByDefault(Return(kSupportedMimeTypes));
+                return capabilitiesMock;
+            });
+
+    gControlMock = std::make_shared<StrictMock<ControlMock>>();
+    EXPECT_CALL(*gControlMock, registerClient(_, _))
+        .Times(AnyNumber())
+        .WillRepeatedly(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    std::shared_ptr<StrictMock<ControlFactoryMock>> controlFactoryMock{
+        std::dynamic_pointer_cast<StrictMock<ControlFactoryMock>>(IControlFactory::createFactory())};
+    EXPECT_CALL(*controlFactoryMock, createControl()).Times(AnyNumber()).WillRepeatedly(Return(gControlMock));
+
+    gst_init(nullptr, nullptr);
+}
+
+GstBuffer *createMediaBuffer(size_t size, unsigned int subsampleCount)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, size, nullptr);
+    gst_buffer_memset(buffer, 0, 0x5a, size);
+    GST_BUFFER_PTS(buffer) = 40 * GST_MSECOND;
+    GST_BUFFER_DURATION(buffer) = 20 * GST_MSECOND;
+    if (subsampleCount == 0)
+    {
+        return buffer;
+    }
+
+    // Each subsample is the clear bytes (16 bits) and the encrypted bytes (32 bits), big endian
+    const uint32_t kEncryptedBytes = static_cast<uint32_t>(size / subsampleCount) - kClearBytes;
+    GstByteWriter *byteWriter = gst_byte_writer_new_with_size(subsampleCount * 6, TRUE);
+    for (unsigned int i = 0; i < subsampleCount; ++i)
+    {
+        gst_byte_writer_put_uint16_be(byteWriter, kClearBytes);
+        gst_byte_writer_put_uint32_be(byteWriter, kEncryptedBytes);
+    }
+    GstBuffer *subsamplesBuffer = gst_byte_writer_free_and_get_buffer(byteWriter);
+    GstBuffer *keyIdBuffer = createBufferWithData(kKeyId);
+    GstBuffer *initVectorBuffer = createBufferWithData(kInitVector);
+
+    GstStructure *info = gst_structure_new("application/x-cenc", "encrypted", G_TYPE_BOOLEAN, TRUE, "mks_id",
+                                           G_TYPE_INT, kMksId, "kid", GST_TYPE_BUFFER, keyIdBuffer, "iv",
+                                           GST_TYPE_BUFFER, initVectorBuffer, "iv_size", G_TYPE_UINT,
+                                           kInitVector.size(), "subsample_count", G_TYPE_UINT, subsampleCount,
+                                           "subsamples", GST_TYPE_BUFFER, subsamplesBuffer, NULL);
+    rialto_mse_add_protection_metadata(buffer, info);
+
+    gst_buffer_unref(subsamplesBuffer);
+    gst_buffer_unref(initVectorBuffer);
+    gst_buffer_unref(keyIdBuffer);
+    return buffer;
+}
+
+RialtoMSEBaseSink *createAudioSink()
+{
+    return RIALTO_MSE_BASE_SINK(g_object_new(RIALTO_TYPE_MSE_AUDIO_SINK, nullptr));
+}
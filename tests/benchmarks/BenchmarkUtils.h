@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include "RialtoGStreamerMSEBaseSink.h"
+#include <cstddef>
+#include <gst/gst.h>
+
+/**
+ * @brief Initialises gstreamer and the third-party stubs behind the sinks. Called once, before the benchmarks.
+ */
+void initialiseBenchmarks();
+
+/**
+ * @brief Creates a media buffer with a pts and a duration.
+ *
+ * @param[in] size           : The size of the buffer
+ * @param[in] subsampleCount : The number of subsamples of the protection metadata, 0 for a clear buffer
+ *
+ * @retval the new buffer.
+ */
+GstBuffer *createMediaBuffer(size_t size, unsigned int subsampleCount);
+
+/**
+ * @brief Creates an MSE audio sink, not attached to a pipeline.
+ *
+ * @retval the new sink.
+ */
+RialtoMSEBaseSink *createAudioSink();
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BenchmarkUtils.h"
+#include "BufferParser.h"
+#include <benchmark/benchmark.h>
+#include <gst/gst.h>
+
+namespace
+{
+constexpr int kStreamId{1};
+constexpr size_t kAudioBufferSize{768};
+constexpr size_t kVideoBufferSize{64 * 1024};
+constexpr unsigned int kSubsampleCount{8};
+
+GstCaps *createAudioCaps(bool isEncrypted)
+{
+    return gst_caps_new_simple(isEncrypted ? "application/x-cenc" : "audio/mpeg", "rate", G_TYPE_INT, 48000,
+                               "channels", G_TYPE_INT, 2, nullptr);
+}
+
+GstCaps *createVideoCaps(bool isEncrypted)
+{
+    return gst_caps_new_simple(isEncrypted ? "application/x-cenc" : "video/x-h264", "width", G_TYPE_INT, 1920,
+                               "height", G_TYPE_INT, 1080, "framerate", GST_TYPE_FRACTION, 25, 1, nullptr);
+}
+
+void parseBuffers(benchmark::State &state, BufferParser &parser, GstCaps *caps, size_t bufferSize,
+                  unsigned int subsampleCount)
+{
+    GstBuffer *buffer = createMediaBuffer(bufferSize, subsampleCount);
+    GstMapInfo map;
+    gst_buffer_map(buffer, &map, GST_MAP_READ);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parser.parseBuffer(caps, buffer, map, kStreamId));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bufferSize);
+
+    gst_buffer_unmap(buffer, &map);
+    gst_buffer_unref(buffer);
+    gst_caps_unref(caps);
+}
+} // namespace
+
+static void BM_ParseAudioBuffer(benchmark::State &state)
+{
+    const bool kIsEncrypted = state.range(0) != 0;
+    AudioBufferParser parser;
+    parseBuffers(state, parser, createAudioCaps(kIsEncrypted), kAudioBufferSize, kIsEncrypted ? kSubsampleCount : 0);
+}
+BENCHMARK(BM_ParseAudioBuffer)->ArgName("encrypted")->Arg(0)->Arg(1);
+
+static void BM_ParseVideoBuffer(benchmark::State &state)
+{
+    const bool kIsEncrypted = state.range(0) != 0;
+    VideoBufferParser parser;
+    parseBuffers(state, parser, createVideoCaps(kIsEncrypted), kVideoBufferSize, kIsEncrypted ? kSubsampleCount : 0);
+}
+BENCHMARK(BM_ParseVideoBuffer)->ArgName("encrypted")->Arg(0)->Arg(1);
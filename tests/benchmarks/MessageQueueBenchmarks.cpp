@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "IMessageQueue.h"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace
+{
+class CountMessage : public Message
+{
+public:
+    explicit CountMessage(std::atomic<uint64_t> &count) : m_count(count) {}
+    void handle() override { m_count.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> &m_count;
+};
+} // namespace
+
+static void BM_MessageQueuePostAndHandle(benchmark::State &state)
+{
+    std::unique_ptr<IMessageQueue> queue{IMessageQueueFactory::createFactory()->createMessageQueue()};
+    queue->start();
+    std::atomic<uint64_t> handledCount{0};
+
+    for (auto _ : state)
+    {
+        queue->postMessage(std::make_shared<CountMessage>(handledCount));
+    }
+    // Wait for the posted messages to be handled, so that their cost is included
+    queue->callInEventLoop([]() {});
+    state.counters["handled"] = static_cast<double>(handledCount.load());
+
+    queue->stop();
+}
+BENCHMARK(BM_MessageQueuePostAndHandle);
+
+static void BM_MessageQueueCallInEventLoop(benchmark::State &state)
+{
+    std::unique_ptr<IMessageQueue> queue{IMessageQueueFactory::createFactory()->createMessageQueue()};
+    queue->start();
+    uint64_t count{0};
+
+    for (auto _ : state)
+    {
+        queue->callInEventLoop([&count]() { ++count; });
+    }
+    benchmark::DoNotOptimize(count);
+
+    queue->stop();
+}
+BENCHMARK(BM_MessageQueueCallInEventLoop)->UseRealTime();
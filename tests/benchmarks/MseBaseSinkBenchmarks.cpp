@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BenchmarkUtils.h"
+#include "RialtoGStreamerMSEBaseSinkPrivate.h"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+#include <thread>
+
+namespace
+{
+long getVoluntaryContextSwitches()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw;
+}
+} // namespace
+
+static void BM_ChainGetFrontAndPopSample(benchmark::State &state)
+{
+    RialtoMSEBaseSink *sink = createAudioSink();
+    GstBuffer *buffer = createMediaBuffer(static_cast<size_t>(state.range(0)), 0);
+
+    for (auto _ : state)
+    {
+        // The chain function takes the ownership of the buffer
+        rialto_mse_base_sink_chain(sink->priv->m_sinkPad, GST_OBJECT_CAST(sink), gst_buffer_ref(buffer));
+        GstBuffer *frontBuffer = nullptr;
+        GstCaps *frontCaps = nullptr;
+        benchmark::DoNotOptimize(rialto_mse_base_sink_get_front_sample(sink, &frontBuffer, &frontCaps));
+        rialto_mse_base_sink_pop_sample(sink);
+    }
+
+    gst_buffer_unref(buffer);
+    gst_object_unref(sink);
+}
+BENCHMARK(BM_ChainGetFrontAndPopSample)->ArgName("bytes")->Arg(768)->Arg(64 * 1024);
+
+// The producer keeps the queue full, so that the chain function blocks at the high watermark like during playback
+static void BM_ChainWakeupsWithFullQueue(benchmark::State &state)
+{
+    RialtoMSEBaseSink *sink = createAudioSink();
+    g_object_set(sink, "queue-low-watermark", static_cast<guint>(state.range(0)), nullptr);
+    GstBuffer *buffer = createMediaBuffer(768, 0);
+
+    std::atomic<bool> isRunning{true};
+    std::thread producer{[&]()
+                         {
+                             while (isRunning)
+                             {
+                                 rialto_mse_base_sink_chain(sink->priv->m_sinkPad, GST_OBJECT_CAST(sink),
+                                                            gst_buffer_ref(buffer));
+                             }
+                         }};
+
+    const long kContextSwitchesStart = getVoluntaryContextSwitches();
+    for (auto _ : state)
+    {
+        GstBuffer *frontBuffer = nullptr;
+        GstCaps *frontCaps = nullptr;
+        while (!rialto_mse_base_sink_get_front_sample(sink, &frontBuffer, &frontCaps))
+        {
+            std::this_thread::yield();
+        }
+        rialto_mse_base_sink_pop_sample(sink);
+    }
+    state.counters["context-switches"] =
+        benchmark::Counter(static_cast<double>(getVoluntaryContextSwitches() - kContextSwitchesStart),
+                           benchmark::Counter::kIsRate);
+
+    isRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(sink->priv->m_sinkMutex);
+        sink->priv->clearBuffersUnlocked();
+    }
+    producer.join();
+
+    gst_buffer_unref(buffer);
+    gst_object_unref(sink);
+}
+// A low watermark one below the high one wakes the chain function after every popped sample
+BENCHMARK(BM_ChainWakeupsWithFullQueue)
+    ->ArgName("low-watermark")
+    ->Arg(RialtoMSEBaseSinkPrivate::kDefaultQueueHighWatermark - 1)
+    ->Arg(RialtoMSEBaseSinkPrivate::kDefaultQueueLowWatermark)
+    ->UseRealTime();
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "BenchmarkUtils.h"
+#include "GStreamerEMEUtils.h"
+#include <benchmark/benchmark.h>
+
+static void BM_ProcessProtectionMetadata(benchmark::State &state)
+{
+    const unsigned int kSubsampleCount = static_cast<unsigned int>(state.range(0));
+    GstBuffer *buffer = createMediaBuffer(64 * 1024, kSubsampleCount);
+
+    for (auto _ : state)
+    {
+        BufferProtectionMetadata metadata;
+        ProcessProtectionMetadata(buffer, metadata);
+        benchmark::DoNotOptimize(metadata);
+    }
+
+    gst_buffer_unref(buffer);
+}
+BENCHMARK(BM_ProcessProtectionMetadata)->ArgName("subsamples")->RangeMultiplier(4)->Range(1, 256);
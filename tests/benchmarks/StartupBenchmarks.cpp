@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Time to first frame and flush seek latency of appsrc ! rialto sink pipelines against the simulated
+// RialtoServer, broken down per phase. The argument of each benchmark is the IPC round trip time in us.
+// This is a separate executable, because the simulator replaces the factory stubs of the whole process.
+
+#include "RialtoGStreamerMSEAudioSink.h"
+#include "RialtoGStreamerMSEVideoSink.h"
+#include "Simulator.h"
+#include <benchmark/benchmark.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using firebolt::rialto::simulator::SimulatorEvent;
+
+constexpr std::chrono::seconds kTimeout{10};
+
+enum class Milestone
+{
+    START,
+    READY,
+    PAUSED,
+    CAPS,
+    ALL_SOURCES_ATTACHED,
+    NEED_DATA,
+    ADD_SEGMENT,
+    FLUSH_START,
+    SET_POSITION,
+    FLUSHED,
+    ASYNC_DONE,
+    COUNT
+};
+
+// First time of each milestone since the last reset, written from the streaming, bus and simulator threads
+class Milestones
+{
+public:
+    void reset()
+    {
+        for (auto &time : m_times)
+        {
+            time.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void mark(Milestone milestone)
+    {
+        int64_t expected{0};
+        m_times[static_cast<size_t>(milestone)].compare_exchange_strong(expected, now());
+        if (milestone == Milestone::ASYNC_DONE)
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_asyncDone.notify_all();
+        }
+    }
+
+    bool isMarked(Milestone milestone) const { return m_times[static_cast<size_t>(milestone)].load() != 0; }
+
+    bool waitForAsyncDone()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        return m_asyncDone.wait_for(lock, kTimeout, [this]() { return isMarked(Milestone::ASYNC_DONE); });
+    }
+
+    double getDurationUs(Milestone from, Milestone to) const
+    {
+        const int64_t kFrom{m_times[static_cast<size_t>(from)].load()};
+        const int64_t kTo{m_times[static_cast<size_t>(to)].load()};
+        return (kFrom != 0 && kTo >= kFrom) ? static_cast<double>(kTo - kFrom) / 1000 : 0.0;
+    }
+
+private:
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    std::array<std::atomic<int64_t>, static_cast<size_t>(Milestone::COUNT)> m_times{};
+    std::mutex m_mutex;
+    std::condition_variable m_asyncDone;
+};
+
+struct Stream
+{
+    const char *name;
+    const char *caps;
+    GstClockTime frameDuration;
+    size_t frameBytes;
+    uint32_t keyFrameInterval;
+};
+
+const std::vector<Stream> kStreams{{"video",
+                                    "video/x-h264, stream-format=(string)byte-stream, alignment=(string)au, "
+                                    "width=(int)1920, height=(int)1080, framerate=(fraction)30/1",
+                                    GST_SECOND / 30, 50000, 30},
+                                   {"audio", "audio/mpeg, mpegversion=(int)4, channels=(int)2, rate=(int)48000",
+                                    GST_SECOND * 1024 / 48000, 768, 1}};
+
+// Pushes frames into a seekable appsrc, restarting from the requested position after a seek
+class StreamFeeder
+{
+public:
+    StreamFeeder(GstElement *appSrc, const Stream &stream) : m_appSrc{appSrc}, m_stream{stream}
+    {
+        GstCaps *caps = gst_caps_from_string(m_stream.caps);
+        gst_app_src_set_caps(GST_APP_SRC(m_appSrc), caps);
+        gst_caps_unref(caps);
+        g_signal_connect(m_appSrc, "seek-data", G_CALLBACK(onSeekData), this);
+        m_thread = std::thread{&StreamFeeder::run, this};
+    }
+
+    ~StreamFeeder()
+    {
+        m_isRunning = false;
+        m_thread.join();
+        gst_object_unref(m_appSrc);
+    }
+
+private:
+    static gboolean onSeekData(GstAppSrc *appSrc, guint64 offset, gpointer userData)
+    {
+        StreamFeeder *self = static_cast<StreamFeeder *>(userData);
+        self->m_seekFrame = offset / self->m_stream.frameDuration;
+        self->m_isSeekPending = true;
+        return TRUE;
+    }
+
+    void run()
+    {
+        uint64_t frame{0};
+        bool isKeyFrameNeeded{false};
+        while (m_isRunning)
+        {
+            if (m_isSeekPending.exchange(false))
+            {
+                frame = m_seekFrame;
+                isKeyFrameNeeded = true;
+            }
+
+            GstBuffer *buffer = gst_buffer_new_allocate(nullptr, m_stream.frameBytes, nullptr);
+            gst_buffer_memset(buffer, 0, 0, m_stream.frameBytes);
+            GST_BUFFER_PTS(buffer) = frame * m_stream.frameDuration;
+            GST_BUFFER_DTS(buffer) = GST_BUFFER_PTS(buffer);
+            GST_BUFFER_DURATION(buffer) = m_stream.frameDuration;
+            if (frame % m_stream.keyFrameInterval != 0 && !isKeyFrameNeeded)
+            {
+                GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+            }
+
+            if (gst_app_src_push_buffer(GST_APP_SRC(m_appSrc), buffer) == GST_FLOW_OK)
+            {
+                ++frame;
+                isKeyFrameNeeded = false;
+            }
+            else
+            {
+                // Flushing for a seek or the shut down
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }
+    }
+
+    GstElement *m_appSrc;
+    const Stream m_stream;
+    std::atomic<bool> m_isRunning{true};
+    std::atomic<bool> m_isSeekPending{false};
+    std::atomic<uint64_t> m_seekFrame{0};
+    std::thread m_thread;
+};
+
+class BenchmarkPipeline
+{
+public:
+    explicit BenchmarkPipeline(Milestones &milestones) : m_milestones{milestones}
+    {
+        std::string description;
+        for (const Stream &stream : kStreams)
+        {
+            description += std::string{"appsrc name="} + stream.name +
+                           "src format=time stream-type=seekable block=true max-bytes=" +
+                           std::to_string(stream.frameBytes * 8) + " ! rialtomse" + stream.name + "sink name=" +
+                           stream.name + "sink ";
+        }
+        m_pipeline = gst_parse_launch(description.c_str(), nullptr);
+
+        GstBus *bus = gst_element_get_bus(m_pipeline);
+        gst_bus_set_sync_handler(bus, onBusMessage, &m_milestones, nullptr);
+        gst_object_unref(bus);
+
+        for (const Stream &stream : kStreams)
+        {
+            GstElement *sink = gst_bin_get_by_name(GST_BIN(m_pipeline), (std::string{stream.name} + "sink").c_str());
+            GstPad *pad = gst_element_get_static_pad(sink, "sink");
+            gst_pad_add_probe(pad,
+                              static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM |
+                                                           GST_PAD_PROBE_TYPE_EVENT_FLUSH),
+                              onSinkEvent, &m_milestones, nullptr);
+            gst_object_unref(pad);
+            gst_object_unref(sink);
+        }
+    }
+
+    ~BenchmarkPipeline()
+    {
+        gst_element_set_state(m_pipeline, GST_STATE_NULL);
+        m_feeders.clear();
+        gst_object_unref(m_pipeline);
+    }
+
+    void setState(GstState state) { gst_element_set_state(m_pipeline, state); }
+
+    void startFeeding()
+    {
+        for (const Stream &stream : kStreams)
+        {
+            m_feeders.emplace_back(std::make_unique<StreamFeeder>(
+                gst_bin_get_by_name(GST_BIN(m_pipeline), (std::string{stream.name} + "src").c_str()), stream));
+        }
+    }
+
+    bool seek(GstClockTime position)
+    {
+        return gst_element_seek_simple(m_pipeline, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, position);
+    }
+
+private:
+    static GstBusSyncReply onBusMessage(GstBus *bus, GstMessage *message, gpointer userData)
+    {
+        if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ASYNC_DONE)
+        {
+            static_cast<Milestones *>(userData)->mark(Milestone::ASYNC_DONE);
+        }
+        gst_message_unref(message);
+        return GST_BUS_DROP;
+    }
+
+    static GstPadProbeReturn onSinkEvent(GstPad *pad, GstPadProbeInfo *info, gpointer userData)
+    {
+        GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+        if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS)
+        {
+            static_cast<Milestones *>(userData)->mark(Milestone::CAPS);
+        }
+        else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_START)
+        {
+            static_cast<Milestones *>(userData)->mark(Milestone::FLUSH_START);
+        }
+        return GST_PAD_PROBE_OK;
+    }
+
+    Milestones &m_milestones;
+    GstElement *m_pipeline;
+    std::vector<std::unique_ptr<StreamFeeder>> m_feeders;
+};
+
+void observeSimulator(Milestones &milestones, const std::atomic<bool> &isSeeking)
+{
+    firebolt::rialto::simulator::setEventObserver(
+        [&milestones, &isSeeking](SimulatorEvent event)
+        {
+            switch (event)
+            {
+            case SimulatorEvent::ALL_SOURCES_ATTACHED:
+                milestones.mark(Milestone::ALL_SOURCES_ATTACHED);
+                break;
+            case SimulatorEvent::NEED_DATA:
+                milestones.mark(Milestone::NEED_DATA);
+                break;
+            case SimulatorEvent::ADD_SEGMENT:
+                // Segments of the requests sent before the seek do not count
+                if (!isSeeking || milestones.isMarked(Milestone::FLUSHED))
+                {
+                    milestones.mark(Milestone::ADD_SEGMENT);
+                }
+                break;
+            case SimulatorEvent::SET_POSITION:
+                milestones.mark(Milestone::SET_POSITION);
+                break;
+            case SimulatorEvent::FLUSHED:
+                milestones.mark(Milestone::FLUSHED);
+                break;
+            default:
+                break;
+            }
+        });
+}
+
+void setIpcDelay(int64_t ipcDelayUs)
+{
+    firebolt::rialto::simulator::SimulatorConfig config{firebolt::rialto::simulator::getConfig()};
+    config.ipcDelay = std::chrono::microseconds{ipcDelayUs};
+    firebolt::rialto::simulator::enable(config);
+}
+
+void setPhaseCounter(benchmark::State &state, const char *name, double totalUs)
+{
+    state.counters[name] = benchmark::Counter(totalUs, benchmark::Counter::kAvgIterations);
+}
+} // namespace
+
+static void BM_TimeToFirstFrame(benchmark::State &state)
+{
+    setIpcDelay(state.range(0));
+    Milestones milestones;
+    std::atomic<bool> isSeeking{false};
+    observeSimulator(milestones, isSeeking);
+
+    std::array<double, 6> totalUs{};
+    for (auto _ : state)
+    {
+        milestones.reset();
+        BenchmarkPipeline pipeline{milestones};
+
+        milestones.mark(Milestone::START);
+        pipeline.setState(GST_STATE_READY);
+        milestones.mark(Milestone::READY);
+        pipeline.startFeeding();
+        pipeline.setState(GST_STATE_PAUSED);
+        milestones.mark(Milestone::PAUSED);
+        if (!milestones.waitForAsyncDone())
+        {
+            state.SkipWithError("Preroll timed out");
+            break;
+        }
+
+        state.SetIterationTime(milestones.getDurationUs(Milestone::START, Milestone::ASYNC_DONE) / 1000000);
+        totalUs[0] += milestones.getDurationUs(Milestone::START, Milestone::READY);
+        totalUs[1] += milestones.getDurationUs(Milestone::READY, Milestone::PAUSED);
+        totalUs[2] += milestones.getDurationUs(Milestone::CAPS, Milestone::ALL_SOURCES_ATTACHED);
+        totalUs[3] += milestones.getDurationUs(Milestone::ALL_SOURCES_ATTACHED, Milestone::NEED_DATA);
+        totalUs[4] += milestones.getDurationUs(Milestone::NEED_DATA, Milestone::ADD_SEGMENT);
+        totalUs[5] += milestones.getDurationUs(Milestone::ADD_SEGMENT, Milestone::ASYNC_DONE);
+    }
+    firebolt::rialto::simulator::setEventObserver({});
+
+    setPhaseCounter(state, "null_to_ready_us", totalUs[0]);
+    setPhaseCounter(state, "ready_to_paused_us", totalUs[1]);
+    setPhaseCounter(state, "caps_to_all_sources_attached_us", totalUs[2]);
+    setPhaseCounter(state, "all_sources_attached_to_need_data_us", totalUs[3]);
+    setPhaseCounter(state, "need_data_to_add_segment_us", totalUs[4]);
+    setPhaseCounter(state, "add_segment_to_preroll_us", totalUs[5]);
+}
+BENCHMARK(BM_TimeToFirstFrame)->Arg(0)->Arg(500)->Arg(2000)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_FlushSeek(benchmark::State &state)
+{
+    setIpcDelay(state.range(0));
+    Milestones milestones;
+    std::atomic<bool> isSeeking{false};
+    observeSimulator(milestones, isSeeking);
+
+    BenchmarkPipeline pipeline{milestones};
+    pipeline.startFeeding();
+    pipeline.setState(GST_STATE_PAUSED);
+    if (!milestones.waitForAsyncDone())
+    {
+        state.SkipWithError("Preroll timed out");
+        firebolt::rialto::simulator::setEventObserver({});
+        return;
+    }
+
+    std::array<double, 5> totalUs{};
+    GstClockTime position{10 * GST_SECOND};
+    isSeeking = true;
+    for (auto _ : state)
+    {
+        milestones.reset();
+        milestones.mark(Milestone::START);
+        if (!pipeline.seek(position) || !milestones.waitForAsyncDone())
+        {
+            state.SkipWithError("Seek failed");
+            break;
+        }
+        position = (position == 10 * GST_SECOND) ? 20 * GST_SECOND : 10 * GST_SECOND;
+
+        state.SetIterationTime(milestones.getDurationUs(Milestone::START, Milestone::ASYNC_DONE) / 1000000);
+        totalUs[0] += milestones.getDurationUs(Milestone::START, Milestone::FLUSH_START);
+        totalUs[1] += milestones.getDurationUs(Milestone::FLUSH_START, Milestone::SET_POSITION);
+        totalUs[2] += milestones.getDurationUs(Milestone::SET_POSITION, Milestone::FLUSHED);
+        totalUs[3] += milestones.getDurationUs(Milestone::FLUSHED, Milestone::ADD_SEGMENT);
+        totalUs[4] += milestones.getDurationUs(Milestone::ADD_SEGMENT, Milestone::ASYNC_DONE);
+    }
+    firebolt::rialto::simulator::setEventObserver({});
+
+    setPhaseCounter(state, "seek_to_flush_start_us", totalUs[0]);
+    setPhaseCounter(state, "flush_start_to_set_position_us", totalUs[1]);
+    setPhaseCounter(state, "set_position_to_flushed_us", totalUs[2]);
+    setPhaseCounter(state, "flushed_to_add_segment_us", totalUs[3]);
+    setPhaseCounter(state, "add_segment_to_preroll_us", totalUs[4]);
+}
+BENCHMARK(BM_FlushSeek)->Arg(0)->Arg(500)->Arg(2000)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+// Use --benchmark_out=<file> --benchmark_out_format=json to keep the results for comparison
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    // The simulator must be enabled before the sinks create the first factory
+    firebolt::rialto::simulator::enable(firebolt::rialto::simulator::SimulatorConfig{});
+    gst_init(&argc, &argv);
+    gst_element_register(nullptr, "rialtomsevideosink", GST_RANK_NONE, RIALTO_TYPE_MSE_VIDEO_SINK);
+    gst_element_register(nullptr, "rialtomseaudiosink", GST_RANK_NONE, RIALTO_TYPE_MSE_AUDIO_SINK);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
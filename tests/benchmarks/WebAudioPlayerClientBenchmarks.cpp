@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GStreamerWebAudioPlayerClient.h"
+#include "MessageQueueMock.h"
+#include "TimerFactoryMock.h"
+#include "WebAudioClientBackendMock.h"
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+using firebolt::rialto::client::WebAudioClientBackendMock;
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SetArgReferee;
+
+namespace
+{
+constexpr int kRate{48000};
+constexpr int kChannels{2};
+constexpr uint32_t kFrameSize{4};
+constexpr uint32_t kAvailableFrames{16 * 1024};
+} // namespace
+
+// The backend calls are mocked, so this measures the cost of the client around them
+static void BM_WebAudioPushSamples(benchmark::State &state)
+{
+    const size_t kFramesPerBuffer = static_cast<size_t>(state.range(0));
+    auto webAudioClientBackend{std::make_unique<NiceMock<WebAudioClientBackendMock>>()};
+    auto messageQueue{std::make_unique<NiceMock<MessageQueueMock>>()};
+    ON_CALL(*webAudioClientBackend, createWebAudioBackend(_, _, _, _)).WillByDefault(Return(true));
+    ON_CALL(*webAudioClientBackend, getDeviceInfo(_, _, _)).WillByDefault(Return(true));
+    ON_CALL(*webAudioClientBackend, getBufferAvailable(_))
+        .WillByDefault(DoAll(SetArgReferee<0>(kAvailableFrames), Return(true)));
+    ON_CALL(*webAudioClientBackend, getBufferDelay(_)).WillByDefault(DoAll(SetArgReferee<0>(0), Return(true)));
+    ON_CALL(*webAudioClientBackend, writeBuffer(_, _)).WillByDefault(Return(true));
+    // Run the backend thread work inline
+    ON_CALL(*messageQueue, callInEventLoop(_))
+        .WillByDefault(Invoke(
+            [](const auto &f)
+            {
+                f();
+                return true;
+            }));
+    ON_CALL(*messageQueue, postMessage(_))
+        .WillByDefault(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+
+    auto client{std::make_shared<GStreamerWebAudioPlayerClient>(std::move(webAudioClientBackend),
+                                                                std::move(messageQueue), WebAudioSinkCallbacks{},
+                                                                std::make_shared<NiceMock<TimerFactoryMock>>())};
+    GstCaps *caps = gst_caps_new_simple("audio/x-raw", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT, kChannels,
+                                        "format", G_TYPE_STRING, "S16LE", nullptr);
+    client->open(caps);
+    gst_caps_unref(caps);
+
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kFramesPerBuffer * kFrameSize, nullptr);
+    gst_buffer_memset(buffer, 0, 0, kFramesPerBuffer * kFrameSize);
+    for (auto _ : state)
+    {
+        // The client takes the ownership of the buffer
+        client->notifyNewSample(gst_buffer_ref(buffer));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFramesPerBuffer * kFrameSize);
+
+    gst_buffer_unref(buffer);
+    client->close();
+}
+BENCHMARK(BM_WebAudioPushSamples)->ArgName("frames")->Arg(480)->Arg(4096);
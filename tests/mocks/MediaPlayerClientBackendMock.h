@@ -30,6 +30,7 @@ public:
     MOCK_METHOD(void, createMediaPlayerBackend,
                 (std::weak_ptr<IMediaPipelineClient> client, uint32_t maxWidth, uint32_t maxHeight), (override));
     MOCK_METHOD(bool, isMediaPlayerBackendCreated, (), (const, override));
+    MOCK_METHOD(void, destroyMediaPlayerBackend, (), (override));
     MOCK_METHOD(bool, attachSource, (std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> & source),
                 (override));
     MOCK_METHOD(bool, removeSource, (int32_t id), (override));
@@ -32,6 +32,7 @@ public:
                  const WebAudioConfig *config),
                 (override));
     MOCK_METHOD(void, destroyWebAudioBackend, (), (override));
+    MOCK_METHOD(void, releaseWebAudioBackend, (), (override));
     MOCK_METHOD(bool, play, (), (override));
     MOCK_METHOD(bool, pause, (), (override));
     MOCK_METHOD(bool, setEos, (), (override));
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FIREBOLT_RIALTO_SIMULATOR_SIMULATED_MEDIA_PIPELINE_H_
+#define FIREBOLT_RIALTO_SIMULATOR_SIMULATED_MEDIA_PIPELINE_H_
+
+#include "IMediaPipeline.h"
+#include "Simulator.h"
+#include <memory>
+#include <string>
+
+namespace firebolt::rialto::simulator
+{
+/**
+ * @brief A media pipeline which models the RialtoServer side of the MSE data path.
+ *
+ * Each attached source gets a shared memory partition. Need data is sent while the partition has space and
+ * less than maxBufferedTime is buffered, committed frames are consumed at the configured speed once the
+ * pipeline is playing, and a source which runs dry is reported with notifyBufferUnderflow.
+ * No media is decoded; only the timestamps, durations and sizes of the segments are kept.
+ */
+class SimulatedMediaPipeline : public IMediaPipeline
+{
+public:
+    SimulatedMediaPipeline(std::weak_ptr<IMediaPipelineClient> client, const SimulatorConfig &config,
+                           SimulatorStatistics &statistics);
+    ~SimulatedMediaPipeline() override;
+
+    std::weak_ptr<IMediaPipelineClient> getClient() override;
+    bool load(MediaType type, const std::string &mimeType, const std::string &url) override;
+    bool attachSource(const std::unique_ptr<MediaSource> &source) override;
+    bool removeSource(int32_t id) override;
+    bool allSourcesAttached() override;
+    bool play() override;
+    bool pause() override;
+    bool stop() override;
+    bool setPlaybackRate(double rate) override;
+    bool setPosition(int64_t position) override;
+    bool getPosition(int64_t &position) override;
+    bool setVideoWindow(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    bool haveData(MediaSourceStatus status, uint32_t needDataRequestId) override;
+    AddSegmentStatus addSegment(uint32_t needDataRequestId, const std::unique_ptr<MediaSegment> &mediaSegment) override;
+    bool renderFrame() override;
+    bool setVolume(double volume) override;
+    bool getVolume(double &volume) override;
+    bool setMute(bool mute) override;
+    bool getMute(bool &mute) override;
+
+private:
+    class Server;
+    std::shared_ptr<Server> m_server;
+};
+} // namespace firebolt::rialto::simulator
+
+#endif // FIREBOLT_RIALTO_SIMULATOR_SIMULATED_MEDIA_PIPELINE_H_
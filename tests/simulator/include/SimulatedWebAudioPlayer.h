@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FIREBOLT_RIALTO_SIMULATOR_SIMULATED_WEB_AUDIO_PLAYER_H_
+#define FIREBOLT_RIALTO_SIMULATOR_SIMULATED_WEB_AUDIO_PLAYER_H_
+
+#include "IWebAudioPlayer.h"
+#include "Simulator.h"
+#include <memory>
+#include <string>
+
+namespace firebolt::rialto::simulator
+{
+/**
+ * @brief A web audio player which models the RialtoServer side of the web audio data path.
+ *
+ * The written frames are copied into a ring buffer of webAudioBufferTime, like the shared memory of the
+ * server, and are consumed at the sample rate times the configured speed while playing.
+ */
+class SimulatedWebAudioPlayer : public IWebAudioPlayer
+{
+public:
+    SimulatedWebAudioPlayer(std::weak_ptr<IWebAudioPlayerClient> client, const WebAudioConfig *webAudioConfig,
+                            const SimulatorConfig &config, SimulatorStatistics &statistics);
+    ~SimulatedWebAudioPlayer() override;
+
+    bool play() override;
+    bool pause() override;
+    bool setEos() override;
+    bool getBufferAvailable(uint32_t &availableFrames, std::shared_ptr<WebAudioShmInfo> &webAudioShmInfo) override;
+    bool getBufferDelay(uint32_t &delayFrames) override;
+    bool writeBuffer(const uint32_t numberOfFrames, void *data) override;
+    bool getDeviceInfo(uint32_t &preferredFrames, uint32_t &maximumFrames, bool &supportDeferredPlay) override;
+    bool setVolume(double volume) override;
+    bool getVolume(double &volume) override;
+    std::weak_ptr<IWebAudioPlayerClient> getClient() override;
+
+private:
+    class Server;
+    std::shared_ptr<Server> m_server;
+};
+} // namespace firebolt::rialto::simulator
+
+#endif // FIREBOLT_RIALTO_SIMULATOR_SIMULATED_WEB_AUDIO_PLAYER_H_
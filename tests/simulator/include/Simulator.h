@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef FIREBOLT_RIALTO_SIMULATOR_SIMULATOR_H_
+#define FIREBOLT_RIALTO_SIMULATOR_SIMULATOR_H_
+
+#include "IControl.h"
+#include "IMediaPipeline.h"
+#include "IMediaPipelineCapabilities.h"
+#include "IWebAudioPlayer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace firebolt::rialto::simulator
+{
+/**
+ * @brief Behaviour of the simulated RialtoServer.
+ */
+struct SimulatorConfig
+{
+    /**
+     * @brief Playback speed relative to real time. 0 consumes the data as soon as it arrives.
+     */
+    double speed{1.0};
+
+    /**
+     * @brief The size of the shared memory partition of each media source.
+     */
+    uint32_t shmBytesPerSource{8 * 1024 * 1024};
+
+    /**
+     * @brief The number of frames requested in each need data notification.
+     */
+    uint32_t framesPerNeedData{24};
+
+    /**
+     * @brief How far ahead of the position the media sources are buffered before need data stops.
+     */
+    std::chrono::milliseconds maxBufferedTime{2000};
+
+    /**
+     * @brief The delay before need data is sent again after NO_AVAILABLE_SAMPLES.
+     */
+    std::chrono::milliseconds noAvailableSamplesRetry{100};
+
+    /**
+     * @brief The duration of the web audio buffer.
+     */
+    std::chrono::milliseconds webAudioBufferTime{500};
+
+    /**
+     * @brief The round trip time added to every call of the client, half of it is added to every notification.
+     */
+    std::chrono::microseconds ipcDelay{0};
+
+    /**
+     * @brief Parses a comma separated list of key=value options.
+     *
+     * Keys: speed, shm-bytes, frames, max-buffered-ms, retry-ms, web-audio-ms, ipc-delay-us. Unknown keys are
+     * ignored.
+     *
+     * @param[in] options : The options, e.g. "speed=4,frames=12".
+     *
+     * @retval the config
+     */
+    static SimulatorConfig fromString(const std::string &options);
+};
+
+/**
+ * @brief Counters of the simulated RialtoServer, summed over all of its players.
+ */
+struct SimulatorStatistics
+{
+    std::atomic<uint64_t> needDataRequests{0};
+    std::atomic<uint64_t> framesReceived{0};
+    std::atomic<uint64_t> bytesReceived{0};
+    std::atomic<uint64_t> framesRendered{0};
+    std::atomic<uint64_t> noSpace{0};
+    std::atomic<uint64_t> underflows{0};
+    std::atomic<uint64_t> webAudioFramesWritten{0};
+    std::atomic<uint64_t> webAudioFramesRendered{0};
+};
+
+/**
+ * @brief Milestones of the MSE data path, reported to the event observer.
+ */
+enum class SimulatorEvent
+{
+    ATTACH_SOURCE,
+    ALL_SOURCES_ATTACHED,
+    NEED_DATA,
+    ADD_SEGMENT,
+    SET_POSITION,
+    FLUSHED
+};
+
+/**
+ * @brief Called on the thread of the event. NEED_DATA and FLUSHED are reported when they are delivered to the
+ * client, ADD_SEGMENT only when the segment is accepted.
+ */
+using SimulatorEventObserver = std::function<void(SimulatorEvent event)>;
+
+/**
+ * @brief Checks if the simulated RialtoServer replaces the factory stubs.
+ *
+ * The simulator is enabled by enable() or by the RIALTO_SIMULATED_SERVER environment variable, which holds
+ * the options of SimulatorConfig::fromString(), or any other value for the defaults.
+ *
+ * @retval true if the simulator is enabled.
+ */
+bool isEnabled();
+
+/**
+ * @brief Enables the simulated RialtoServer. Must be called before the first factory is created.
+ *
+ * @param[in] config : The behaviour of the simulator.
+ */
+void enable(const SimulatorConfig &config);
+
+/**
+ * @brief Gets the config of the simulated RialtoServer.
+ *
+ * @retval the config
+ */
+SimulatorConfig getConfig();
+
+/**
+ * @brief Gets the counters of the simulated RialtoServer.
+ *
+ * @retval the statistics
+ */
+SimulatorStatistics &getStatistics();
+
+/**
+ * @brief Sets the observer of the simulator events, replacing the previous one.
+ *
+ * @param[in] observer : The observer, or an empty function to remove it.
+ */
+void setEventObserver(SimulatorEventObserver observer);
+
+/**
+ * @brief Reports an event to the observer.
+ *
+ * @param[in] event : The event.
+ */
+void notifyEvent(SimulatorEvent event);
+
+/**
+ * @brief Waits for the configured IPC round trip time, if any.
+ *
+ * @param[in] config : The config of the player.
+ */
+void simulateIpc(const SimulatorConfig &config);
+
+std::shared_ptr<IControlFactory> createControlFactory();
+std::shared_ptr<IMediaPipelineFactory> createMediaPipelineFactory();
+std::shared_ptr<IMediaPipelineCapabilitiesFactory> createMediaPipelineCapabilitiesFactory();
+std::shared_ptr<IWebAudioPlayerFactory> createWebAudioPlayerFactory();
+} // namespace firebolt::rialto::simulator
+
+#endif // FIREBOLT_RIALTO_SIMULATOR_SIMULATOR_H_
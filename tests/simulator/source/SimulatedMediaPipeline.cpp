@@ -0,0 +1,586 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SimulatedMediaPipeline.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds kTickPeriod{10};
+constexpr uint32_t kMetadataBytesPerFrame{256};
+} // namespace
+
+namespace firebolt::rialto::simulator
+{
+class SimulatedMediaPipeline::Server
+{
+public:
+    using Notification = std::function<void(IMediaPipelineClient &)>;
+
+    struct Frame
+    {
+        int64_t timeStamp;
+        int64_t duration;
+        uint32_t bytes;
+    };
+
+    struct Source
+    {
+        uint32_t partitionOffset{0};
+        std::deque<Frame> frames;
+        size_t bufferedBytes{0};
+        int64_t bufferedEnd{0};
+        uint32_t needDataRequestId{0};
+        size_t requestMaxBytes{0};
+        std::vector<Frame> pendingFrames;
+        size_t pendingBytes{0};
+        bool isEos{false};
+        bool isUnderflow{false};
+        Clock::time_point nextNeedDataTime;
+    };
+
+    Server(std::weak_ptr<IMediaPipelineClient> client, const SimulatorConfig &config, SimulatorStatistics &statistics)
+        : m_client{client}, m_config{config}, m_statistics{statistics}, m_lastTick{Clock::now()}
+    {
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (m_isRunning)
+        {
+            m_wakeUp.wait_for(lock, kTickPeriod, [this]() { return !m_isRunning || m_isWakeUpPending; });
+            m_isWakeUpPending = false;
+            if (!m_isRunning)
+            {
+                break;
+            }
+
+            const Clock::time_point kNow{Clock::now()};
+            advance(kNow);
+            checkPreroll(kNow);
+            requestData(kNow);
+
+            std::vector<Notification> notifications;
+            notifications.swap(m_notifications);
+            lock.unlock();
+            {
+                std::shared_ptr<IMediaPipelineClient> client = m_client.lock();
+                for (const Notification &notification : notifications)
+                {
+                    if (client)
+                    {
+                        std::this_thread::sleep_for(m_config.ipcDelay / 2);
+                        notification(*client);
+                    }
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    void wakeUp()
+    {
+        m_isWakeUpPending = true;
+        m_wakeUp.notify_all();
+    }
+
+    void notifyState(PlaybackState state)
+    {
+        m_notifications.push_back(
+            [state](IMediaPipelineClient &client)
+            {
+                if (state == PlaybackState::FLUSHED)
+                {
+                    notifyEvent(SimulatorEvent::FLUSHED);
+                }
+                client.notifyPlaybackState(state);
+            });
+        wakeUp();
+    }
+
+    int64_t getBufferedEnd(const Source &source) const
+    {
+        return source.frames.empty() ? m_position : std::max(source.bufferedEnd, m_position);
+    }
+
+    void advance(Clock::time_point now)
+    {
+        const auto kElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastTick);
+        m_lastTick = now;
+        if (m_targetState != PlaybackState::PLAYING || !m_isPrerolled || m_sources.empty())
+        {
+            return;
+        }
+
+        const double kSpeed{m_config.speed * m_rate};
+        int64_t target{m_position};
+        if (kSpeed > 0)
+        {
+            target += static_cast<int64_t>(static_cast<double>(kElapsed.count()) * kSpeed);
+        }
+        else
+        {
+            for (const auto &source : m_sources)
+            {
+                target = std::max(target, getBufferedEnd(source.second));
+            }
+        }
+
+        // Playback stalls at the end of the data of a source which has not reached the end of stream
+        int64_t newPosition{target};
+        for (const auto &source : m_sources)
+        {
+            if (!source.second.isEos)
+            {
+                newPosition = std::min(newPosition, getBufferedEnd(source.second));
+            }
+        }
+        m_position = std::max(m_position, newPosition);
+
+        for (auto &source : m_sources)
+        {
+            Source &state = source.second;
+            while (!state.frames.empty() &&
+                   state.frames.front().timeStamp + state.frames.front().duration <= m_position)
+            {
+                state.bufferedBytes -= state.frames.front().bytes;
+                state.frames.pop_front();
+                m_statistics.framesRendered.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (kSpeed > 0 && !state.isEos && !state.isUnderflow && target > m_position &&
+                getBufferedEnd(state) <= m_position)
+            {
+                state.isUnderflow = true;
+                m_statistics.underflows.fetch_add(1, std::memory_order_relaxed);
+                const int32_t kSourceId{source.first};
+                m_notifications.push_back([kSourceId](IMediaPipelineClient &client)
+                                          { client.notifyBufferUnderflow(kSourceId); });
+            }
+        }
+
+        const bool kIsEndOfStream = std::all_of(m_sources.begin(), m_sources.end(), [](const auto &source)
+                                                { return source.second.isEos && source.second.frames.empty(); });
+        if (kIsEndOfStream && !m_isEosNotified)
+        {
+            m_isEosNotified = true;
+            notifyState(PlaybackState::END_OF_STREAM);
+        }
+    }
+
+    void checkPreroll(Clock::time_point now)
+    {
+        if (m_isPrerolled || !m_areAllSourcesAttached || m_sources.empty() ||
+            (m_targetState != PlaybackState::PAUSED && m_targetState != PlaybackState::PLAYING))
+        {
+            return;
+        }
+        if (std::any_of(m_sources.begin(), m_sources.end(), [](const auto &source)
+                        { return source.second.frames.empty() && !source.second.isEos; }))
+        {
+            return;
+        }
+
+        // Start from the first frame, so that a stream which does not begin at zero is not stalled
+        int64_t firstTimeStamp{std::numeric_limits<int64_t>::max()};
+        for (const auto &source : m_sources)
+        {
+            if (!source.second.frames.empty())
+            {
+                firstTimeStamp = std::min(firstTimeStamp, source.second.frames.front().timeStamp);
+            }
+        }
+        if (firstTimeStamp != std::numeric_limits<int64_t>::max())
+        {
+            m_position = std::max(m_position, firstTimeStamp);
+        }
+
+        m_isPrerolled = true;
+        m_lastTick = now;
+        notifyState(PlaybackState::PAUSED);
+        if (m_targetState == PlaybackState::PLAYING)
+        {
+            notifyState(PlaybackState::PLAYING);
+        }
+    }
+
+    void requestData(Clock::time_point now)
+    {
+        if (!m_areAllSourcesAttached || m_targetState == PlaybackState::STOPPED)
+        {
+            return;
+        }
+
+        for (auto &source : m_sources)
+        {
+            Source &state = source.second;
+            if (state.isEos || state.needDataRequestId != 0 || now < state.nextNeedDataTime)
+            {
+                continue;
+            }
+            const size_t kFreeBytes{m_config.shmBytesPerSource - std::min<size_t>(state.bufferedBytes,
+                                                                                  m_config.shmBytesPerSource)};
+            if (kFreeBytes < m_config.shmBytesPerSource / 8 ||
+                getBufferedEnd(state) - m_position >=
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.maxBufferedTime).count())
+            {
+                continue;
+            }
+
+            if (++m_lastNeedDataRequestId == 0)
+            {
+                ++m_lastNeedDataRequestId;
+            }
+            state.needDataRequestId = m_lastNeedDataRequestId;
+            state.requestMaxBytes = kFreeBytes;
+
+            auto shmInfo = std::make_shared<MediaPlayerShmInfo>();
+            shmInfo->maxMetadataBytes = m_config.framesPerNeedData * kMetadataBytesPerFrame;
+            shmInfo->metadataOffset = state.partitionOffset;
+            shmInfo->mediaDataOffset = state.partitionOffset + shmInfo->maxMetadataBytes;
+            shmInfo->maxMediaBytes = kFreeBytes;
+
+            m_statistics.needDataRequests.fetch_add(1, std::memory_order_relaxed);
+            const int32_t kSourceId{source.first};
+            const uint32_t kFrameCount{m_config.framesPerNeedData};
+            const uint32_t kRequestId{state.needDataRequestId};
+            m_notifications.push_back(
+                [kSourceId, kFrameCount, kRequestId, shmInfo](IMediaPipelineClient &client)
+                {
+                    notifyEvent(SimulatorEvent::NEED_DATA);
+                    client.notifyNeedMediaData(kSourceId, kFrameCount, kRequestId, shmInfo);
+                });
+        }
+    }
+
+    void flush()
+    {
+        for (auto &source : m_sources)
+        {
+            Source &state = source.second;
+            state.frames.clear();
+            state.bufferedBytes = 0;
+            state.bufferedEnd = 0;
+            state.needDataRequestId = 0;
+            state.pendingFrames.clear();
+            state.pendingBytes = 0;
+            state.isEos = false;
+            state.isUnderflow = false;
+            state.nextNeedDataTime = Clock::time_point{};
+        }
+        m_isPrerolled = false;
+        m_isEosNotified = false;
+    }
+
+    const std::weak_ptr<IMediaPipelineClient> m_client;
+    const SimulatorConfig m_config;
+    SimulatorStatistics &m_statistics;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    bool m_isRunning{true};
+    bool m_isWakeUpPending{false};
+    std::vector<Notification> m_notifications;
+
+    std::map<int32_t, Source> m_sources;
+    int32_t m_nextSourceId{1};
+    uint32_t m_lastNeedDataRequestId{0};
+    bool m_areAllSourcesAttached{false};
+    PlaybackState m_targetState{PlaybackState::IDLE};
+    bool m_isPrerolled{false};
+    bool m_isEosNotified{false};
+    int64_t m_position{0};
+    double m_rate{1.0};
+    Clock::time_point m_lastTick;
+    double m_volume{1.0};
+    bool m_mute{false};
+};
+
+SimulatedMediaPipeline::SimulatedMediaPipeline(std::weak_ptr<IMediaPipelineClient> client,
+                                               const SimulatorConfig &config, SimulatorStatistics &statistics)
+    : m_server{std::make_shared<Server>(client, config, statistics)}
+{
+    // The client may block in a notification until the thread which destroys this pipeline is free, so the
+    // worker owns the server state and is not joined
+    std::thread{[server = m_server]() { server->run(); }}.detach();
+}
+
+SimulatedMediaPipeline::~SimulatedMediaPipeline()
+{
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_isRunning = false;
+    m_server->m_wakeUp.notify_all();
+}
+
+std::weak_ptr<IMediaPipelineClient> SimulatedMediaPipeline::getClient()
+{
+    return m_server->m_client;
+}
+
+bool SimulatedMediaPipeline::load(MediaType type, const std::string &mimeType, const std::string &url)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->flush();
+    m_server->m_areAllSourcesAttached = false;
+    m_server->m_targetState = PlaybackState::IDLE;
+    m_server->m_position = 0;
+    m_server->m_rate = 1.0;
+    return type == MediaType::MSE;
+}
+
+bool SimulatedMediaPipeline::attachSource(const std::unique_ptr<MediaSource> &source)
+{
+    simulateIpc(m_server->m_config);
+    if (!source)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    const int32_t kSourceId{m_server->m_nextSourceId++};
+    source->setId(kSourceId);
+    Server::Source state;
+    state.partitionOffset = static_cast<uint32_t>(m_server->m_sources.size()) *
+                            (m_server->m_config.shmBytesPerSource +
+                             m_server->m_config.framesPerNeedData * kMetadataBytesPerFrame);
+    m_server->m_sources.emplace(kSourceId, std::move(state));
+    notifyEvent(SimulatorEvent::ATTACH_SOURCE);
+    return true;
+}
+
+bool SimulatedMediaPipeline::removeSource(int32_t id)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    return m_server->m_sources.erase(id) > 0;
+}
+
+bool SimulatedMediaPipeline::allSourcesAttached()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_areAllSourcesAttached = true;
+    m_server->wakeUp();
+    notifyEvent(SimulatorEvent::ALL_SOURCES_ATTACHED);
+    return true;
+}
+
+bool SimulatedMediaPipeline::play()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    m_server->m_targetState = PlaybackState::PLAYING;
+    if (m_server->m_isPrerolled)
+    {
+        m_server->notifyState(PlaybackState::PLAYING);
+    }
+    m_server->wakeUp();
+    return true;
+}
+
+bool SimulatedMediaPipeline::pause()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    m_server->m_targetState = PlaybackState::PAUSED;
+    if (m_server->m_isPrerolled)
+    {
+        m_server->notifyState(PlaybackState::PAUSED);
+    }
+    m_server->wakeUp();
+    return true;
+}
+
+bool SimulatedMediaPipeline::stop()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->flush();
+    m_server->m_targetState = PlaybackState::STOPPED;
+    m_server->notifyState(PlaybackState::STOPPED);
+    return true;
+}
+
+bool SimulatedMediaPipeline::setPlaybackRate(double rate)
+{
+    simulateIpc(m_server->m_config);
+    if (rate <= 0.0)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    m_server->m_rate = rate;
+    return true;
+}
+
+bool SimulatedMediaPipeline::setPosition(int64_t position)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->flush();
+    m_server->m_position = position;
+    notifyEvent(SimulatorEvent::SET_POSITION);
+    m_server->notifyState(PlaybackState::SEEKING);
+    m_server->notifyState(PlaybackState::FLUSHED);
+    return true;
+}
+
+bool SimulatedMediaPipeline::getPosition(int64_t &position)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    position = m_server->m_position;
+    return true;
+}
+
+bool SimulatedMediaPipeline::setVideoWindow(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    simulateIpc(m_server->m_config);
+    return true;
+}
+
+bool SimulatedMediaPipeline::haveData(MediaSourceStatus status, uint32_t needDataRequestId)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    auto sourceIt = std::find_if(m_server->m_sources.begin(), m_server->m_sources.end(), [&](const auto &source)
+                                 { return source.second.needDataRequestId == needDataRequestId; });
+    if (needDataRequestId == 0 || sourceIt == m_server->m_sources.end())
+    {
+        // The request was dropped by a flush, like the server does
+        return true;
+    }
+
+    Server::Source &state = sourceIt->second;
+    for (const Server::Frame &frame : state.pendingFrames)
+    {
+        state.frames.push_back(frame);
+        state.bufferedBytes += frame.bytes;
+        state.bufferedEnd = std::max(state.bufferedEnd, frame.timeStamp + frame.duration);
+    }
+    m_server->m_statistics.framesReceived.fetch_add(state.pendingFrames.size(), std::memory_order_relaxed);
+    m_server->m_statistics.bytesReceived.fetch_add(state.pendingBytes, std::memory_order_relaxed);
+    if (!state.pendingFrames.empty())
+    {
+        state.isUnderflow = false;
+    }
+    state.pendingFrames.clear();
+    state.pendingBytes = 0;
+    state.needDataRequestId = 0;
+
+    switch (status)
+    {
+    case MediaSourceStatus::EOS:
+        state.isEos = true;
+        break;
+    case MediaSourceStatus::NO_AVAILABLE_SAMPLES:
+        state.nextNeedDataTime = Clock::now() + m_server->m_config.noAvailableSamplesRetry;
+        break;
+    case MediaSourceStatus::ERROR:
+        m_server->notifyState(PlaybackState::FAILURE);
+        break;
+    default:
+        break;
+    }
+    m_server->wakeUp();
+    return true;
+}
+
+AddSegmentStatus SimulatedMediaPipeline::addSegment(uint32_t needDataRequestId,
+                                                    const std::unique_ptr<MediaSegment> &mediaSegment)
+{
+    simulateIpc(m_server->m_config);
+    if (!mediaSegment)
+    {
+        return AddSegmentStatus::ERROR;
+    }
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    auto sourceIt = m_server->m_sources.find(mediaSegment->getId());
+    if (sourceIt == m_server->m_sources.end() || sourceIt->second.needDataRequestId != needDataRequestId)
+    {
+        return AddSegmentStatus::ERROR;
+    }
+
+    Server::Source &state = sourceIt->second;
+    if (state.pendingBytes + mediaSegment->getDataLength() > state.requestMaxBytes ||
+        state.pendingFrames.size() >= m_server->m_config.framesPerNeedData)
+    {
+        m_server->m_statistics.noSpace.fetch_add(1, std::memory_order_relaxed);
+        return AddSegmentStatus::NO_SPACE;
+    }
+    state.pendingFrames.push_back(
+        Server::Frame{mediaSegment->getTimeStamp(), mediaSegment->getDuration(), mediaSegment->getDataLength()});
+    state.pendingBytes += mediaSegment->getDataLength();
+    notifyEvent(SimulatorEvent::ADD_SEGMENT);
+    return AddSegmentStatus::OK;
+}
+
+bool SimulatedMediaPipeline::renderFrame()
+{
+    simulateIpc(m_server->m_config);
+    return true;
+}
+
+bool SimulatedMediaPipeline::setVolume(double volume)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_volume = volume;
+    return true;
+}
+
+bool SimulatedMediaPipeline::getVolume(double &volume)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    volume = m_server->m_volume;
+    return true;
+}
+
+bool SimulatedMediaPipeline::setMute(bool mute)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_mute = mute;
+    return true;
+}
+
+bool SimulatedMediaPipeline::getMute(bool &mute)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    mute = m_server->m_mute;
+    return true;
+}
+} // namespace firebolt::rialto::simulator
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SimulatedWebAudioPlayer.h"
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds kTickPeriod{10};
+constexpr uint32_t kDefaultRate{48000};
+constexpr uint32_t kDefaultFrameSize{4};
+} // namespace
+
+namespace firebolt::rialto::simulator
+{
+class SimulatedWebAudioPlayer::Server
+{
+public:
+    Server(std::weak_ptr<IWebAudioPlayerClient> client, const WebAudioConfig *webAudioConfig,
+           const SimulatorConfig &config, SimulatorStatistics &statistics)
+        : m_client{client}, m_config{config}, m_statistics{statistics}, m_lastTick{Clock::now()}
+    {
+        if (webAudioConfig && webAudioConfig->pcm.rate != 0)
+        {
+            m_rate = webAudioConfig->pcm.rate;
+            m_frameSize = std::max<uint32_t>((webAudioConfig->pcm.sampleSize * webAudioConfig->pcm.channels) / CHAR_BIT,
+                                             1);
+        }
+        m_capacityFrames = std::max<uint32_t>(m_rate * config.webAudioBufferTime.count() / 1000, 1);
+        m_buffer.resize(static_cast<size_t>(m_capacityFrames) * m_frameSize);
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (m_isRunning)
+        {
+            m_wakeUp.wait_for(lock, kTickPeriod, [this]() { return !m_isRunning || !m_pendingStates.empty(); });
+            if (!m_isRunning)
+            {
+                break;
+            }
+            advance(Clock::now());
+
+            std::vector<WebAudioPlayerState> states;
+            states.swap(m_pendingStates);
+            lock.unlock();
+            {
+                std::shared_ptr<IWebAudioPlayerClient> client = m_client.lock();
+                for (WebAudioPlayerState state : states)
+                {
+                    if (client)
+                    {
+                        std::this_thread::sleep_for(m_config.ipcDelay / 2);
+                        client->notifyState(state);
+                    }
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    void notifyState(WebAudioPlayerState state)
+    {
+        m_pendingStates.push_back(state);
+        m_wakeUp.notify_all();
+    }
+
+    void advance(Clock::time_point now)
+    {
+        const std::chrono::duration<double> kElapsed{now - m_lastTick};
+        m_lastTick = now;
+        if (!m_isPlaying)
+        {
+            return;
+        }
+
+        uint32_t framesToConsume{m_bufferedFrames};
+        if (m_config.speed > 0)
+        {
+            m_pendingFrames += kElapsed.count() * m_rate * m_config.speed;
+            framesToConsume = static_cast<uint32_t>(std::min<double>(m_pendingFrames, m_bufferedFrames));
+            m_pendingFrames = std::min<double>(m_pendingFrames - framesToConsume, 1.0);
+        }
+        m_bufferedFrames -= framesToConsume;
+        m_statistics.webAudioFramesRendered.fetch_add(framesToConsume, std::memory_order_relaxed);
+
+        if (m_bufferedFrames == 0 && m_isEos)
+        {
+            if (!m_isEosNotified)
+            {
+                m_isEosNotified = true;
+                notifyState(WebAudioPlayerState::END_OF_STREAM);
+            }
+        }
+        else if (m_bufferedFrames == 0 && m_config.speed > 0 && !m_isUnderflow)
+        {
+            m_isUnderflow = true;
+            m_statistics.underflows.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const std::weak_ptr<IWebAudioPlayerClient> m_client;
+    const SimulatorConfig m_config;
+    SimulatorStatistics &m_statistics;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    bool m_isRunning{true};
+    std::vector<WebAudioPlayerState> m_pendingStates;
+
+    uint32_t m_rate{kDefaultRate};
+    uint32_t m_frameSize{kDefaultFrameSize};
+    uint32_t m_capacityFrames{0};
+    std::vector<uint8_t> m_buffer;
+    uint32_t m_writeFrame{0};
+    uint32_t m_bufferedFrames{0};
+    double m_pendingFrames{0.0};
+    bool m_isPlaying{false};
+    bool m_isEos{false};
+    bool m_isEosNotified{false};
+    bool m_isUnderflow{false};
+    Clock::time_point m_lastTick;
+    double m_volume{1.0};
+};
+
+SimulatedWebAudioPlayer::SimulatedWebAudioPlayer(std::weak_ptr<IWebAudioPlayerClient> client,
+                                                 const WebAudioConfig *webAudioConfig, const SimulatorConfig &config,
+                                                 SimulatorStatistics &statistics)
+    : m_server{std::make_shared<Server>(client, webAudioConfig, config, statistics)}
+{
+    // The client may block in a notification until the thread which destroys this player is free, so the
+    // worker owns the server state and is not joined
+    std::thread{[server = m_server]() { server->run(); }}.detach();
+}
+
+SimulatedWebAudioPlayer::~SimulatedWebAudioPlayer()
+{
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_isRunning = false;
+    m_server->m_wakeUp.notify_all();
+}
+
+bool SimulatedWebAudioPlayer::play()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    m_server->m_isPlaying = true;
+    m_server->notifyState(WebAudioPlayerState::PLAYING);
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::pause()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    m_server->m_isPlaying = false;
+    m_server->notifyState(WebAudioPlayerState::PAUSED);
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::setEos()
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_isEos = true;
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::getBufferAvailable(uint32_t &availableFrames,
+                                                 std::shared_ptr<WebAudioShmInfo> &webAudioShmInfo)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    availableFrames = m_server->m_capacityFrames - m_server->m_bufferedFrames;
+
+    const uint32_t kMainFrames{std::min(availableFrames, m_server->m_capacityFrames - m_server->m_writeFrame)};
+    webAudioShmInfo = std::make_shared<WebAudioShmInfo>();
+    webAudioShmInfo->offsetMain = m_server->m_writeFrame * m_server->m_frameSize;
+    webAudioShmInfo->lengthMain = kMainFrames * m_server->m_frameSize;
+    webAudioShmInfo->offsetWrap = 0;
+    webAudioShmInfo->lengthWrap = (availableFrames - kMainFrames) * m_server->m_frameSize;
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::getBufferDelay(uint32_t &delayFrames)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->advance(Clock::now());
+    delayFrames = m_server->m_bufferedFrames;
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::writeBuffer(const uint32_t numberOfFrames, void *data)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    if (numberOfFrames > m_server->m_capacityFrames - m_server->m_bufferedFrames)
+    {
+        return false;
+    }
+
+    // Copy like the server does from the shared memory, wrapping at the end of the buffer
+    if (data)
+    {
+        const uint32_t kFrameSize{m_server->m_frameSize};
+        const uint32_t kMainFrames{std::min(numberOfFrames, m_server->m_capacityFrames - m_server->m_writeFrame)};
+        std::memcpy(m_server->m_buffer.data() + static_cast<size_t>(m_server->m_writeFrame) * kFrameSize, data,
+                    static_cast<size_t>(kMainFrames) * kFrameSize);
+        std::memcpy(m_server->m_buffer.data(),
+                    static_cast<uint8_t *>(data) + static_cast<size_t>(kMainFrames) * kFrameSize,
+                    static_cast<size_t>(numberOfFrames - kMainFrames) * kFrameSize);
+    }
+    m_server->m_writeFrame = (m_server->m_writeFrame + numberOfFrames) % m_server->m_capacityFrames;
+    m_server->m_bufferedFrames += numberOfFrames;
+    if (numberOfFrames > 0)
+    {
+        m_server->m_isUnderflow = false;
+    }
+    m_server->m_statistics.webAudioFramesWritten.fetch_add(numberOfFrames, std::memory_order_relaxed);
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::getDeviceInfo(uint32_t &preferredFrames, uint32_t &maximumFrames,
+                                            bool &supportDeferredPlay)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    preferredFrames = std::max<uint32_t>(m_server->m_rate / 100, 1);
+    maximumFrames = m_server->m_capacityFrames;
+    supportDeferredPlay = true;
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::setVolume(double volume)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    m_server->m_volume = volume;
+    return true;
+}
+
+bool SimulatedWebAudioPlayer::getVolume(double &volume)
+{
+    simulateIpc(m_server->m_config);
+    std::unique_lock<std::mutex> lock{m_server->m_mutex};
+    volume = m_server->m_volume;
+    return true;
+}
+
+std::weak_ptr<IWebAudioPlayerClient> SimulatedWebAudioPlayer::getClient()
+{
+    return m_server->m_client;
+}
+} // namespace firebolt::rialto::simulator
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Simulator.h"
+#include "SimulatedMediaPipeline.h"
+#include "SimulatedWebAudioPlayer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using firebolt::rialto::simulator::SimulatorConfig;
+using firebolt::rialto::simulator::SimulatorEventObserver;
+
+const std::vector<std::string> kAudioMimeTypes{"audio/mp4", "audio/aac", "audio/x-eac3", "audio/x-opus"};
+const std::vector<std::string> kVideoMimeTypes{"video/h264", "video/h265", "video/x-av1", "video/x-vp9"};
+
+bool parseUnsigned(const std::string &value, unsigned long &result)
+{
+    char *end{nullptr};
+    errno = 0;
+    result = strtoul(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0' && errno != ERANGE;
+}
+
+struct Settings
+{
+    Settings()
+    {
+        const char *kOptions = getenv("RIALTO_SIMULATED_SERVER");
+        if (kOptions)
+        {
+            isEnabled = true;
+            config = SimulatorConfig::fromString(kOptions);
+        }
+    }
+
+    std::mutex mutex;
+    bool isEnabled{false};
+    SimulatorConfig config;
+    SimulatorEventObserver eventObserver;
+};
+
+Settings &getSettings()
+{
+    static Settings settings;
+    return settings;
+}
+} // namespace
+
+namespace firebolt::rialto::simulator
+{
+class SimulatedControl : public IControl
+{
+public:
+    bool registerClient(std::weak_ptr<IControlClient> client, ApplicationState &appState) override
+    {
+        simulateIpc(getConfig());
+        appState = ApplicationState::RUNNING;
+        return true;
+    }
+};
+
+class SimulatedControlFactory : public IControlFactory
+{
+public:
+    std::shared_ptr<IControl> createControl() const override { return std::make_shared<SimulatedControl>(); }
+};
+
+class SimulatedMediaPipelineFactory : public IMediaPipelineFactory
+{
+public:
+    std::unique_ptr<IMediaPipeline> createMediaPipeline(std::weak_ptr<IMediaPipelineClient> client,
+                                                        const VideoRequirements &videoRequirements) const override
+    {
+        return std::make_unique<SimulatedMediaPipeline>(client, getConfig(), getStatistics());
+    }
+};
+
+class SimulatedMediaPipelineCapabilities : public IMediaPipelineCapabilities
+{
+public:
+    std::vector<std::string> getSupportedMimeTypes(MediaSourceType sourceType) override
+    {
+        if (sourceType == MediaSourceType::AUDIO)
+        {
+            return kAudioMimeTypes;
+        }
+        if (sourceType == MediaSourceType::VIDEO)
+        {
+            return kVideoMimeTypes;
+        }
+        return {};
+    }
+
+    bool isMimeTypeSupported(const std::string &mimeType) override
+    {
+        return std::find(kAudioMimeTypes.begin(), kAudioMimeTypes.end(), mimeType) != kAudioMimeTypes.end() ||
+               std::find(kVideoMimeTypes.begin(), kVideoMimeTypes.end(), mimeType) != kVideoMimeTypes.end();
+    }
+};
+
+class SimulatedMediaPipelineCapabilitiesFactory : public IMediaPipelineCapabilitiesFactory
+{
+public:
+    std::unique_ptr<IMediaPipelineCapabilities> createMediaPipelineCapabilities() const override
+    {
+        return std::make_unique<SimulatedMediaPipelineCapabilities>();
+    }
+};
+
+class SimulatedWebAudioPlayerFactory : public IWebAudioPlayerFactory
+{
+public:
+    std::unique_ptr<IWebAudioPlayer> createWebAudioPlayer(std::weak_ptr<IWebAudioPlayerClient> client,
+                                                          const std::string &audioMimeType, const uint32_t priority,
+                                                          const WebAudioConfig *config) const override
+    {
+        if (audioMimeType != "audio/x-raw")
+        {
+            return nullptr;
+        }
+        return std::make_unique<SimulatedWebAudioPlayer>(client, config, getConfig(), getStatistics());
+    }
+};
+
+SimulatorConfig SimulatorConfig::fromString(const std::string &options)
+{
+    SimulatorConfig config;
+    std::istringstream stream{options};
+    std::string option;
+    while (std::getline(stream, option, ','))
+    {
+        const size_t kSeparator{option.find('=')};
+        if (kSeparator == std::string::npos)
+        {
+            continue;
+        }
+        const std::string kKey{option.substr(0, kSeparator)};
+        const std::string kValue{option.substr(kSeparator + 1)};
+
+        if (kKey == "speed")
+        {
+            char *end{nullptr};
+            const double kSpeed{strtod(kValue.c_str(), &end)};
+            if (!kValue.empty() && *end == '\0' && kSpeed >= 0.0)
+            {
+                config.speed = kSpeed;
+            }
+            continue;
+        }
+
+        unsigned long value{0};
+        if (!parseUnsigned(kValue, value))
+        {
+            continue;
+        }
+        if (kKey == "shm-bytes" && value > 0)
+        {
+            config.shmBytesPerSource = value;
+        }
+        else if (kKey == "frames" && value > 0)
+        {
+            config.framesPerNeedData = value;
+        }
+        else if (kKey == "max-buffered-ms")
+        {
+            config.maxBufferedTime = std::chrono::milliseconds{value};
+        }
+        else if (kKey == "retry-ms")
+        {
+            config.noAvailableSamplesRetry = std::chrono::milliseconds{value};
+        }
+        else if (kKey == "web-audio-ms" && value > 0)
+        {
+            config.webAudioBufferTime = std::chrono::milliseconds{value};
+        }
+        else if (kKey == "ipc-delay-us")
+        {
+            config.ipcDelay = std::chrono::microseconds{value};
+        }
+    }
+    return config;
+}
+
+bool isEnabled()
+{
+    Settings &settings{getSettings()};
+    std::unique_lock<std::mutex> lock{settings.mutex};
+    return settings.isEnabled;
+}
+
+void enable(const SimulatorConfig &config)
+{
+    Settings &settings{getSettings()};
+    std::unique_lock<std::mutex> lock{settings.mutex};
+    settings.isEnabled = true;
+    settings.config = config;
+}
+
+SimulatorConfig getConfig()
+{
+    Settings &settings{getSettings()};
+    std::unique_lock<std::mutex> lock{settings.mutex};
+    return settings.config;
+}
+
+SimulatorStatistics &getStatistics()
+{
+    static SimulatorStatistics statistics;
+    return statistics;
+}
+
+void setEventObserver(SimulatorEventObserver observer)
+{
+    Settings &settings{getSettings()};
+    std::unique_lock<std::mutex> lock{settings.mutex};
+    settings.eventObserver = std::move(observer);
+}
+
+void notifyEvent(SimulatorEvent event)
+{
+    Settings &settings{getSettings()};
+    SimulatorEventObserver observer;
+    {
+        std::unique_lock<std::mutex> lock{settings.mutex};
+        observer = settings.eventObserver;
+    }
+    if (observer)
+    {
+        observer(event);
+    }
+}
+
+void simulateIpc(const SimulatorConfig &config)
+{
+    if (config.ipcDelay.count() > 0)
+    {
+        std::this_thread::sleep_for(config.ipcDelay);
+    }
+}
+
+std::shared_ptr<IControlFactory> createControlFactory()
+{
+    static auto controlFactory{std::make_shared<SimulatedControlFactory>()};
+    return controlFactory;
+}
+
+std::shared_ptr<IMediaPipelineFactory> createMediaPipelineFactory()
+{
+    static auto mediaPipelineFactory{std::make_shared<SimulatedMediaPipelineFactory>()};
+    return mediaPipelineFactory;
+}
+
+std::shared_ptr<IMediaPipelineCapabilitiesFactory> createMediaPipelineCapabilitiesFactory()
+{
+    static auto mediaPipelineCapabilitiesFactory{std::make_shared<SimulatedMediaPipelineCapabilitiesFactory>()};
+    return mediaPipelineCapabilitiesFactory;
+}
+
+std::shared_ptr<IWebAudioPlayerFactory> createWebAudioPlayerFactory()
+{
+    static auto webAudioPlayerFactory{std::make_shared<SimulatedWebAudioPlayerFactory>()};
+    return webAudioPlayerFactory;
+}
+} // namespace firebolt::rialto::simulator
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Replaces the glibc allocation functions for the whole process, every allocation made by GStreamer, GLib, the sinks
+// and the simulator is counted and forwarded to the glibc implementation. The sizes are the usable sizes of the
+// blocks, so that an allocation and its release always account for the same number of bytes.
+
+#include "MallocInterposer.h"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <malloc.h>
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void *__libc_valloc(size_t size);
+    void *__libc_pvalloc(size_t size);
+    void __libc_free(void *ptr);
+}
+
+namespace
+{
+std::atomic<int64_t> gCurrentBytes{0};
+std::atomic<int64_t> gPeakBytes{0};
+std::atomic<uint64_t> gAllocations{0};
+
+void addBytes(int64_t bytes)
+{
+    const int64_t kCurrent{gCurrentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+    int64_t peak{gPeakBytes.load(std::memory_order_relaxed)};
+    while (kCurrent > peak && !gPeakBytes.compare_exchange_weak(peak, kCurrent, std::memory_order_relaxed))
+    {
+    }
+}
+
+void *recordAllocation(void *ptr)
+{
+    if (ptr)
+    {
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+        addBytes(static_cast<int64_t>(malloc_usable_size(ptr)));
+    }
+    return ptr;
+}
+
+void recordRelease(void *ptr)
+{
+    if (ptr)
+    {
+        gCurrentBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+HeapUsage getHeapUsage()
+{
+    return HeapUsage{gCurrentBytes.load(std::memory_order_relaxed), gPeakBytes.load(std::memory_order_relaxed),
+                     gAllocations.load(std::memory_order_relaxed)};
+}
+
+void resetHeapPeak()
+{
+    gPeakBytes.store(gCurrentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+extern "C"
+{
+    void *malloc(size_t size)
+    {
+        return recordAllocation(__libc_malloc(size));
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        return recordAllocation(__libc_calloc(count, size));
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        const int64_t kPreviousBytes{ptr ? static_cast<int64_t>(malloc_usable_size(ptr)) : 0};
+        void *result = __libc_realloc(ptr, size);
+        if (result)
+        {
+            gAllocations.fetch_add(1, std::memory_order_relaxed);
+            addBytes(static_cast<int64_t>(malloc_usable_size(result)) - kPreviousBytes);
+        }
+        else if (ptr && size == 0)
+        {
+            // realloc(ptr, 0) releases the block
+            gCurrentBytes.fetch_sub(kPreviousBytes, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void *memalign(size_t alignment, size_t size)
+    {
+        return recordAllocation(__libc_memalign(alignment, size));
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        return recordAllocation(__libc_memalign(alignment, size));
+    }
+
+    int posix_memalign(void **ptr, size_t alignment, size_t size)
+    {
+        if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        {
+            return EINVAL;
+        }
+        void *result = recordAllocation(__libc_memalign(alignment, size));
+        if (!result && size != 0)
+        {
+            return ENOMEM;
+        }
+        *ptr = result;
+        return 0;
+    }
+
+    void *valloc(size_t size)
+    {
+        return recordAllocation(__libc_valloc(size));
+    }
+
+    void *pvalloc(size_t size)
+    {
+        return recordAllocation(__libc_pvalloc(size));
+    }
+
+    void free(void *ptr)
+    {
+        recordRelease(ptr);
+        __libc_free(ptr);
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief The heap use seen by the malloc interposer linked into the memory test.
+ */
+struct HeapUsage
+{
+    int64_t currentBytes;
+    int64_t peakBytes;
+    uint64_t allocations;
+};
+
+/**
+ * @brief Gets the heap use since the start of the process.
+ *
+ * @retval the live bytes, the highest live bytes since the last resetHeapPeak() and the number of allocations.
+ */
+HeapUsage getHeapUsage();
+
+/**
+ * @brief Starts a new peak measurement from the current live bytes.
+ */
+void resetHeapPeak();
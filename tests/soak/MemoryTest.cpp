@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Plays scripted sessions through the rialto sinks against the simulated RialtoServer and measures the heap use of
+// each session with the malloc interposer, so that memory regressions of the sinks are caught before they reach
+// 1 GB devices.
+//
+// GstRialtoMemoryTest [--sessions=<name>,...] [--warm-up=<s>] [--duration=<s>] [--simulator=<options>]
+//                     [--budget=<session>|*.<metric>=<value>]...
+//
+// The sessions are clear-1080p, encrypted-1080p, clear-4k, encrypted-4k, audio-only and web-audio. Each session is
+// primed once so that the one time allocations of the GStreamer registry, the type system and the caches are not
+// charged to it. A measured session plays for --warm-up seconds, then for --duration seconds while the heap and the
+// threads are sampled, and is torn down. The metrics, relative to the heap and threads before the session, are:
+//   peak-kb          : the highest live heap from the start of the session until it is torn down
+//   steady-kb        : the mean live heap while playing after the warm-up
+//   leak-kb          : the live heap left once the session is torn down
+//   allocs-per-frame : the allocations after the warm-up per frame received by the server
+//   threads          : the highest number of threads the session added
+// The heap includes the simulated server, the appsrc feeders and the frames they allocate. Thread stacks are not
+// heap and are covered by the thread count. The exit code is non zero if a session fails or exceeds a budget, e.g.
+// --budget=*.leak-kb=64 --budget=clear-4k.peak-kb=16384.
+
+#include "MallocInterposer.h"
+#include "Simulator.h"
+#include "TestPipeline.h"
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+using firebolt::rialto::simulator::SimulatorStatistics;
+
+constexpr std::chrono::seconds kPrimingTime{1};
+constexpr std::chrono::milliseconds kSamplingInterval{100};
+constexpr size_t k1080pFrameBytes{50000};
+constexpr size_t k4kFrameBytes{200000};
+constexpr unsigned int kSubsampleCount{4};
+const std::vector<std::string> kMetrics{"peak-kb", "steady-kb", "leak-kb", "allocs-per-frame", "threads"};
+
+struct Session
+{
+    const char *name;
+    std::vector<StreamDescription> streams;
+};
+
+struct Budget
+{
+    std::string session;
+    std::string metric;
+    double limit;
+};
+
+struct MemoryOptions
+{
+    std::vector<std::string> sessions;
+    std::chrono::seconds warmUp{5};
+    std::chrono::seconds duration{20};
+    std::string simulatorOptions;
+    std::vector<Budget> budgets;
+};
+
+struct SessionResult
+{
+    bool isSuccess;
+    uint64_t frames;
+    std::vector<double> metrics; // In the order of kMetrics
+};
+
+std::vector<Session> getSessions()
+{
+    const StreamDescription kVideo1080p{"video",
+                                        "video/x-h264, stream-format=(string)byte-stream, alignment=(string)au, "
+                                        "width=(int)1920, height=(int)1080, framerate=(fraction)30/1",
+                                        GST_SECOND / 30, k1080pFrameBytes, 30, 0};
+    const StreamDescription kVideo4k{"video",
+                                     "video/x-h265, stream-format=(string)byte-stream, alignment=(string)au, "
+                                     "width=(int)3840, height=(int)2160, framerate=(fraction)60/1",
+                                     GST_SECOND / 60, k4kFrameBytes, 60, 0};
+    const StreamDescription kAudio{"audio", "audio/mpeg, mpegversion=(int)4, channels=(int)2, rate=(int)48000",
+                                   gst_util_uint64_scale(1024, GST_SECOND, 48000), 768, 1, 0};
+    const StreamDescription kWebAudio{"webaudio",
+                                      "audio/x-raw, format=(string)S16LE, layout=(string)interleaved, "
+                                      "channels=(int)2, rate=(int)48000",
+                                      GST_SECOND / 100, 480 * 4, 1, 0};
+
+    StreamDescription encryptedVideo1080p{kVideo1080p};
+    encryptedVideo1080p.subsampleCount = kSubsampleCount;
+    StreamDescription encryptedVideo4k{kVideo4k};
+    encryptedVideo4k.subsampleCount = kSubsampleCount;
+    StreamDescription encryptedAudio{kAudio};
+    encryptedAudio.subsampleCount = 1;
+
+    return {{"clear-1080p", {kVideo1080p, kAudio}},
+            {"encrypted-1080p", {encryptedVideo1080p, encryptedAudio}},
+            {"clear-4k", {kVideo4k, kAudio}},
+            {"encrypted-4k", {encryptedVideo4k, encryptedAudio}},
+            {"audio-only", {kAudio}},
+            {"web-audio", {kWebAudio}}};
+}
+
+bool isKnownSession(const std::string &name)
+{
+    const std::vector<Session> kSessions{getSessions()};
+    return std::any_of(kSessions.begin(), kSessions.end(),
+                       [&name](const Session &session) { return name == session.name; });
+}
+
+bool parseNumber(const char *value, unsigned long &result)
+{
+    char *end{nullptr};
+    errno = 0;
+    result = strtoul(value, &end, 10);
+    return *value != '\0' && *end == '\0' && errno != ERANGE;
+}
+
+// Parses <session>|*.<metric>=<value>
+bool parseBudget(const std::string &value, Budget &budget)
+{
+    const size_t kAssignment{value.find('=')};
+    const size_t kSeparator{value.rfind('.', kAssignment)};
+    if (kAssignment == std::string::npos || kSeparator == std::string::npos)
+    {
+        return false;
+    }
+
+    budget.session = value.substr(0, kSeparator);
+    budget.metric = value.substr(kSeparator + 1, kAssignment - kSeparator - 1);
+    const std::string kLimit{value.substr(kAssignment + 1)};
+    char *end{nullptr};
+    errno = 0;
+    budget.limit = strtod(kLimit.c_str(), &end);
+    return !kLimit.empty() && *end == '\0' && errno != ERANGE && budget.limit >= 0 &&
+           (budget.session == "*" || isKnownSession(budget.session)) &&
+           std::find(kMetrics.begin(), kMetrics.end(), budget.metric) != kMetrics.end();
+}
+
+bool parseSessions(const std::string &value, std::vector<std::string> &sessions)
+{
+    size_t start{0};
+    while (start <= value.size())
+    {
+        const size_t kEnd{std::min(value.find(',', start), value.size())};
+        const std::string kName{value.substr(start, kEnd - start)};
+        if (!isKnownSession(kName))
+        {
+            return false;
+        }
+        sessions.push_back(kName);
+        start = kEnd + 1;
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char **argv, MemoryOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string kArgument{argv[i]};
+        const size_t kSeparator{kArgument.find('=')};
+        const std::string kKey{kArgument.substr(0, kSeparator)};
+        const char *value{kSeparator == std::string::npos ? "" : argv[i] + kSeparator + 1};
+        unsigned long number{0};
+        std::vector<std::string> sessions;
+        Budget budget;
+
+        if (kKey == "--sessions" && parseSessions(value, sessions))
+        {
+            options.sessions.insert(options.sessions.end(), sessions.begin(), sessions.end());
+        }
+        else if (kKey == "--simulator")
+        {
+            options.simulatorOptions = value;
+        }
+        else if (kKey == "--warm-up" && parseNumber(value, number))
+        {
+            options.warmUp = std::chrono::seconds{number};
+        }
+        else if (kKey == "--duration" && parseNumber(value, number) && number > 0)
+        {
+            options.duration = std::chrono::seconds{number};
+        }
+        else if (kKey == "--budget" && parseBudget(value, budget))
+        {
+            options.budgets.push_back(budget);
+        }
+        else
+        {
+            fprintf(stderr, "Invalid argument '%s'\n", argv[i]);
+            return false;
+        }
+    }
+
+    if (options.sessions.empty())
+    {
+        for (const Session &session : getSessions())
+        {
+            options.sessions.push_back(session.name);
+        }
+    }
+    return true;
+}
+
+uint64_t getFrames()
+{
+    const SimulatorStatistics &statistics{firebolt::rialto::simulator::getStatistics()};
+    return statistics.framesReceived.load(std::memory_order_relaxed) +
+           statistics.webAudioFramesWritten.load(std::memory_order_relaxed);
+}
+
+int64_t getThreadCount()
+{
+    std::ifstream status{"/proc/self/status"};
+    std::string key;
+    while (status >> key)
+    {
+        int64_t threads{0};
+        if (key == "Threads:" && status >> threads)
+        {
+            return threads;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return 0;
+}
+
+double toKb(int64_t bytes)
+{
+    return static_cast<double>(bytes) / 1024;
+}
+
+bool playFor(TestPipeline &pipeline, std::chrono::steady_clock::duration duration, int64_t &peakThreads,
+             std::vector<int64_t> *heapSamples)
+{
+    const auto kEnd{std::chrono::steady_clock::now() + duration};
+    while (std::chrono::steady_clock::now() < kEnd)
+    {
+        if (!pipeline.waitUntil(std::min(std::chrono::steady_clock::now() + kSamplingInterval, kEnd)))
+        {
+            return false;
+        }
+        peakThreads = std::max(peakThreads, getThreadCount());
+        if (heapSamples)
+        {
+            heapSamples->push_back(getHeapUsage().currentBytes);
+        }
+    }
+    return true;
+}
+
+SessionResult runSession(const Session &session, std::chrono::seconds warmUp, std::chrono::seconds duration)
+{
+    const int64_t kBaselineThreads{getThreadCount()};
+    resetHeapPeak();
+    const HeapUsage kBaseline{getHeapUsage()};
+
+    SessionResult result{true, 0, std::vector<double>(kMetrics.size(), 0.0)};
+    int64_t peakThreads{kBaselineThreads};
+    std::vector<int64_t> heapSamples;
+    HeapUsage steadyStart{kBaseline};
+    HeapUsage steadyEnd{kBaseline};
+    uint64_t steadyStartFrames{0};
+    {
+        TestPipeline pipeline{session.streams};
+        result.isSuccess = pipeline.play() && playFor(pipeline, warmUp, peakThreads, nullptr);
+        steadyStart = getHeapUsage();
+        steadyStartFrames = getFrames();
+        result.isSuccess = result.isSuccess && playFor(pipeline, duration, peakThreads, &heapSamples);
+        steadyEnd = getHeapUsage();
+        result.frames = getFrames() - steadyStartFrames;
+        pipeline.stop();
+    }
+    const HeapUsage kFinal{getHeapUsage()};
+
+    int64_t steadySum{0};
+    for (int64_t sample : heapSamples)
+    {
+        steadySum += sample - kBaseline.currentBytes;
+    }
+    result.metrics[0] = toKb(kFinal.peakBytes - kBaseline.currentBytes);
+    result.metrics[1] = heapSamples.empty() ? 0.0 : toKb(steadySum / static_cast<int64_t>(heapSamples.size()));
+    result.metrics[2] = toKb(kFinal.currentBytes - kBaseline.currentBytes);
+    result.metrics[3] = result.frames > 0 ? static_cast<double>(steadyEnd.allocations - steadyStart.allocations) /
+                                                static_cast<double>(result.frames)
+                                          : 0.0;
+    result.metrics[4] = static_cast<double>(peakThreads - kBaselineThreads);
+    return result;
+}
+
+bool checkBudgets(const std::string &session, const SessionResult &result, const std::vector<Budget> &budgets)
+{
+    bool isWithinBudgets{true};
+    for (const Budget &budget : budgets)
+    {
+        if (budget.session != "*" && budget.session != session)
+        {
+            continue;
+        }
+        const size_t kIndex{static_cast<size_t>(
+            std::find(kMetrics.begin(), kMetrics.end(), budget.metric) - kMetrics.begin())};
+        if (result.metrics[kIndex] > budget.limit)
+        {
+            fprintf(stderr, "%s: %s=%.1f exceeds the budget of %.1f\n", session.c_str(), budget.metric.c_str(),
+                    result.metrics[kIndex], budget.limit);
+            isWithinBudgets = false;
+        }
+    }
+    return isWithinBudgets;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    MemoryOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        fprintf(stderr,
+                "Usage: %s [--sessions=<name>,...] [--warm-up=<s>] [--duration=<s>] [--simulator=<options>] "
+                "[--budget=<session>|*.<metric>=<value>]...\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    firebolt::rialto::simulator::enable(
+        firebolt::rialto::simulator::SimulatorConfig::fromString(options.simulatorOptions));
+    gst_init(&argc, &argv);
+    registerRialtoSinks();
+
+    std::vector<Session> sessions;
+    for (const Session &session : getSessions())
+    {
+        if (std::find(options.sessions.begin(), options.sessions.end(), session.name) != options.sessions.end())
+        {
+            sessions.push_back(session);
+        }
+    }
+    for (const Session &session : sessions)
+    {
+        runSession(session, kPrimingTime, std::chrono::seconds{0});
+    }
+
+    bool isSuccess{true};
+    for (const Session &session : sessions)
+    {
+        const SessionResult kResult{runSession(session, options.warmUp, options.duration)};
+        fprintf(stdout, "%-16s", session.name);
+        for (size_t i = 0; i < kMetrics.size(); ++i)
+        {
+            fprintf(stdout, " %s=%.1f", kMetrics[i].c_str(), kResult.metrics[i]);
+        }
+        fprintf(stdout, " frames=%" PRIu64 "\n", kResult.frames);
+        fflush(stdout);
+
+        if (!kResult.isSuccess)
+        {
+            fprintf(stderr, "%s: the session failed\n", session.name);
+            isSuccess = false;
+        }
+        isSuccess = checkBudgets(session.name, kResult, options.budgets) && isSuccess;
+    }
+
+    return isSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// Runs appsrc ! rialto sink pipelines against the simulated RialtoServer for a long time and reports the
+// throughput, the CPU time per frame and the growth of the resident set size.
+//
+// GstRialtoSoakTest [--pipeline=av|video|audio|webaudio] [--duration=<s>] [--report-interval=<s>]
+//                   [--simulator=<options>] [--video-frame-bytes=<n>] [--max-rss-growth-kb=<n>]
+//
+// The simulator options are described in SimulatorConfig::fromString(), e.g. --simulator=speed=4 runs four
+// times faster than real time. The exit code is non zero if the pipeline fails or the RSS grows by more than
+// --max-rss-growth-kb after the first report interval.
+
+#include "Simulator.h"
+#include "TestPipeline.h"
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+using firebolt::rialto::simulator::SimulatorStatistics;
+
+struct SoakOptions
+{
+    std::string pipeline{"av"};
+    std::chrono::seconds duration{3600};
+    std::chrono::seconds reportInterval{60};
+    std::string simulatorOptions;
+    size_t videoFrameBytes{50000};
+    uint64_t maxRssGrowthKb{0};
+};
+
+struct ResourceUsage
+{
+    std::chrono::steady_clock::time_point time;
+    uint64_t cpuTimeUs;
+    uint64_t rssKb;
+    uint64_t frames;
+};
+
+bool parseNumber(const char *value, unsigned long &result)
+{
+    char *end{nullptr};
+    errno = 0;
+    result = strtoul(value, &end, 10);
+    return *value != '\0' && *end == '\0' && errno != ERANGE;
+}
+
+bool parseOptions(int argc, char **argv, SoakOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string kArgument{argv[i]};
+        const size_t kSeparator{kArgument.find('=')};
+        const std::string kKey{kArgument.substr(0, kSeparator)};
+        const char *value{kSeparator == std::string::npos ? "" : argv[i] + kSeparator + 1};
+        unsigned long number{0};
+
+        if (kKey == "--pipeline")
+        {
+            options.pipeline = value;
+        }
+        else if (kKey == "--simulator")
+        {
+            options.simulatorOptions = value;
+        }
+        else if (kKey == "--duration" && parseNumber(value, number))
+        {
+            options.duration = std::chrono::seconds{number};
+        }
+        else if (kKey == "--report-interval" && parseNumber(value, number) && number > 0)
+        {
+            options.reportInterval = std::chrono::seconds{number};
+        }
+        else if (kKey == "--video-frame-bytes" && parseNumber(value, number) && number > 0)
+        {
+            options.videoFrameBytes = number;
+        }
+        else if (kKey == "--max-rss-growth-kb" && parseNumber(value, number))
+        {
+            options.maxRssGrowthKb = number;
+        }
+        else
+        {
+            fprintf(stderr, "Invalid argument '%s'\n", argv[i]);
+            return false;
+        }
+    }
+    return options.pipeline == "av" || options.pipeline == "video" || options.pipeline == "audio" ||
+           options.pipeline == "webaudio";
+}
+
+std::vector<StreamDescription> getStreams(const SoakOptions &options)
+{
+    const StreamDescription kVideo{"video",
+                                   "video/x-h264, stream-format=(string)byte-stream, alignment=(string)au, "
+                                   "width=(int)1920, height=(int)1080, framerate=(fraction)30/1",
+                                   GST_SECOND / 30, options.videoFrameBytes, 30, 0};
+    const StreamDescription kAudio{"audio", "audio/mpeg, mpegversion=(int)4, channels=(int)2, rate=(int)48000",
+                                   gst_util_uint64_scale(1024, GST_SECOND, 48000), 768, 1, 0};
+    const StreamDescription kWebAudio{"webaudio",
+                                      "audio/x-raw, format=(string)S16LE, layout=(string)interleaved, "
+                                      "channels=(int)2, rate=(int)48000",
+                                      GST_SECOND / 100, 480 * 4, 1, 0};
+
+    if (options.pipeline == "video")
+    {
+        return {kVideo};
+    }
+    if (options.pipeline == "audio")
+    {
+        return {kAudio};
+    }
+    if (options.pipeline == "webaudio")
+    {
+        return {kWebAudio};
+    }
+    return {kVideo, kAudio};
+}
+
+uint64_t getFrames(const SoakOptions &options)
+{
+    const SimulatorStatistics &statistics{firebolt::rialto::simulator::getStatistics()};
+    if (options.pipeline == "webaudio")
+    {
+        return statistics.webAudioFramesWritten.load(std::memory_order_relaxed);
+    }
+    return statistics.framesReceived.load(std::memory_order_relaxed);
+}
+
+ResourceUsage getResourceUsage(const SoakOptions &options)
+{
+    ResourceUsage usage{std::chrono::steady_clock::now(), 0, 0, getFrames(options)};
+
+    struct rusage rusage = {};
+    if (getrusage(RUSAGE_SELF, &rusage) == 0)
+    {
+        usage.cpuTimeUs = (rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000ULL + rusage.ru_utime.tv_usec +
+                          rusage.ru_stime.tv_usec;
+    }
+
+    uint64_t totalPages{0};
+    uint64_t residentPages{0};
+    std::ifstream statm{"/proc/self/statm"};
+    if (statm >> totalPages >> residentPages)
+    {
+        usage.rssKb = residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+    return usage;
+}
+
+void printReport(const ResourceUsage &start, const ResourceUsage &previous, const ResourceUsage &current,
+                 const ResourceUsage *baseline)
+{
+    const double kSeconds{std::chrono::duration<double>(current.time - previous.time).count()};
+    const uint64_t kFrames{current.frames - previous.frames};
+    const SimulatorStatistics &statistics{firebolt::rialto::simulator::getStatistics()};
+
+    fprintf(stdout,
+            "[%6" PRId64 " s] frames/s=%.1f cpu-us/frame=%.2f rss-kb=%" PRIu64 " rss-growth-kb=%" PRId64
+            " need-data=%" PRIu64 " no-space=%" PRIu64 " underflows=%" PRIu64 "\n",
+            static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(current.time - start.time).count()),
+            kSeconds > 0 ? kFrames / kSeconds : 0.0,
+            kFrames > 0 ? static_cast<double>(current.cpuTimeUs - previous.cpuTimeUs) / kFrames : 0.0, current.rssKb,
+            baseline ? static_cast<int64_t>(current.rssKb) - static_cast<int64_t>(baseline->rssKb) : 0,
+            statistics.needDataRequests.load(std::memory_order_relaxed),
+            statistics.noSpace.load(std::memory_order_relaxed), statistics.underflows.load(std::memory_order_relaxed));
+    fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    SoakOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        fprintf(stderr,
+                "Usage: %s [--pipeline=av|video|audio|webaudio] [--duration=<s>] [--report-interval=<s>] "
+                "[--simulator=<options>] [--video-frame-bytes=<n>] [--max-rss-growth-kb=<n>]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    firebolt::rialto::simulator::enable(
+        firebolt::rialto::simulator::SimulatorConfig::fromString(options.simulatorOptions));
+    gst_init(&argc, &argv);
+    registerRialtoSinks();
+
+    TestPipeline pipeline{getStreams(options)};
+    bool isSuccess{pipeline.play()};
+    const ResourceUsage kStart{getResourceUsage(options)};
+    ResourceUsage previous{kStart};
+    std::unique_ptr<ResourceUsage> baseline;
+    const auto kEnd{kStart.time + options.duration};
+    auto nextReport{kStart.time + options.reportInterval};
+
+    while (isSuccess && std::chrono::steady_clock::now() < kEnd)
+    {
+        isSuccess = pipeline.waitUntil(std::min(nextReport, kEnd));
+
+        if (std::chrono::steady_clock::now() >= nextReport)
+        {
+            const ResourceUsage kCurrent{getResourceUsage(options)};
+            printReport(kStart, previous, kCurrent, baseline.get());
+            // The first interval warms up the pools and caches, the RSS growth is measured from its end
+            if (!baseline)
+            {
+                baseline = std::make_unique<ResourceUsage>(kCurrent);
+            }
+            previous = kCurrent;
+            nextReport += options.reportInterval;
+        }
+    }
+
+    const ResourceUsage kFinal{getResourceUsage(options)};
+    pipeline.stop();
+
+    const double kSeconds{std::chrono::duration<double>(kFinal.time - kStart.time).count()};
+    const uint64_t kFrames{kFinal.frames - kStart.frames};
+    fprintf(stdout, "Summary: %.0f s, frames=%" PRIu64 " frames/s=%.1f cpu-us/frame=%.2f", kSeconds, kFrames,
+            kSeconds > 0 ? kFrames / kSeconds : 0.0,
+            kFrames > 0 ? static_cast<double>(kFinal.cpuTimeUs - kStart.cpuTimeUs) / kFrames : 0.0);
+    if (baseline)
+    {
+        const int64_t kGrowthKb{static_cast<int64_t>(kFinal.rssKb) - static_cast<int64_t>(baseline->rssKb)};
+        const double kHours{std::chrono::duration<double>(kFinal.time - baseline->time).count() / 3600};
+        fprintf(stdout, " rss-growth-kb=%" PRId64 " rss-growth-kb/h=%.1f", kGrowthKb,
+                kHours > 0 ? kGrowthKb / kHours : 0.0);
+        if (options.maxRssGrowthKb > 0 && kGrowthKb > static_cast<int64_t>(options.maxRssGrowthKb))
+        {
+            fprintf(stderr, "RSS grew by %" PRId64 " kB, more than %" PRIu64 " kB\n", kGrowthKb,
+                    options.maxRssGrowthKb);
+            isSuccess = false;
+        }
+    }
+    fprintf(stdout, "\n");
+
+    return isSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestPipeline.h"
+#include "RialtoGStreamerEMEProtectionMetadata.h"
+#include "RialtoGStreamerMSEAudioSink.h"
+#include "RialtoGStreamerMSEVideoSink.h"
+#include "RialtoGStreamerWebAudioSink.h"
+#include <gst/app/gstappsrc.h>
+#include <gst/base/gstbytewriter.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+constexpr int kMksId{1};
+constexpr uint16_t kClearBytes{16};
+constexpr size_t kKeyIdBytes{16};
+constexpr size_t kInitVectorBytes{16};
+
+std::string getPipelineDescription(const std::vector<StreamDescription> &streams)
+{
+    const std::string kSinglePath{streams.size() == 1 ? " single-path-stream=true" : ""};
+    std::string description;
+    for (const StreamDescription &stream : streams)
+    {
+        std::string sink{"rialtowebaudiosink"};
+        if (std::strcmp(stream.name, "video") == 0)
+        {
+            sink = "rialtomsevideosink" + kSinglePath;
+        }
+        else if (std::strcmp(stream.name, "audio") == 0)
+        {
+            sink = "rialtomseaudiosink" + kSinglePath;
+        }
+        description += std::string{"appsrc name="} + stream.name + " format=time block=true max-bytes=" +
+                       std::to_string(stream.frameBytes * 8) + " ! " + sink + " ";
+    }
+    return description;
+}
+
+GstBuffer *createFilledBuffer(size_t size, uint8_t value)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, size, nullptr);
+    gst_buffer_memset(buffer, 0, value, size);
+    return buffer;
+}
+
+// Attaches the CENC metadata a demuxer would, each subsample is the clear bytes (16 bits) and the encrypted bytes
+// (32 bits), big endian
+void addProtectionMetadata(GstBuffer *buffer, size_t frameBytes, unsigned int subsampleCount)
+{
+    const uint32_t kEncryptedBytes =
+        static_cast<uint32_t>(std::max<size_t>(frameBytes / subsampleCount, kClearBytes) - kClearBytes);
+    GstByteWriter *byteWriter = gst_byte_writer_new_with_size(subsampleCount * 6, TRUE);
+    for (unsigned int i = 0; i < subsampleCount; ++i)
+    {
+        gst_byte_writer_put_uint16_be(byteWriter, kClearBytes);
+        gst_byte_writer_put_uint32_be(byteWriter, kEncryptedBytes);
+    }
+    GstBuffer *subsamplesBuffer = gst_byte_writer_free_and_get_buffer(byteWriter);
+    GstBuffer *keyIdBuffer = createFilledBuffer(kKeyIdBytes, 0xab);
+    GstBuffer *initVectorBuffer = createFilledBuffer(kInitVectorBytes, 0xcd);
+
+    GstStructure *info = gst_structure_new("application/x-cenc", "encrypted", G_TYPE_BOOLEAN, TRUE, "mks_id",
+                                           G_TYPE_INT, kMksId, "kid", GST_TYPE_BUFFER, keyIdBuffer, "iv",
+                                           GST_TYPE_BUFFER, initVectorBuffer, "iv_size", G_TYPE_UINT,
+                                           static_cast<guint>(kInitVectorBytes), "subsample_count", G_TYPE_UINT,
+                                           subsampleCount, "subsamples", GST_TYPE_BUFFER, subsamplesBuffer, NULL);
+    rialto_mse_add_protection_metadata(buffer, info);
+
+    gst_buffer_unref(subsamplesBuffer);
+    gst_buffer_unref(initVectorBuffer);
+    gst_buffer_unref(keyIdBuffer);
+}
+
+void feedStream(GstAppSrc *appSrc, StreamDescription stream, const std::atomic<bool> &isRunning)
+{
+    GstCaps *caps = gst_caps_from_string(stream.caps);
+    gst_app_src_set_caps(appSrc, caps);
+    gst_caps_unref(caps);
+
+    for (uint64_t frame = 0; isRunning; ++frame)
+    {
+        GstBuffer *buffer = createFilledBuffer(stream.frameBytes, 0);
+        GST_BUFFER_PTS(buffer) = frame * stream.frameDuration;
+        GST_BUFFER_DTS(buffer) = GST_BUFFER_PTS(buffer);
+        GST_BUFFER_DURATION(buffer) = stream.frameDuration;
+        if (frame % stream.keyFrameInterval != 0)
+        {
+            GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        }
+        if (stream.subsampleCount > 0)
+        {
+            addProtectionMetadata(buffer, stream.frameBytes, stream.subsampleCount);
+        }
+
+        // Blocks while the sink is full, returns FLUSHING once the pipeline is shut down
+        if (gst_app_src_push_buffer(appSrc, buffer) != GST_FLOW_OK)
+        {
+            break;
+        }
+    }
+}
+} // namespace
+
+void registerRialtoSinks()
+{
+    gst_element_register(nullptr, "rialtomsevideosink", GST_RANK_NONE, RIALTO_TYPE_MSE_VIDEO_SINK);
+    gst_element_register(nullptr, "rialtomseaudiosink", GST_RANK_NONE, RIALTO_TYPE_MSE_AUDIO_SINK);
+    gst_element_register(nullptr, "rialtowebaudiosink", GST_RANK_NONE, RIALTO_TYPE_WEB_AUDIO_SINK);
+}
+
+TestPipeline::TestPipeline(const std::vector<StreamDescription> &streams) : m_streams{streams} {}
+
+TestPipeline::~TestPipeline()
+{
+    stop();
+}
+
+bool TestPipeline::play()
+{
+    GError *error{nullptr};
+    m_pipeline = gst_parse_launch(getPipelineDescription(m_streams).c_str(), &error);
+    if (!m_pipeline)
+    {
+        fprintf(stderr, "Failed to create the pipeline: %s\n", error ? error->message : "unknown error");
+        g_clear_error(&error);
+        return false;
+    }
+    g_clear_error(&error);
+    m_bus = gst_element_get_bus(m_pipeline);
+
+    m_isRunning = true;
+    for (const StreamDescription &stream : m_streams)
+    {
+        GstElement *appSrc = gst_bin_get_by_name(GST_BIN(m_pipeline), stream.name);
+        m_feeders.emplace_back(
+            [this, appSrc, stream]()
+            {
+                feedStream(GST_APP_SRC(appSrc), stream, m_isRunning);
+                gst_object_unref(appSrc);
+            });
+    }
+
+    return gst_element_set_state(m_pipeline, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+}
+
+bool TestPipeline::waitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    if (!m_bus)
+    {
+        return false;
+    }
+
+    const int64_t kWaitNs{std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count(), 0)};
+    GstMessage *message =
+        gst_bus_timed_pop_filtered(m_bus, kWaitNs, static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_EOS));
+    if (!message)
+    {
+        return true;
+    }
+
+    if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR)
+    {
+        GError *error{nullptr};
+        gchar *debug{nullptr};
+        gst_message_parse_error(message, &error, &debug);
+        fprintf(stderr, "Pipeline error: %s (%s)\n", error->message, debug ? debug : "");
+        g_clear_error(&error);
+        g_free(debug);
+    }
+    else
+    {
+        fprintf(stderr, "Unexpected end of stream\n");
+    }
+    gst_message_unref(message);
+    return false;
+}
+
+void TestPipeline::stop()
+{
+    m_isRunning = false;
+    if (m_pipeline)
+    {
+        gst_element_set_state(m_pipeline, GST_STATE_NULL);
+    }
+    for (std::thread &feeder : m_feeders)
+    {
+        feeder.join();
+    }
+    m_feeders.clear();
+    if (m_bus)
+    {
+        gst_object_unref(m_bus);
+        m_bus = nullptr;
+    }
+    if (m_pipeline)
+    {
+        gst_object_unref(m_pipeline);
+        m_pipeline = nullptr;
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The description of one elementary stream fed through appsrc into a rialto sink.
+ */
+struct StreamDescription
+{
+    const char *name;
+    const char *caps;
+    GstClockTime frameDuration;
+    size_t frameBytes;
+    uint32_t keyFrameInterval;
+    unsigned int subsampleCount; // Encrypted with this many CENC subsamples per frame, clear if 0
+};
+
+/**
+ * @brief Registers the rialto sinks with the GStreamer registry, so that they can be used by gst_parse_launch.
+ */
+void registerRialtoSinks();
+
+/**
+ * @brief An appsrc ! rialto sink pipeline per stream with a feeder thread pushing synthetic frames into each appsrc.
+ */
+class TestPipeline
+{
+public:
+    /**
+     * @brief The constructor.
+     *
+     * @param[in] streams : The streams to play, single streams set single-path-stream on their sink.
+     */
+    explicit TestPipeline(const std::vector<StreamDescription> &streams);
+
+    /**
+     * @brief The destructor, stops the pipeline.
+     */
+    ~TestPipeline();
+
+    TestPipeline(const TestPipeline &) = delete;
+    TestPipeline &operator=(const TestPipeline &) = delete;
+
+    /**
+     * @brief Creates the pipeline, starts the feeders and sets it to PLAYING.
+     *
+     * @retval true on success.
+     */
+    bool play();
+
+    /**
+     * @brief Waits until the deadline for an error or an end of stream.
+     *
+     * @param[in] deadline : The time to wait until.
+     *
+     * @retval false if the pipeline posted an error or an end of stream, which is reported on stderr.
+     */
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Sets the pipeline to NULL and joins the feeders.
+     */
+    void stop();
+
+private:
+    std::vector<StreamDescription> m_streams;
+    GstElement *m_pipeline{nullptr};
+    GstBus *m_bus{nullptr};
+    std::atomic<bool> m_isRunning{false};
+    std::vector<std::thread> m_feeders;
+};
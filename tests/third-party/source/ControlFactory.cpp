@@ -17,6 +17,7 @@
  */
 
 #include "ControlMock.h"
+#include "Simulator.h"
 
 using testing::StrictMock;
 
@@ -24,6 +25,10 @@ namespace firebolt::rialto
 {
 std::shared_ptr<IControlFactory> IControlFactory::createFactory()
 {
+    if (simulator::isEnabled())
+    {
+        return simulator::createControlFactory();
+    }
     static auto controlFactory{std::make_shared<StrictMock<ControlFactoryMock>>()};
     return controlFactory;
 }
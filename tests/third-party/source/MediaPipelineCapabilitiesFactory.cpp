@@ -17,6 +17,7 @@
  */
 
 #include "MediaPipelineCapabilitiesMock.h"
+#include "Simulator.h"
 
 using testing::StrictMock;
 
@@ -24,6 +25,10 @@ namespace firebolt::rialto
 {
 std::shared_ptr<IMediaPipelineCapabilitiesFactory> IMediaPipelineCapabilitiesFactory::createFactory()
 {
+    if (simulator::isEnabled())
+    {
+        return simulator::createMediaPipelineCapabilitiesFactory();
+    }
     static auto mediaPipelineCapabilitiesFactory{std::make_shared<StrictMock<MediaPipelineCapabilitiesFactoryMock>>()};
     return mediaPipelineCapabilitiesFactory;
 }
@@ -17,6 +17,7 @@
  */
 
 #include "MediaPipelineMock.h"
+#include "Simulator.h"
 
 using testing::StrictMock;
 
@@ -24,6 +25,10 @@ namespace firebolt::rialto
 {
 std::shared_ptr<IMediaPipelineFactory> IMediaPipelineFactory::createFactory()
 {
+    if (simulator::isEnabled())
+    {
+        return simulator::createMediaPipelineFactory();
+    }
     static auto mediaPipelineFactory{std::make_shared<StrictMock<MediaPipelineFactoryMock>>()};
     return mediaPipelineFactory;
 }
@@ -17,6 +17,7 @@
  */
 
 #include "WebAudioPlayerMock.h"
+#include "Simulator.h"
 
 using testing::StrictMock;
 
@@ -24,6 +25,10 @@ namespace firebolt::rialto
 {
 std::shared_ptr<IWebAudioPlayerFactory> IWebAudioPlayerFactory::createFactory()
 {
+    if (simulator::isEnabled())
+    {
+        return simulator::createWebAudioPlayerFactory();
+    }
     static auto webAudioPlayerFactory{std::make_shared<StrictMock<WebAudioPlayerFactoryMock>>()};
     return webAudioPlayerFactory;
 }
@@ -53,19 +53,15 @@ public:
 
     ~BufferParserTests() override
     {
-        gst_sample_unref(m_sample);
         gst_buffer_unref(m_buffer);
         gst_buffer_unref(m_initVectorBuffer);
         gst_buffer_unref(m_keyIdBuffer);
     }
 
-    void buildSample(GstCaps *caps) { m_sample = gst_sample_new(m_buffer, caps, nullptr, nullptr); }
-
     std::vector<uint8_t> m_bufferData{1, 2, 3, 4};
     GstBuffer *m_keyIdBuffer{nullptr};
     GstBuffer *m_initVectorBuffer{nullptr};
     GstBuffer *m_buffer{nullptr};
-    GstSample *m_sample{nullptr};
     GstMapInfo m_mapInfo{};
     GstBuffer *m_bufferCodecData{nullptr};
 
@@ -100,8 +96,7 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferCenc)
     AudioBufferParser parser;
     GstCaps *caps = gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                         kChannels, nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     EXPECT_EQ(segment->getId(), kStreamId);
     EXPECT_EQ(segment->getType(), firebolt::rialto::MediaSourceType::AUDIO);
@@ -125,8 +120,7 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferWebm)
     AudioBufferParser parser;
     GstCaps *caps = gst_caps_new_simple("application/x-webm-enc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                         kChannels, nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     EXPECT_EQ(segment->getId(), kStreamId);
     EXPECT_EQ(segment->getType(), firebolt::rialto::MediaSourceType::AUDIO);
@@ -140,8 +134,7 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferBufferCodecData)
     gst_buffer_fill(codecDataBuf, 0, kCodecDataVec.data(), kCodecDataVec.size());
     GstCaps *caps = gst_caps_new_simple("application/x-webm-enc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                         kChannels, "codec_data", GST_TYPE_BUFFER, codecDataBuf, nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     ASSERT_TRUE(segment->getCodecData());
     EXPECT_EQ(segment->getCodecData()->type, firebolt::rialto::CodecDataType::BUFFER);
@@ -155,8 +148,7 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferInvalidBufferCodecData)
     AudioBufferParser parser;
     GstCaps *caps = gst_caps_new_simple("application/x-webm-enc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                         kChannels, "codec_data", GST_TYPE_BUFFER, kCodecDataStr.c_str(), nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     EXPECT_FALSE(segment->getCodecData());
     gst_caps_unref(caps);
@@ -167,8 +159,7 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferStringCodecData)
     AudioBufferParser parser;
     GstCaps *caps = gst_caps_new_simple("application/x-webm-enc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                         kChannels, "codec_data", G_TYPE_STRING, kCodecDataStr.c_str(), nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     ASSERT_TRUE(segment->getCodecData());
     EXPECT_EQ(segment->getCodecData()->type, firebolt::rialto::CodecDataType::STRING);
@@ -176,14 +167,36 @@ TEST_F(BufferParserTests, ShouldParseAudioBufferStringCodecData)
     gst_caps_unref(caps);
 }
 
+TEST_F(BufferParserTests, ShouldReuseSegmentAndCodecDataForNextBuffer)
+{
+    AudioBufferParser parser;
+    GstBuffer *codecDataBuf{gst_buffer_new_allocate(nullptr, kCodecDataVec.size(), nullptr)};
+    gst_buffer_fill(codecDataBuf, 0, kCodecDataVec.data(), kCodecDataVec.size());
+    GstCaps *caps = gst_caps_new_simple("application/x-webm-enc", "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
+                                        kChannels, "codec_data", GST_TYPE_BUFFER, codecDataBuf, nullptr);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
+    ASSERT_TRUE(segment);
+    const firebolt::rialto::IMediaPipeline::MediaSegment *firstSegment{segment.get()};
+    const auto firstCodecData{segment->getCodecData()};
+    ASSERT_TRUE(firstCodecData);
+
+    const auto &nextSegment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
+    ASSERT_TRUE(nextSegment);
+    EXPECT_EQ(nextSegment.get(), firstSegment);
+    EXPECT_EQ(nextSegment->getCodecData(), firstCodecData);
+    EXPECT_EQ(nextSegment->getTimeStamp(), kTimestamp);
+    EXPECT_EQ(nextSegment->getCodecData()->data, kCodecDataVec);
+    gst_caps_unref(caps);
+    gst_buffer_unref(codecDataBuf);
+}
+
 TEST_F(BufferParserTests, ShouldParseVideoBuffer)
 {
     VideoBufferParser parser;
     GstCaps *caps = gst_caps_new_simple("application/x-cenc", "width", G_TYPE_INT, kWidth, "height", G_TYPE_INT,
                                         kHeight, "framerate", GST_TYPE_FRACTION, kFrameRate.numerator,
                                         kFrameRate.denominator, nullptr);
-    buildSample(caps);
-    auto segment = parser.parseBuffer(m_sample, m_buffer, m_mapInfo, kStreamId);
+    const auto &segment = parser.parseBuffer(caps, m_buffer, m_mapInfo, kStreamId);
     ASSERT_TRUE(segment);
     EXPECT_EQ(segment->getId(), kStreamId);
     EXPECT_EQ(segment->getType(), firebolt::rialto::MediaSourceType::VIDEO);
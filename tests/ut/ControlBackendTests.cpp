@@ -20,6 +20,7 @@
 #include "ControlMock.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
 
 using firebolt::rialto::ApplicationState;
 using firebolt::rialto::ControlFactoryMock;
@@ -97,3 +98,126 @@ TEST_F(ControlBackendTests, ShouldRemoveControlBackend)
     m_sut = std::make_unique<ControlBackend>();
     m_sut->removeControlBackend();
 }
+
+TEST_F(ControlBackendTests, ShouldShareControlBetweenBackends)
+{
+    std::weak_ptr<IControlClient> weakClient;
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&weakClient), SetArgReferee<1>(ApplicationState::INACTIVE), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    ControlBackend secondBackend;
+
+    auto client = weakClient.lock();
+    ASSERT_TRUE(client);
+    client->notifyApplicationState(ApplicationState::RUNNING);
+    EXPECT_TRUE(m_sut->waitForRunning());
+    EXPECT_TRUE(secondBackend.waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldRetryRegistrationWhenItFailed)
+{
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillRepeatedly(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    ControlBackend secondBackend;
+    EXPECT_TRUE(secondBackend.waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldRegisterAgainWhenWaitingForRunningAfterRemoval)
+{
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillRepeatedly(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    m_sut->removeControlBackend();
+    EXPECT_TRUE(m_sut->waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldNotifyApplicationStateUntilRemoved)
+{
+    std::weak_ptr<IControlClient> weakClient;
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&weakClient), SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    ControlBackend secondBackend;
+    std::vector<ApplicationState> states;
+    m_sut->setApplicationStateCallback([&](ApplicationState state) { states.push_back(state); });
+
+    auto client = weakClient.lock();
+    ASSERT_TRUE(client);
+    client->notifyApplicationState(ApplicationState::INACTIVE);
+    m_sut->removeControlBackend();
+    client->notifyApplicationState(ApplicationState::RUNNING);
+    EXPECT_EQ(states, std::vector<ApplicationState>{ApplicationState::INACTIVE});
+}
+
+TEST_F(ControlBackendTests, ShouldNotifyExistingBackendsWhenRetriedRegistrationSucceeds)
+{
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    std::vector<ApplicationState> states;
+    m_sut->setApplicationStateCallback([&](ApplicationState state) { states.push_back(state); });
+
+    ControlBackend secondBackend;
+    EXPECT_EQ(states, std::vector<ApplicationState>{ApplicationState::RUNNING});
+    EXPECT_TRUE(m_sut->waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldRegisterAgainWhenAllBackendsWereDestroyed)
+{
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock)).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    m_sut.reset();
+    m_sut = std::make_unique<ControlBackend>();
+    EXPECT_TRUE(m_sut->waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldAllowListenerToCreateBackendWhenRetriedRegistrationSucceeds)
+{
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    std::unique_ptr<ControlBackend> listenerBackend;
+    m_sut->setApplicationStateCallback([&](ApplicationState)
+                                       { listenerBackend = std::make_unique<ControlBackend>(); });
+
+    ControlBackend secondBackend;
+    ASSERT_TRUE(listenerBackend);
+    EXPECT_TRUE(listenerBackend->waitForRunning());
+}
+
+TEST_F(ControlBackendTests, ShouldAllowListenerToRemoveItself)
+{
+    std::weak_ptr<IControlClient> weakClient;
+    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
+    EXPECT_CALL(*m_controlMock, registerClient(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&weakClient), SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    m_sut = std::make_unique<ControlBackend>();
+    ControlBackend secondBackend;
+    std::vector<ApplicationState> states;
+    m_sut->setApplicationStateCallback(
+        [&](ApplicationState state)
+        {
+            states.push_back(state);
+            m_sut->removeControlBackend();
+        });
+
+    auto client = weakClient.lock();
+    ASSERT_TRUE(client);
+    client->notifyApplicationState(ApplicationState::INACTIVE);
+    client->notifyApplicationState(ApplicationState::RUNNING);
+    EXPECT_EQ(states, std::vector<ApplicationState>{ApplicationState::INACTIVE});
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "GStreamerMSEMediaPlayerClient.h"
+#include "MallocInterposer.h"
+#include "MediaSourceMock.h"
+#include "RialtoGStreamerMSEBaseSinkPrivate.h"
+#include "RialtoGstTest.h"
+#include <condition_variable>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <mutex>
+
+using firebolt::rialto::MediaSourceMock;
+using testing::NiceMock;
+using testing::Return;
+
+namespace
+{
+constexpr uint32_t kMaxVideoWidth{1920};
+constexpr uint32_t kMaxVideoHeight{1080};
+constexpr int32_t kSourceId{1};
+constexpr size_t kBufferSize{4096};
+constexpr unsigned int kWarmUpBursts{4};
+constexpr unsigned int kBurstSize{8};
+constexpr unsigned int kMeasuredIterations{256};
+
+/**
+ * @brief Stands in for the rialto client, without the allocations of a mock recording its calls.
+ */
+class FakeMediaPlayerClientBackend : public firebolt::rialto::client::MediaPlayerClientBackendInterface
+{
+public:
+    void createMediaPlayerBackend(std::weak_ptr<firebolt::rialto::IMediaPipelineClient>, uint32_t, uint32_t) override
+    {
+    }
+    bool isMediaPlayerBackendCreated() const override { return true; }
+    void destroyMediaPlayerBackend() override {}
+    bool attachSource(std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> &) override { return true; }
+    bool removeSource(int32_t) override { return true; }
+    bool allSourcesAttached() override { return true; }
+    bool load(firebolt::rialto::MediaType, const std::string &, const std::string &) override { return true; }
+    bool play() override { return true; }
+    bool pause() override { return true; }
+    bool stop() override { return true; }
+    bool haveData(firebolt::rialto::MediaSourceStatus status, unsigned int) override
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (status == firebolt::rialto::MediaSourceStatus::OK)
+        {
+            ++m_haveDataCount;
+        }
+        m_cv.notify_one();
+        return true;
+    }
+    bool seek(int64_t) override { return true; }
+    bool setPlaybackRate(double) override { return true; }
+    bool setVideoWindow(unsigned int, unsigned int, unsigned int, unsigned int) override { return true; }
+    firebolt::rialto::AddSegmentStatus
+    addSegment(unsigned int, const std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSegment> &) override
+    {
+        return firebolt::rialto::AddSegmentStatus::OK;
+    }
+    bool getPosition(int64_t &) override { return true; }
+    bool renderFrame() override { return true; }
+    bool setVolume(double) override { return true; }
+    bool getVolume(double &) override { return true; }
+    bool setMute(bool) override { return true; }
+    bool getMute(bool &) override { return true; }
+
+    bool waitForHaveData(unsigned int count)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        return m_cv.wait_for(lock, std::chrono::seconds{5}, [&]() { return m_haveDataCount >= count; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    unsigned int m_haveDataCount{0};
+};
+} // namespace
+
+class DataPathAllocationTests : public RialtoGstTest
+{
+public:
+    DataPathAllocationTests()
+    {
+        m_sut = std::make_shared<GStreamerMSEMediaPlayerClient>(IMessageQueueFactory::createFactory(), m_backend,
+                                                                kMaxVideoWidth, kMaxVideoHeight);
+        m_buffer = gst_buffer_new_allocate(nullptr, kBufferSize, nullptr);
+    }
+
+    ~DataPathAllocationTests() override
+    {
+        m_sut.reset();
+        if (m_sink)
+        {
+            gst_object_unref(m_sink);
+        }
+        gst_buffer_unref(m_buffer);
+    }
+
+    void attachSource(RialtoMSEBaseSink *sink, GstCaps *caps, firebolt::rialto::MediaSourceType type)
+    {
+        m_sink = sink;
+        gst_segment_init(&m_sink->priv->m_lastSegment, GST_FORMAT_TIME);
+        m_sink->priv->m_sampleTables.setCaps(caps);
+
+        std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> mediaSource{
+            std::make_unique<NiceMock<MediaSourceMock>>()};
+        mediaSource->setId(kSourceId);
+        EXPECT_CALL(static_cast<NiceMock<MediaSourceMock> &>(*mediaSource), getType()).WillRepeatedly(Return(type));
+        ASSERT_TRUE(m_sut->attachSource(mediaSource, m_sink));
+    }
+
+    // Queues frames in the sink and lets the server ask for them, one request at a time as the server does
+    void pushFrames(unsigned int count)
+    {
+        GST_BUFFER_PTS(m_buffer) = m_requestId * GST_MSECOND;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            rialto_mse_base_sink_chain(m_sink->priv->m_sinkPad, GST_OBJECT_CAST(m_sink), gst_buffer_ref(m_buffer));
+        }
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            m_sut->notifyNeedMediaData(kSourceId, 1, ++m_requestId, nullptr);
+            m_isDelivered = m_backend->waitForHaveData(m_requestId) && m_isDelivered;
+        }
+    }
+
+    void expectNoAllocationsInSteadyState()
+    {
+        // Lets the pools and the queues grow to their working size
+        for (unsigned int burst = 0; burst < kWarmUpBursts; ++burst)
+        {
+            pushFrames(kBurstSize);
+        }
+
+        const uint64_t kAllocationsBefore{getHeapUsage().allocations};
+        for (unsigned int i = 0; i < kMeasuredIterations; ++i)
+        {
+            pushFrames(1);
+        }
+        const uint64_t kAllocationsAfter{getHeapUsage().allocations};
+
+        EXPECT_TRUE(m_isDelivered);
+        EXPECT_EQ(kAllocationsAfter - kAllocationsBefore, 0u);
+    }
+
+    std::shared_ptr<FakeMediaPlayerClientBackend> m_backend{std::make_shared<FakeMediaPlayerClientBackend>()};
+    std::shared_ptr<GStreamerMSEMediaPlayerClient> m_sut;
+    RialtoMSEBaseSink *m_sink{nullptr};
+    GstBuffer *m_buffer{nullptr};
+    unsigned int m_requestId{0};
+    bool m_isDelivered{true};
+};
+
+TEST_F(DataPathAllocationTests, ShouldNotAllocateWhenDeliveringAudio)
+{
+    attachSource(createAudioSink(),
+                 gst_caps_new_simple("audio/mpeg", "mpegversion", G_TYPE_INT, 4, "rate", G_TYPE_INT, 48000,
+                                     "channels", G_TYPE_INT, 2, nullptr),
+                 firebolt::rialto::MediaSourceType::AUDIO);
+    expectNoAllocationsInSteadyState();
+}
+
+TEST_F(DataPathAllocationTests, ShouldNotAllocateWhenDeliveringVideoWithCodecData)
+{
+    GstBuffer *codecData{gst_buffer_new_allocate(nullptr, 32, nullptr)};
+    attachSource(createVideoSink(),
+                 gst_caps_new_simple("video/x-h264", "width", G_TYPE_INT, 1920, "height", G_TYPE_INT, 1080,
+                                     "framerate", GST_TYPE_FRACTION, 25, 1, "codec_data", GST_TYPE_BUFFER, codecData,
+                                     nullptr),
+                 firebolt::rialto::MediaSourceType::VIDEO);
+    gst_buffer_unref(codecData);
+    expectNoAllocationsInSteadyState();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FlightRecorder.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+
+class FlightRecorderTests : public testing::Test
+{
+public:
+    FlightRecorderTests() : m_dumpFilePath{testing::TempDir() + "rialto-flight-recorder.bin"}
+    {
+        std::remove(m_dumpFilePath.c_str());
+    }
+
+    ~FlightRecorderTests() override { std::remove(m_dumpFilePath.c_str()); }
+
+    std::vector<char> readDumpFile()
+    {
+        std::ifstream file{m_dumpFilePath, std::ios::binary};
+        return std::vector<char>{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+protected:
+    const std::string m_dumpFilePath;
+    FlightRecorder m_sut;
+};
+
+TEST_F(FlightRecorderTests, ShouldBeEmptyInitially)
+{
+    EXPECT_TRUE(m_sut.getEntries().empty());
+}
+
+TEST_F(FlightRecorderTests, ShouldRecordEventsInOrder)
+{
+    m_sut.record(FlightRecorderEvent::NEED_DATA, 24, 1);
+    m_sut.record(FlightRecorderEvent::SEGMENT, 1024, 40000000);
+    m_sut.record(FlightRecorderEvent::UNDERFLOW);
+
+    const std::vector<FlightRecorderEntry> kEntries{m_sut.getEntries()};
+    ASSERT_EQ(kEntries.size(), 3u);
+    EXPECT_EQ(kEntries[0].event, static_cast<uint32_t>(FlightRecorderEvent::NEED_DATA));
+    EXPECT_EQ(kEntries[0].value1, 24);
+    EXPECT_EQ(kEntries[0].value2, 1);
+    EXPECT_EQ(kEntries[1].event, static_cast<uint32_t>(FlightRecorderEvent::SEGMENT));
+    EXPECT_EQ(kEntries[1].value1, 1024);
+    EXPECT_EQ(kEntries[1].value2, 40000000);
+    EXPECT_EQ(kEntries[2].event, static_cast<uint32_t>(FlightRecorderEvent::UNDERFLOW));
+    EXPECT_LE(kEntries[0].timeNs, kEntries[1].timeNs);
+    EXPECT_LE(kEntries[1].timeNs, kEntries[2].timeNs);
+}
+
+TEST_F(FlightRecorderTests, ShouldKeepOnlyLastEventsWhenFull)
+{
+    constexpr int64_t kRecordedEvents{FlightRecorder::kCapacity + 10};
+    for (int64_t i = 0; i < kRecordedEvents; ++i)
+    {
+        m_sut.record(FlightRecorderEvent::QUEUE_LEVEL, i);
+    }
+
+    const std::vector<FlightRecorderEntry> kEntries{m_sut.getEntries()};
+    ASSERT_EQ(kEntries.size(), FlightRecorder::kCapacity);
+    EXPECT_EQ(kEntries.front().value1, 10);
+    EXPECT_EQ(kEntries.back().value1, kRecordedEvents - 1);
+}
+
+TEST_F(FlightRecorderTests, ShouldDumpEntriesToFile)
+{
+    m_sut.record(FlightRecorderEvent::SEEK, 5000000000);
+    m_sut.record(FlightRecorderEvent::ERROR);
+
+    ASSERT_TRUE(m_sut.dump(m_dumpFilePath));
+
+    const std::vector<char> kDump{readDumpFile()};
+    constexpr size_t kHeaderSize{16};
+    ASSERT_EQ(kDump.size(), kHeaderSize + 2 * sizeof(FlightRecorderEntry));
+    EXPECT_EQ(std::memcmp(kDump.data(), "RFR1", 4), 0);
+    uint32_t entrySize{0};
+    uint32_t entryCount{0};
+    std::memcpy(&entrySize, kDump.data() + 4, sizeof(entrySize));
+    std::memcpy(&entryCount, kDump.data() + 8, sizeof(entryCount));
+    EXPECT_EQ(entrySize, sizeof(FlightRecorderEntry));
+    EXPECT_EQ(entryCount, 2u);
+
+    FlightRecorderEntry entry{};
+    std::memcpy(&entry, kDump.data() + kHeaderSize, sizeof(entry));
+    EXPECT_EQ(entry.event, static_cast<uint32_t>(FlightRecorderEvent::SEEK));
+    EXPECT_EQ(entry.value1, 5000000000);
+}
+
+TEST_F(FlightRecorderTests, ShouldFailToDumpToInvalidPath)
+{
+    m_sut.record(FlightRecorderEvent::ERROR);
+    EXPECT_FALSE(m_sut.dump("/nonexistent-dir/rialto-flight-recorder.bin"));
+}
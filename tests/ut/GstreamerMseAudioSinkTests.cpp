@@ -70,7 +70,7 @@ TEST_F(GstreamerMseAudioSinkTests, ShouldNotHandleUnknownEvent)
     RialtoMSEBaseSink *audioSink = createAudioSink();
     GstElement *pipeline = createPipelineWithSink(audioSink);
 
-    EXPECT_EQ(GST_STATE_CHANGE_SUCCESS, gst_element_set_state(pipeline, GST_STATE_READY));
+    setReadyState(pipeline);
 
     gst_pad_set_active(audioSink->priv->m_sinkPad, TRUE);
     gst_pad_send_event(audioSink->priv->m_sinkPad, gst_event_new_gap(1, 1));
@@ -85,7 +85,7 @@ TEST_F(GstreamerMseAudioSinkTests, ShouldNotAttachSourceWhenPipelineIsBelowPause
     RialtoMSEBaseSink *audioSink = createAudioSink();
     GstElement *pipeline = createPipelineWithSink(audioSink);
 
-    EXPECT_EQ(GST_STATE_CHANGE_SUCCESS, gst_element_set_state(pipeline, GST_STATE_READY));
+    setReadyState(pipeline);
 
     gst_pad_set_active(audioSink->priv->m_sinkPad, TRUE);
     GstCaps *caps{createDefaultCaps()};
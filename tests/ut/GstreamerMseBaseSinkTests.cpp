@@ -19,6 +19,10 @@
 #include "Matchers.h"
 #include "RialtoGStreamerMSEBaseSinkPrivate.h"
 #include "RialtoGstTest.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
 
 using testing::_;
 using testing::DoAll;
@@ -211,6 +215,67 @@ TEST_F(GstreamerMseBaseSinkTests, ShouldGetHasDrmProperty)
     gst_object_unref(audioSink);
 }
 
+TEST_F(GstreamerMseBaseSinkTests, ShouldGetStatsProperty)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    audioSink->priv->m_statistics.recordNeedData(24);
+    audioSink->priv->m_statistics.recordUnderflow();
+    GstStructure *stats{nullptr};
+    g_object_get(audioSink, "stats", &stats, nullptr);
+    ASSERT_TRUE(stats);
+    guint64 value{0};
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "queued-samples", &value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "frames-requested", &value));
+    EXPECT_EQ(value, 24u);
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "underflows", &value));
+    EXPECT_EQ(value, 1u);
+    gst_structure_free(stats);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldSetAndGetQueueWatermarkProperties)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    guint highWatermark{0};
+    guint lowWatermark{0};
+    g_object_get(audioSink, "queue-high-watermark", &highWatermark, "queue-low-watermark", &lowWatermark, nullptr);
+    EXPECT_EQ(highWatermark, RialtoMSEBaseSinkPrivate::kDefaultQueueHighWatermark);
+    EXPECT_EQ(lowWatermark, RialtoMSEBaseSinkPrivate::kDefaultQueueLowWatermark);
+
+    g_object_set(audioSink, "queue-high-watermark", 8u, "queue-low-watermark", 4u, nullptr);
+    g_object_get(audioSink, "queue-high-watermark", &highWatermark, "queue-low-watermark", &lowWatermark, nullptr);
+    EXPECT_EQ(highWatermark, 8u);
+    EXPECT_EQ(lowWatermark, 4u);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldDumpFlightRecorderWithActionSignal)
+{
+    setenv("RIALTO_FLIGHT_RECORDER_DIR", testing::TempDir().c_str(), 1);
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    audioSink->priv->m_flightRecorder.record(FlightRecorderEvent::UNDERFLOW);
+    gchar *filePath{nullptr};
+    g_signal_emit_by_name(audioSink, "dump-flight-recorder", &filePath);
+    ASSERT_TRUE(filePath);
+    EXPECT_TRUE(g_file_test(filePath, G_FILE_TEST_EXISTS));
+    std::remove(filePath);
+    g_free(filePath);
+    gst_object_unref(audioSink);
+    unsetenv("RIALTO_FLIGHT_RECORDER_DIR");
+}
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldNotDumpFlightRecorderWhenDisabled)
+{
+    setenv("RIALTO_FLIGHT_RECORDER_DIR", "", 1);
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    gchar *filePath{nullptr};
+    g_signal_emit_by_name(audioSink, "dump-flight-recorder", &filePath);
+    EXPECT_FALSE(filePath);
+    gst_object_unref(audioSink);
+    unsetenv("RIALTO_FLIGHT_RECORDER_DIR");
+}
+
 TEST_F(GstreamerMseBaseSinkTests, ShouldSetLocationProperty)
 {
     RialtoMSEBaseSink *audioSink = createAudioSink();
@@ -458,10 +523,9 @@ TEST_F(GstreamerMseBaseSinkTests, ShouldWaitAndAddBufferInChainFunction)
     RialtoMSEBaseSink *audioSink = createAudioSink();
     GstBuffer *buffer = gst_buffer_new();
 
-    for (int i = 0; i < 24; ++i)
+    for (size_t i = 0; i < RialtoMSEBaseSinkPrivate::kDefaultQueueHighWatermark; ++i)
     {
-        audioSink->priv->m_samples.push(
-            gst_sample_new(buffer, audioSink->priv->m_caps, &audioSink->priv->m_lastSegment, nullptr));
+        audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
     }
 
     std::thread t{
@@ -471,8 +535,43 @@ TEST_F(GstreamerMseBaseSinkTests, ShouldWaitAndAddBufferInChainFunction)
         }};
     EXPECT_TRUE(t.joinable());
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (size_t i = RialtoMSEBaseSinkPrivate::kDefaultQueueLowWatermark;
+         i < RialtoMSEBaseSinkPrivate::kDefaultQueueHighWatermark; ++i)
+    {
+        rialto_mse_base_sink_pop_sample(audioSink);
+    }
+    t.join();
+
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldWakeChainFunctionOnlyAtLowWatermark)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    g_object_set(audioSink, "queue-high-watermark", 4u, "queue-low-watermark", 2u, nullptr);
+    GstBuffer *buffer = gst_buffer_new();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    }
+
+    std::atomic<bool> isBufferQueued{false};
+    std::thread t{[&]()
+                  {
+                      EXPECT_EQ(GST_FLOW_OK, rialto_mse_base_sink_chain(audioSink->priv->m_sinkPad,
+                                                                        GST_OBJECT_CAST(audioSink), buffer));
+                      isBufferQueued = true;
+                  }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rialto_mse_base_sink_pop_sample(audioSink);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(isBufferQueued);
+
     rialto_mse_base_sink_pop_sample(audioSink);
     t.join();
+    EXPECT_TRUE(isBufferQueued);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 3u);
 
     gst_object_unref(audioSink);
 }
@@ -512,13 +611,13 @@ TEST_F(GstreamerMseBaseSinkTests, ShouldHandleCapsEvent)
 
     GstCaps *caps{createAudioCaps()};
     setCaps(audioSink, caps);
-    EXPECT_TRUE(gst_caps_is_equal(caps, audioSink->priv->m_caps));
+    EXPECT_TRUE(gst_caps_is_equal(caps, audioSink->priv->m_sampleTables.getCurrentCaps()));
 
     GstCaps *newCaps{gst_caps_new_simple("audio/x-eac3", "mpegversion", G_TYPE_INT, 2, "channels", G_TYPE_INT,
                                          kChannels, "rate", G_TYPE_INT, kRate, nullptr)};
     EXPECT_TRUE(rialto_mse_base_sink_event(audioSink->priv->m_sinkPad, GST_OBJECT_CAST(audioSink),
                                            gst_event_new_caps(newCaps)));
-    EXPECT_TRUE(gst_caps_is_equal(newCaps, audioSink->priv->m_caps));
+    EXPECT_TRUE(gst_caps_is_equal(newCaps, audioSink->priv->m_sampleTables.getCurrentCaps()));
 
     setNullState(pipeline, kSourceId);
     gst_caps_unref(newCaps);
@@ -875,3 +974,51 @@ TEST_F(GstreamerMseBaseSinkTests, ShouldAttachSourceWithNalSegmentAlignment)
     gst_caps_unref(caps);
     gst_object_unref(pipeline);
 }
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldRetainSentSamplesFromKeyFrameAndRestoreThem)
+{
+    constexpr size_t kBufferSize{10};
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    audioSink->priv->m_retainLimitBytes = 2 * kBufferSize + kBufferSize / 2;
+
+    for (GstClockTime pts = 0; pts < 4; ++pts)
+    {
+        GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBufferSize, nullptr);
+        GST_BUFFER_PTS(buffer) = pts;
+        if (pts % 2)
+        {
+            GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        }
+        EXPECT_EQ(GST_FLOW_OK,
+                  rialto_mse_base_sink_chain(audioSink->priv->m_sinkPad, GST_OBJECT_CAST(audioSink), buffer));
+        rialto_mse_base_sink_pop_sample(audioSink);
+    }
+
+    // The first group of pictures is dropped when over the limit
+    ASSERT_EQ(audioSink->priv->m_retainedSamples.size(), 2);
+    EXPECT_EQ(audioSink->priv->m_retainedBytes, 2 * kBufferSize);
+
+    EXPECT_EQ(rialto_mse_base_sink_restore_retained_samples(audioSink, 3), 2);
+    EXPECT_TRUE(audioSink->priv->m_retainedSamples.empty());
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 2);
+    GstBuffer *buffer = nullptr;
+    GstCaps *caps = nullptr;
+    ASSERT_TRUE(rialto_mse_base_sink_get_front_sample(audioSink, &buffer, &caps));
+    EXPECT_EQ(GST_BUFFER_PTS(buffer), 2);
+
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseBaseSinkTests, ShouldNotRetainSamplesByDefault)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstBuffer *buffer = gst_buffer_new();
+
+    EXPECT_EQ(GST_FLOW_OK, rialto_mse_base_sink_chain(audioSink->priv->m_sinkPad, GST_OBJECT_CAST(audioSink), buffer));
+    rialto_mse_base_sink_pop_sample(audioSink);
+
+    EXPECT_TRUE(audioSink->priv->m_retainedSamples.empty());
+    EXPECT_EQ(rialto_mse_base_sink_restore_retained_samples(audioSink, 0), GST_CLOCK_TIME_NONE);
+
+    gst_object_unref(audioSink);
+}
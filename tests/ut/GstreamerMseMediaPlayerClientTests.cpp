@@ -140,6 +140,13 @@ public:
     std::shared_ptr<GStreamerMSEMediaPlayerClient> m_sut;
 };
 
+class GstreamerMseMediaPlayerClientSuspendTests : public GstreamerMseMediaPlayerClientTests
+{
+public:
+    static void SetUpTestSuite() { setenv("RIALTO_SUSPEND_RETAIN_BYTES", "1000000", 1); }
+    static void TearDownTestSuite() { unsetenv("RIALTO_SUSPEND_RETAIN_BYTES"); }
+};
+
 TEST_F(GstreamerMseMediaPlayerClientTests, ShouldDestroyBackend)
 {
     expectCallInEventLoop();
@@ -270,17 +277,14 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToNotifyNeedMediaDataWhenSo
     m_sut->notifyNeedMediaData(kUnknownSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
 }
 
-TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToNotifyNeedMediaDataWhenBufferPullerFails)
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldDropNeedMediaDataWhenBufferPullerIsStopped)
 {
     RialtoMSEBaseSink *audioSink = createAudioSink();
     auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
     const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
 
-    expectCallInEventLoop();
-    expectPostMessage();
+    // A seek stopped the puller, the server sends new requests after the seek so no answer is expected
     EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_)).WillOnce(Return(false));
-    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::ERROR, kNeedDataRequestId))
-        .WillOnce(Return(true));
     m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
 
     gst_object_unref(audioSink);
@@ -335,7 +339,7 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotifyNeedMediaDataWithEos)
 TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotifyNeedMediaDataWithEmptySample)
 {
     RialtoMSEBaseSink *audioSink = createAudioSink();
-    audioSink->priv->m_samples.push(gst_sample_new(nullptr, nullptr, nullptr, nullptr));
+    audioSink->priv->m_samples.push(SampleRecord{});
     auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
     const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
 
@@ -361,7 +365,8 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotifyNeedMediaDataWithNoSpace)
     RialtoMSEBaseSink *audioSink = createAudioSink();
     GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
     GstBuffer *buffer{gst_buffer_new()};
-    audioSink->priv->m_samples.push(gst_sample_new(buffer, caps, nullptr, nullptr));
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
     auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
     const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
 
@@ -391,12 +396,252 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotifyNeedMediaData)
     RialtoMSEBaseSink *audioSink = createAudioSink();
     GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
     GstBuffer *buffer{gst_buffer_new()};
-    audioSink->priv->m_samples.push(gst_sample_new(buffer, caps, nullptr, nullptr));
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::OK, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotPullNeedDataRequestReceivedTwice)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    std::shared_ptr<Message> pullBufferMessage;
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [&](const auto &msg)
+            {
+                pullBufferMessage = msg;
+                return true;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+
+    ASSERT_TRUE(pullBufferMessage);
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    pullBufferMessage->handle();
+
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldAnswerSupersededNeedDataRequestWithoutPulling)
+{
+    constexpr uint32_t kNextNeedDataRequestId{kNeedDataRequestId + 1};
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    std::vector<std::shared_ptr<Message>> pullBufferMessages;
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                pullBufferMessages.push_back(msg);
+                return true;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNextNeedDataRequestId, kShmInfo);
+
+    ASSERT_EQ(pullBufferMessages.size(), 2u);
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNextNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::OK, kNextNeedDataRequestId))
+        .WillOnce(Return(true));
+    pullBufferMessages[0]->handle();
+    pullBufferMessages[1]->handle();
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotSupersedeNeedDataRequestWithOlderOneSentAgainByBackendThread)
+{
+    constexpr uint32_t kNextNeedDataRequestId{kNeedDataRequestId + 1};
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, seek(kPosition)).WillOnce(Return(true));
+    m_sut->seek(kPosition);
+    m_sut->notifySourceStartedSeeking(kSourceId);
+
+    // The request received during the seek is left on the backend thread until the next one took the fast path
+    std::shared_ptr<Message> needDataMessage;
+    EXPECT_CALL(m_messageQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [&](const auto &msg)
+            {
+                needDataMessage = msg;
+                return true;
+            }))
+        .WillRepeatedly(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+    EXPECT_CALL(bufferPullerMsgQueueMock, start());
+    EXPECT_CALL(bufferPullerMsgQueueMock, stop());
+    m_sut->notifyPlaybackState(firebolt::rialto::PlaybackState::FLUSHED);
+
+    std::vector<std::shared_ptr<Message>> pullBufferMessages;
+    expectCallInEventLoop();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                pullBufferMessages.push_back(msg);
+                return true;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNextNeedDataRequestId, kShmInfo);
+    ASSERT_TRUE(needDataMessage);
+    needDataMessage->handle();
+
+    // The newer request takes the samples although it was posted first, the older one is answered without them
+    ASSERT_EQ(pullBufferMessages.size(), 2u);
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNextNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::OK, kNextNeedDataRequestId))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::NO_AVAILABLE_SAMPLES, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    pullBufferMessages[0]->handle();
+    pullBufferMessages[1]->handle();
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToCancelNeedMediaDataWhenSourceIsNotKnown)
+{
+    expectCallInEventLoop();
+    expectPostMessage();
+    m_sut->notifyCancelNeedMediaData(kUnknownSourceId);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldSkipCancelledNeedDataRequest)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    std::shared_ptr<Message> pullBufferMessage;
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [&](const auto &msg)
+            {
+                pullBufferMessage = msg;
+                return true;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+    m_sut->notifyCancelNeedMediaData(kSourceId);
+
+    // Neither addSegment nor haveData is expected by the strict mock
+    ASSERT_TRUE(pullBufferMessage);
+    pullBufferMessage->handle();
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 1u);
+
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldStopPullingWhenNeedDataRequestIsCancelled)
+{
+    constexpr size_t kTwoFrames{2};
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
     auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
     const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
 
     expectCallInEventLoop();
     expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNeedDataRequestId, _))
+        .WillOnce(Invoke(
+            [&](auto, const auto &)
+            {
+                m_sut->notifyCancelNeedMediaData(kSourceId);
+                return firebolt::rialto::AddSegmentStatus::OK;
+            }));
+    m_sut->notifyNeedMediaData(kSourceId, kTwoFrames, kNeedDataRequestId, kShmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 1u);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldPullNeedDataRequestWithoutBackendThread)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    EXPECT_CALL(m_messageQueueMock, postMessage(_)).Times(0);
+    EXPECT_CALL(m_messageQueueMock, callInEventLoop(_)).Times(0);
     EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
         .WillOnce(Invoke(
             [](const auto &msg)
@@ -415,6 +660,226 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotifyNeedMediaData)
     gst_object_unref(audioSink);
 }
 
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotPullNeedDataRequestWhileSeeking)
+{
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    bufferPullerWillBeCreated();
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, seek(kPosition)).WillOnce(Return(true));
+    m_sut->seek(kPosition);
+
+    // The request goes through the backend thread, which answers it with an error until the seek is finished
+    expectPostMessage();
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::ERROR, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kFrameCount, kNeedDataRequestId, kShmInfo);
+
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldLeaveSampleWhichDoesNotFitInSharedMemoryForNextRequest)
+{
+    constexpr size_t kTwoFrames{2};
+    constexpr size_t kSampleBytes{768};
+    auto shmInfo{std::make_shared<firebolt::rialto::MediaPlayerShmInfo>()};
+    shmInfo->maxMediaBytes = 1024;
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new_allocate(nullptr, kSampleBytes, nullptr)};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .WillOnce(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::OK, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kTwoFrames, kNeedDataRequestId, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 1u);
+
+    GstStructure *stats{audioSink->priv->m_statistics.createStructure(0, 0, 0)};
+    guint64 bytesPending{0};
+    guint64 noSpace{0};
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "bytes-pending", &bytesPending));
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "no-space", &noSpace));
+    EXPECT_EQ(bytesPending, kSampleBytes);
+    EXPECT_EQ(noSpace, 0u);
+    gst_structure_free(stats);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldPlanNextRequestFromLearntMetadataSpace)
+{
+    constexpr size_t kThreeFrames{3};
+    constexpr uint32_t kNextNeedDataRequestId{kNeedDataRequestId + 1};
+    auto shmInfo{std::make_shared<firebolt::rialto::MediaPlayerShmInfo>()};
+    shmInfo->maxMetadataBytes = 100;
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    for (size_t i = 0; i < kThreeFrames; ++i)
+    {
+        audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    }
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+
+    // The metadata of the second segment does not fit, so a request only takes one segment from then on
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::NO_SPACE));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::OK, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, kNeedDataRequestId, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 2u);
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNextNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::OK, kNextNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, kNextNeedDataRequestId, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 1u);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldForgetLearntMetadataSpaceWhenNeedDataIsCancelled)
+{
+    constexpr size_t kThreeFrames{3};
+    constexpr uint32_t kNextNeedDataRequestId{kNeedDataRequestId + 1};
+    auto shmInfo{std::make_shared<firebolt::rialto::MediaPlayerShmInfo>()};
+    shmInfo->maxMetadataBytes = 100;
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    for (size_t i = 0; i < kThreeFrames + 1; ++i)
+    {
+        audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    }
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNeedDataRequestId, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::NO_SPACE));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::OK, kNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, kNeedDataRequestId, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), kThreeFrames);
+
+    // The segments after a seek or a flush may differ, so the next request is planned without the learnt size
+    m_sut->notifyCancelNeedMediaData(kSourceId);
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(kNextNeedDataRequestId, _))
+        .Times(kThreeFrames)
+        .WillRepeatedly(Return(firebolt::rialto::AddSegmentStatus::OK));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock,
+                haveData(firebolt::rialto::MediaSourceStatus::OK, kNextNeedDataRequestId))
+        .WillOnce(Return(true));
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, kNextNeedDataRequestId, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), 0u);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldLowerLearntMetadataSpaceAfterRequestsWhichFitted)
+{
+    constexpr size_t kThreeFrames{3};
+    constexpr size_t kFittedRequests{16};
+    constexpr size_t kSamples{20};
+    auto shmInfo{std::make_shared<firebolt::rialto::MediaPlayerShmInfo>()};
+    shmInfo->maxMetadataBytes = 100;
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    GstCaps *caps{gst_caps_new_simple("application/x-cenc", "rate", G_TYPE_INT, 1, "channels", G_TYPE_INT, 2, nullptr)};
+    GstBuffer *buffer{gst_buffer_new()};
+    audioSink->priv->m_sampleTables.setCaps(gst_caps_ref(caps));
+    for (size_t i = 0; i < kSamples; ++i)
+    {
+        audioSink->priv->m_samples.push(audioSink->priv->m_sampleTables.createRecord(gst_buffer_ref(buffer)));
+    }
+    auto &bufferPullerMsgQueueMock{bufferPullerWillBeCreated()};
+    const int32_t kSourceId{attachSource(audioSink, firebolt::rialto::MediaSourceType::AUDIO)};
+
+    expectCallInEventLoop();
+    expectPostMessage();
+    EXPECT_CALL(bufferPullerMsgQueueMock, postMessage(_))
+        .Times(kFittedRequests + 2)
+        .WillRepeatedly(Invoke(
+            [](const auto &msg)
+            {
+                msg->handle();
+                return true;
+            }));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, haveData(firebolt::rialto::MediaSourceStatus::OK, _))
+        .Times(kFittedRequests + 2)
+        .WillRepeatedly(Return(true));
+
+    // The second segment does not fit, so the requests which follow only take one segment
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, addSegment(_, _))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::OK))
+        .WillOnce(Return(firebolt::rialto::AddSegmentStatus::NO_SPACE))
+        .WillRepeatedly(Return(firebolt::rialto::AddSegmentStatus::OK));
+    uint32_t needDataRequestId{kNeedDataRequestId};
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, needDataRequestId++, shmInfo);
+    for (size_t i = 0; i < kFittedRequests; ++i)
+    {
+        m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, needDataRequestId++, shmInfo);
+    }
+    EXPECT_EQ(audioSink->priv->m_samples.size(), kSamples - kFittedRequests - 1);
+
+    // Once enough requests fitted, the estimate is lowered and a request takes two segments again
+    m_sut->notifyNeedMediaData(kSourceId, kThreeFrames, needDataRequestId++, shmInfo);
+    EXPECT_EQ(audioSink->priv->m_samples.size(), kSamples - kFittedRequests - 3);
+
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    gst_object_unref(audioSink);
+}
+
 TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToNotifyQosWhenSourceIdIsNotKnown)
 {
     expectPostMessage();
@@ -496,6 +961,74 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldCreateBackend)
     EXPECT_TRUE(m_sut->createBackend());
 }
 
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToPrepareForReuseWhenBackendIsNotCreated)
+{
+    expectCallInEventLoop();
+    EXPECT_FALSE(m_sut->prepareForReuse());
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldOnlyLoadBackendWhenReused)
+{
+    expectCallInEventLoop();
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, createMediaPlayerBackend(_, kMaxVideoWidth, kMaxVideoHeight));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, isMediaPlayerBackendCreated()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, load(kMediaType, kMimeType, kUrl)).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->createBackend());
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, stop()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->prepareForReuse());
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, load(kMediaType, kMimeType, kUrl)).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->createBackend());
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotWaitForSynchronouslyCreatedBackend)
+{
+    EXPECT_TRUE(m_sut->waitForBackend());
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldCreateBackendAsynchronously)
+{
+    std::shared_ptr<Message> createBackendMessage;
+    EXPECT_CALL(m_messageQueueMock, postMessage(_)).WillOnce(Invoke(
+        [&](const auto &msg)
+        {
+            createBackendMessage = msg;
+            return true;
+        }));
+    m_sut->createBackendAsync();
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, createMediaPlayerBackend(_, kMaxVideoWidth, kMaxVideoHeight));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, isMediaPlayerBackendCreated()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, load(kMediaType, kMimeType, kUrl)).WillOnce(Return(true));
+    ASSERT_TRUE(createBackendMessage);
+    createBackendMessage->handle();
+    EXPECT_TRUE(m_sut->waitForBackend());
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToCreateBackendAsynchronouslyWhenQueueIsStopped)
+{
+    EXPECT_CALL(m_messageQueueMock, postMessage(_)).WillOnce(Return(false));
+    m_sut->createBackendAsync();
+    EXPECT_FALSE(m_sut->waitForBackend());
+}
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldFailToCreateBackendAsynchronouslyWhenMessageIsSkipped)
+{
+    std::shared_ptr<Message> createBackendMessage;
+    EXPECT_CALL(m_messageQueueMock, postMessage(_)).WillOnce(Invoke(
+        [&](const auto &msg)
+        {
+            createBackendMessage = msg;
+            return true;
+        }));
+    m_sut->createBackendAsync();
+
+    ASSERT_TRUE(createBackendMessage);
+    createBackendMessage->skip();
+    EXPECT_FALSE(m_sut->waitForBackend());
+}
+
 TEST_F(GstreamerMseMediaPlayerClientTests, ShouldPlay)
 {
     expectCallInEventLoop();
@@ -824,3 +1357,75 @@ TEST_F(GstreamerMseMediaPlayerClientTests, ShouldAttachAllSources)
     gst_object_unref(audioSink);
     gst_object_unref(videoSink);
 }
+
+TEST_F(GstreamerMseMediaPlayerClientTests, ShouldNotSuspendWhenSamplesAreNotRetained)
+{
+    expectPostMessage();
+    expectCallInEventLoop();
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, createMediaPlayerBackend(_, kMaxVideoWidth, kMaxVideoHeight));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, isMediaPlayerBackendCreated()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, load(kMediaType, kMimeType, kUrl)).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->createBackend());
+
+    m_sut->suspend();
+    m_sut->resume();
+}
+
+TEST_F(GstreamerMseMediaPlayerClientSuspendTests, ShouldReleaseServerPipelineWhenSuspendedAndAttachSourcesWhenResumed)
+{
+    constexpr int32_t kSourceId{10};
+    constexpr int32_t kNewSourceId{11};
+    expectPostMessage();
+    expectCallInEventLoop();
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, createMediaPlayerBackend(_, kMaxVideoWidth, kMaxVideoHeight)).Times(2);
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, isMediaPlayerBackendCreated()).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, load(kMediaType, kMimeType, kUrl))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_TRUE(m_sut->createBackend());
+    m_sut->setAudioStreamsInfo(1, true);
+
+    RialtoMSEBaseSink *audioSink = createAudioSink();
+    std::unique_ptr<StrictMock<MessageQueueMock>> bufferPullerMessageQueue{
+        std::make_unique<StrictMock<MessageQueueMock>>()};
+    EXPECT_CALL(*bufferPullerMessageQueue, start());
+    EXPECT_CALL(*bufferPullerMessageQueue, stop()).Times(2);
+    EXPECT_CALL(*m_messageQueueFactoryMock, createMessageQueue())
+        .WillOnce(Return(ByMove(std::move(bufferPullerMessageQueue))));
+
+    std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> mediaSource{
+        std::make_unique<StrictMock<MediaSourceMock>>()};
+    mediaSource->setId(kSourceId);
+    StrictMock<MediaSourceMock> &mediaSourceMock{static_cast<StrictMock<MediaSourceMock> &>(*mediaSource)};
+    std::unique_ptr<StrictMock<MediaSourceMock>> sourceCopy{std::make_unique<StrictMock<MediaSourceMock>>()};
+    std::unique_ptr<StrictMock<MediaSourceMock>> sourceToAttachAgain{std::make_unique<StrictMock<MediaSourceMock>>()};
+    MediaSourceMock *sourceToAttachAgainPtr{sourceToAttachAgain.get()};
+    EXPECT_CALL(mediaSourceMock, getType()).WillRepeatedly(Return(firebolt::rialto::MediaSourceType::AUDIO));
+    EXPECT_CALL(*sourceCopy, copy()).WillOnce(Return(ByMove(std::move(sourceToAttachAgain))));
+    EXPECT_CALL(mediaSourceMock, copy()).WillOnce(Return(ByMove(std::move(sourceCopy))));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, attachSource(PtrMatcher(mediaSource.get()))).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, allSourcesAttached()).Times(2).WillRepeatedly(Return(true));
+    EXPECT_TRUE(m_sut->attachSource(mediaSource, audioSink));
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, getPosition(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kPosition), Return(true)));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, stop()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, destroyMediaPlayerBackend());
+    m_sut->suspend();
+
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, attachSource(PtrMatcher(sourceToAttachAgainPtr)))
+        .WillOnce(Invoke(
+            [&](std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> &source)
+            {
+                source->setId(kNewSourceId);
+                return true;
+            }));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, pause()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, seek(kPosition)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, setVolume(kVolume)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPlayerClientBackendMock, setMute(false)).WillOnce(Return(true));
+    m_sut->resume();
+    EXPECT_EQ(audioSink->priv->m_sourceId, kNewSourceId);
+
+    gst_object_unref(audioSink);
+}
@@ -71,7 +71,7 @@ TEST_F(GstreamerMseVideoSinkTests, ShouldNotHandleUnknownEvent)
     RialtoMSEBaseSink *videoSink = createVideoSink();
     GstElement *pipeline = createPipelineWithSink(videoSink);
 
-    EXPECT_EQ(GST_STATE_CHANGE_SUCCESS, gst_element_set_state(pipeline, GST_STATE_READY));
+    setReadyState(pipeline);
 
     gst_pad_set_active(videoSink->priv->m_sinkPad, TRUE);
     gst_pad_send_event(videoSink->priv->m_sinkPad, gst_event_new_gap(1, 1));
@@ -86,7 +86,7 @@ TEST_F(GstreamerMseVideoSinkTests, ShouldNotAttachSourceWhenPipelineIsBelowPause
     RialtoMSEBaseSink *videoSink = createVideoSink();
     GstElement *pipeline = createPipelineWithSink(videoSink);
 
-    EXPECT_EQ(GST_STATE_CHANGE_SUCCESS, gst_element_set_state(pipeline, GST_STATE_READY));
+    setReadyState(pipeline);
 
     gst_pad_set_active(videoSink->priv->m_sinkPad, TRUE);
     GstCaps *caps{createDefaultCaps()};
@@ -23,13 +23,16 @@
 #include "TimerMock.h"
 #include "WebAudioClientBackendMock.h"
 #include <gmock/gmock.h>
+#include <future>
 #include <gtest/gtest.h>
+#include <mutex>
 #include <vector>
 
 using firebolt::rialto::client::WebAudioClientBackendMock;
 using testing::_;
 using testing::ByMove;
 using testing::DoAll;
+using testing::InSequence;
 using testing::Invoke;
 using testing::Return;
 using testing::SetArgReferee;
@@ -75,6 +78,8 @@ constexpr firebolt::rialto::WebAudioPcmConfig kFloatFormatConfig{kRate, kChannel
 const std::string kLittleEndian{"U12LE"};
 constexpr firebolt::rialto::WebAudioPcmConfig kLittleEndianFormatConfig{kRate, kChannels, 12, false, false, false};
 const std::vector<uint8_t> kBytes{1, 2, 3, 4, 5, 6, 7, 8};
+constexpr gsize kBigBufferSize{1024 * 1024};
+constexpr uint32_t kPreferredFrames{2};
 constexpr std::chrono::milliseconds kTimeout{100};
 constexpr auto kTimerType{TimerType::ONE_SHOT};
 MATCHER_P(WebAudioConfigMatcher, config, "")
@@ -108,13 +113,31 @@ public:
                 }));
     }
 
-    void open()
+    void expectPostMessage()
+    {
+        EXPECT_CALL(m_messageQueueMock, postMessage(_))
+            .WillRepeatedly(Invoke(
+                [](const auto &msg)
+                {
+                    msg->handle();
+                    return true;
+                }));
+    }
+
+    void expectBufferDelay(uint32_t delayFrames = 0)
+    {
+        EXPECT_CALL(m_webAudioClientBackendMock, getBufferDelay(_))
+            .WillRepeatedly(DoAll(SetArgReferee<0>(delayFrames), Return(true)));
+    }
+
+    void open(uint32_t preferredFrames = 0, bool supportDeferredPlay = false)
     {
         expectCallInEventLoop();
         EXPECT_CALL(m_webAudioClientBackendMock,
                     createWebAudioBackend(_, kMimeType, kPriority, WebAudioConfigMatcher(kSignedFormatConfig)))
             .WillOnce(Return(true));
-        EXPECT_CALL(m_webAudioClientBackendMock, getDeviceInfo(_, _, _)).WillOnce(Return(true));
+        EXPECT_CALL(m_webAudioClientBackendMock, getDeviceInfo(_, _, _))
+            .WillOnce(DoAll(SetArgReferee<0>(preferredFrames), SetArgReferee<2>(supportDeferredPlay), Return(true)));
         GstCaps *caps = gst_caps_new_simple(kMimeType.c_str(), "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                             kChannels, "format", G_TYPE_STRING, kSignedFormat.c_str(), nullptr);
         EXPECT_TRUE(m_sut->open(caps));
@@ -265,7 +288,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldOpenTheSameConfigTwiceWhenMimeT
 
     GstCaps *newCaps = gst_caps_new_simple(kMp4MimeType.c_str(), "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                            kChannels, "format", G_TYPE_STRING, kSignedFormat.c_str(), nullptr);
-    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
     EXPECT_CALL(m_webAudioClientBackendMock,
                 createWebAudioBackend(_, kMp4MimeType, kPriority, WebAudioConfigMatcher(kSignedFormatConfig)))
         .WillOnce(Return(true));
@@ -285,7 +308,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldOpenTheSameConfigTwiceWhenMimeT
                                         kChannels, "format", G_TYPE_STRING, kSignedFormat.c_str(), nullptr);
     EXPECT_TRUE(m_sut->open(caps));
 
-    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
     EXPECT_CALL(m_webAudioClientBackendMock,
                 createWebAudioBackend(_, kMp4MimeType, kPriority, WebAudioConfigMatcher(kSignedFormatConfig)))
         .WillOnce(Return(true));
@@ -301,7 +324,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldOpenTheSameConfigTwiceWhenPcmIs
 
     GstCaps *newCaps = gst_caps_new_simple(kMimeType.c_str(), "rate", G_TYPE_INT, kRate, "channels", G_TYPE_INT,
                                            kChannels, "format", G_TYPE_STRING, kUnsignedFormat.c_str(), nullptr);
-    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
     EXPECT_CALL(m_webAudioClientBackendMock,
                 createWebAudioBackend(_, kMimeType, kPriority, WebAudioConfigMatcher(kUnsignedFormatConfig)))
         .WillOnce(Return(true));
@@ -313,9 +336,94 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldOpenTheSameConfigTwiceWhenPcmIs
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldOpenAgainAfterClose)
 {
     open();
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+    open();
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldDestroyBackendOnCloseWhenPlaying)
+{
+    open();
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->play());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldDestroyBackendOnCloseWhenDataIsNotPlayedOut)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(true));
+    expectBufferDelay(1);
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+
+    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldReleaseBackendOnCloseWhenPausedPlayerIsPlayedOut)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->play());
+
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(true));
+    expectBufferDelay(2);
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+
+    EXPECT_CALL(m_webAudioClientBackendMock, pause()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->pause());
+
+    // The written frames have been played out before the pause, so the player goes back to the pool
+    expectBufferDelay(0);
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldDestroyBackendOnCloseAfterEndOfStream)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(true));
+    expectBufferDelay();
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+
+    EXPECT_CALL(CallbackMock::instance(), eosCallback());
+    m_sut->notifyState(firebolt::rialto::WebAudioPlayerState::END_OF_STREAM);
+
     EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
     EXPECT_TRUE(m_sut->close());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldDestroyBackendOnCloseAfterSetEos)
+{
     open();
+    EXPECT_CALL(m_webAudioClientBackendMock, setEos()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->setEos());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, destroyWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToPlayWhenNotOpened)
@@ -338,6 +446,93 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldPlay)
     EXPECT_TRUE(m_sut->play());
 }
 
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldPlayImmediatelyWhenDeferredPlayIsSupported)
+{
+    open(kPreferredFrames, true);
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->play());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldDelayPlayUntilDeviceIsPrimed)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open(kPreferredFrames);
+    EXPECT_TRUE(m_sut->play());
+    GstStructure *stats{m_sut->getStats()};
+    guint64 timeToFirstSample{1};
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "time-to-first-sample-us", &timeToFirstSample));
+    EXPECT_EQ(timeToFirstSample, 0u);
+    gst_structure_free(stats);
+
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(kPreferredFrames, _)).WillOnce(Return(true));
+    expectBufferDelay();
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldLimitFirstWriteToPrimingSizeAndPlayBeforeWritingTheRest)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open(1);
+    EXPECT_TRUE(m_sut->play());
+
+    expectPostMessage();
+    expectBufferDelay();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    {
+        // The buffer holds two frames, only the one priming the device is written before play
+        InSequence sequence;
+        EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(1, _)).WillOnce(Return(true));
+        EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+        EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(1, _)).WillOnce(Return(true));
+    }
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldPlayOnEosWhenDeviceIsNotPrimed)
+{
+    open(kPreferredFrames);
+    EXPECT_TRUE(m_sut->play());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(true));
+    EXPECT_CALL(m_webAudioClientBackendMock, setEos()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->setEos());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotifyErrorWhenDelayedPlayFails)
+{
+    open(kPreferredFrames);
+    EXPECT_TRUE(m_sut->play());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, play()).WillOnce(Return(false));
+    EXPECT_CALL(CallbackMock::instance(), errorCallback(_));
+    EXPECT_CALL(m_webAudioClientBackendMock, setEos()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->setEos());
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotPlayAfterPauseWhenDeviceIsNotPrimed)
+{
+    open(kPreferredFrames);
+    EXPECT_TRUE(m_sut->play());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, pause()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->pause());
+
+    EXPECT_CALL(m_webAudioClientBackendMock, setEos()).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->setEos());
+}
+
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToPauseWhenNotOpened)
 {
     expectCallInEventLoop();
@@ -358,6 +553,40 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldPause)
     EXPECT_TRUE(m_sut->pause());
 }
 
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldStoreVolumeWhenNotOpened)
+{
+    constexpr double kVolume{0.5};
+    expectCallInEventLoop();
+    EXPECT_TRUE(m_sut->setVolume(kVolume));
+    EXPECT_DOUBLE_EQ(m_sut->getVolume(), kVolume);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldApplyVolumeOnOpen)
+{
+    constexpr double kVolume{0.5};
+    expectCallInEventLoop();
+    EXPECT_TRUE(m_sut->setVolume(kVolume));
+    EXPECT_CALL(m_webAudioClientBackendMock, setVolume(kVolume)).WillOnce(Return(true));
+    open();
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToSetVolumeWhenOperationFails)
+{
+    constexpr double kVolume{0.5};
+    open();
+    EXPECT_CALL(m_webAudioClientBackendMock, setVolume(kVolume)).WillOnce(Return(false));
+    EXPECT_FALSE(m_sut->setVolume(kVolume));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldSetVolume)
+{
+    constexpr double kVolume{0.5};
+    open();
+    EXPECT_CALL(m_webAudioClientBackendMock, setVolume(kVolume)).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut->setVolume(kVolume));
+    EXPECT_DOUBLE_EQ(m_sut->getVolume(), kVolume);
+}
+
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToSetEosWhenNotOpened)
 {
     expectCallInEventLoop();
@@ -384,6 +613,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldSetEosAndTryPushBuffer)
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(true));
     std::unique_ptr<StrictMock<TimerMock>> timer{std::make_unique<StrictMock<TimerMock>>()};
     EXPECT_CALL(*m_timerFactoryMock, createTimer(kTimeout, _, kTimerType)).WillOnce(Return(ByMove(std::move(timer))));
@@ -392,8 +622,6 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldSetEosAndTryPushBuffer)
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(false));
     EXPECT_CALL(m_webAudioClientBackendMock, setEos()).WillRepeatedly(Return(true));
     EXPECT_TRUE(m_sut->setEos());
-
-    gst_buffer_unref(buffer);
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotSetEosTwice)
@@ -430,10 +658,9 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotPushSamplesWhenGetAvailableB
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(false));
     m_sut->notifyNewSample(buffer);
-
-    gst_buffer_unref(buffer);
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotPushSamplesWhenThereIsNoBufferAvailable)
@@ -442,12 +669,11 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldNotPushSamplesWhenThereIsNoBuff
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(true));
     std::unique_ptr<StrictMock<TimerMock>> timer{std::make_unique<StrictMock<TimerMock>>()};
     EXPECT_CALL(*m_timerFactoryMock, createTimer(kTimeout, _, kTimerType)).WillOnce(Return(ByMove(std::move(timer))));
     m_sut->notifyNewSample(buffer);
-
-    gst_buffer_unref(buffer);
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldTryPushBufferTwiceWhenTimerExpires)
@@ -456,6 +682,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldTryPushBufferTwiceWhenTimerExpi
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(true));
     std::function<void()> timerCallback;
     std::unique_ptr<StrictMock<TimerMock>> timer{std::make_unique<StrictMock<TimerMock>>()};
@@ -472,8 +699,6 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldTryPushBufferTwiceWhenTimerExpi
 
     ASSERT_TRUE(timerCallback);
     timerCallback();
-
-    gst_buffer_unref(buffer);
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToPushBuffer)
@@ -482,6 +707,7 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToPushBuffer)
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
         .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)));
     EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(false));
@@ -494,13 +720,13 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldPushBuffer)
     gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
         .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
         .WillOnce(Return(false));
     EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(true));
+    expectBufferDelay();
     m_sut->notifyNewSample(buffer);
-
-    gst_buffer_unref(buffer);
 }
 
 TEST_F(GstreamerWebAudioPlayerClientTests, ShouldAppendBuffer)
@@ -511,10 +737,12 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldAppendBuffer)
     gst_buffer_fill(secondBuffer, 0, kBytes.data(), kBytes.size());
 
     open();
+    expectPostMessage();
     EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
         .WillOnce(DoAll(SetArgReferee<0>(1), Return(true)))
         .WillOnce(DoAll(SetArgReferee<0>(0), Return(true)));
     EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(1, _)).WillOnce(Return(true));
+    expectBufferDelay();
     std::unique_ptr<StrictMock<TimerMock>> timer{std::make_unique<StrictMock<TimerMock>>()};
     EXPECT_CALL(*timer, cancel());
     EXPECT_CALL(*m_timerFactoryMock, createTimer(kTimeout, _, kTimerType)).WillOnce(Return(ByMove(std::move(timer))));
@@ -528,6 +756,270 @@ TEST_F(GstreamerWebAudioPlayerClientTests, ShouldAppendBuffer)
     m_sut->notifyNewSample(secondBuffer);
 }
 
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToNotifyNewSampleWhenQueueIsStopped)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+
+    open();
+    EXPECT_CALL(m_messageQueueMock, postMessage(_)).WillOnce(Return(false));
+    EXPECT_FALSE(m_sut->notifyNewSample(buffer));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldBlockNewSampleUntilQueuedDataIsReleased)
+{
+    GstBuffer *bigBuffer = gst_buffer_new_allocate(nullptr, kBigBufferSize, nullptr);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    std::mutex messagesMutex;
+    std::vector<std::shared_ptr<Message>> messages;
+
+    open();
+    EXPECT_CALL(m_messageQueueMock, postMessage(_))
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                std::unique_lock<std::mutex> lock(messagesMutex);
+                messages.push_back(msg);
+                return true;
+            }));
+    EXPECT_TRUE(m_sut->notifyNewSample(bigBuffer));
+
+    std::future<bool> result = std::async(std::launch::async, [&]() { return m_sut->notifyNewSample(buffer); });
+    EXPECT_EQ(std::future_status::timeout, result.wait_for(std::chrono::milliseconds(50)));
+
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(false));
+    {
+        std::unique_lock<std::mutex> lock(messagesMutex);
+        ASSERT_EQ(messages.size(), 1u);
+        messages.front()->handle();
+    }
+    EXPECT_TRUE(result.get());
+    EXPECT_EQ(messages.size(), 2u);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldUnblockNewSampleAndDropQueuedSamplesOnClose)
+{
+    GstBuffer *bigBuffer = gst_buffer_new_allocate(nullptr, kBigBufferSize, nullptr);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    std::mutex messagesMutex;
+    std::vector<std::shared_ptr<Message>> messages;
+
+    open();
+    EXPECT_CALL(m_messageQueueMock, postMessage(_))
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                std::unique_lock<std::mutex> lock(messagesMutex);
+                messages.push_back(msg);
+                return true;
+            }));
+    EXPECT_TRUE(m_sut->notifyNewSample(bigBuffer));
+
+    std::future<bool> result = std::async(std::launch::async, [&]() { return m_sut->notifyNewSample(buffer); });
+    EXPECT_EQ(std::future_status::timeout, result.wait_for(std::chrono::milliseconds(50)));
+
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+
+    // The samples queued before the close are dropped without calling the server, which unblocks the submission
+    {
+        std::unique_lock<std::mutex> lock(messagesMutex);
+        ASSERT_EQ(messages.size(), 1u);
+        messages.front()->handle();
+    }
+    EXPECT_TRUE(result.get());
+    std::unique_lock<std::mutex> lock(messagesMutex);
+    ASSERT_EQ(messages.size(), 2u);
+    messages.back()->handle();
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldBlockNewSampleBeforeOpenAndCountDroppedSamples)
+{
+    GstBuffer *bigBuffer = gst_buffer_new_allocate(nullptr, kBigBufferSize, nullptr);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    std::mutex messagesMutex;
+    std::vector<std::shared_ptr<Message>> messages;
+
+    EXPECT_CALL(m_messageQueueMock, postMessage(_))
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                std::unique_lock<std::mutex> lock(messagesMutex);
+                messages.push_back(msg);
+                return true;
+            }));
+    EXPECT_TRUE(m_sut->notifyNewSample(bigBuffer));
+
+    // The default budget applies until the audio format is known
+    std::future<bool> result = std::async(std::launch::async, [&]() { return m_sut->notifyNewSample(buffer); });
+    EXPECT_EQ(std::future_status::timeout, result.wait_for(std::chrono::milliseconds(50)));
+
+    {
+        std::unique_lock<std::mutex> lock(messagesMutex);
+        ASSERT_EQ(messages.size(), 1u);
+        messages.front()->handle();
+    }
+    EXPECT_TRUE(result.get());
+    {
+        std::unique_lock<std::mutex> lock(messagesMutex);
+        ASSERT_EQ(messages.size(), 2u);
+        messages.back()->handle();
+    }
+
+    expectCallInEventLoop();
+    GstStructure *stats{m_sut->getStats()};
+    guint64 samplesDropped{0};
+    guint64 bytesDropped{0};
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "samples-dropped", &samplesDropped));
+    EXPECT_TRUE(gst_structure_get_uint64(stats, "bytes-dropped", &bytesDropped));
+    EXPECT_EQ(samplesDropped, 2u);
+    EXPECT_EQ(bytesDropped, kBigBufferSize + kBytes.size());
+    gst_structure_free(stats);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldUnblockAndDropNewSampleOnFlush)
+{
+    GstBuffer *bigBuffer = gst_buffer_new_allocate(nullptr, kBigBufferSize, nullptr);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    std::mutex messagesMutex;
+    std::vector<std::shared_ptr<Message>> messages;
+
+    open();
+    EXPECT_CALL(m_messageQueueMock, postMessage(_))
+        .WillRepeatedly(Invoke(
+            [&](const auto &msg)
+            {
+                std::unique_lock<std::mutex> lock(messagesMutex);
+                messages.push_back(msg);
+                return true;
+            }));
+    EXPECT_TRUE(m_sut->notifyNewSample(bigBuffer));
+
+    std::future<bool> result = std::async(std::launch::async, [&]() { return m_sut->notifyNewSample(buffer); });
+    EXPECT_EQ(std::future_status::timeout, result.wait_for(std::chrono::milliseconds(50)));
+
+    m_sut->startFlush();
+    EXPECT_FALSE(result.get());
+    EXPECT_FALSE(m_sut->notifyNewSample(gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr)));
+
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_)).WillOnce(Return(false));
+    {
+        std::unique_lock<std::mutex> lock(messagesMutex);
+        ASSERT_EQ(messages.size(), 1u);
+        messages.front()->handle();
+    }
+
+    m_sut->stopFlush();
+    EXPECT_TRUE(m_sut->notifyNewSample(gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr)));
+    std::unique_lock<std::mutex> lock(messagesMutex);
+    EXPECT_EQ(messages.size(), 2u);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToGetLatencyAndPositionWhenNotOpened)
+{
+    GstClockTime minLatency{0};
+    GstClockTime maxLatency{0};
+    EXPECT_FALSE(m_sut->getLatency(minLatency, maxLatency));
+    EXPECT_EQ(m_sut->getPosition(), -1);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldFailToGetLatencyAndPositionAfterClose)
+{
+    open();
+    EXPECT_CALL(m_webAudioClientBackendMock, releaseWebAudioBackend());
+    EXPECT_TRUE(m_sut->close());
+
+    GstClockTime minLatency{0};
+    GstClockTime maxLatency{0};
+    EXPECT_FALSE(m_sut->getLatency(minLatency, maxLatency));
+    EXPECT_EQ(m_sut->getPosition(), -1);
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldGetLatencyAndPositionFromBufferDelay)
+{
+    constexpr uint32_t kDelayFrames{1};
+    constexpr uint32_t kWrittenFrames{2};
+    constexpr uint32_t kMaxQueuedFrames{kRate * 200 / 1000};
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    GstClockTime minLatency{0};
+    GstClockTime maxLatency{0};
+    EXPECT_TRUE(m_sut->getLatency(minLatency, maxLatency));
+    EXPECT_EQ(minLatency, 0u);
+    EXPECT_EQ(maxLatency, gst_util_uint64_scale(kMaxQueuedFrames, GST_SECOND, kRate));
+    EXPECT_EQ(m_sut->getPosition(), 0);
+
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(kWrittenFrames, _)).WillOnce(Return(true));
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferDelay(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kDelayFrames), Return(true)));
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+
+    EXPECT_TRUE(m_sut->getLatency(minLatency, maxLatency));
+    EXPECT_EQ(minLatency, gst_util_uint64_scale(kDelayFrames, GST_SECOND, kRate));
+    EXPECT_EQ(maxLatency, gst_util_uint64_scale(kDelayFrames + kMaxQueuedFrames, GST_SECOND, kRate));
+    EXPECT_EQ(m_sut->getPosition(),
+              static_cast<gint64>(gst_util_uint64_scale(kWrittenFrames - kDelayFrames, GST_SECOND, kRate)));
+
+    // The whole buffer is played out at end of stream
+    EXPECT_CALL(CallbackMock::instance(), eosCallback());
+    m_sut->notifyState(firebolt::rialto::WebAudioPlayerState::END_OF_STREAM);
+    EXPECT_EQ(m_sut->getPosition(), static_cast<gint64>(gst_util_uint64_scale(kWrittenFrames, GST_SECOND, kRate)));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldEstimateBufferDelayBetweenQueries)
+{
+    constexpr uint32_t kDelayFrames{1};
+    constexpr uint32_t kWrittenFrames{2};
+    GstBuffer *firstBuffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(firstBuffer, 0, kBytes.data(), kBytes.size());
+    GstBuffer *secondBuffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(secondBuffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(kWrittenFrames, _)).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferDelay(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kDelayFrames), Return(true)));
+    EXPECT_TRUE(m_sut->notifyNewSample(firstBuffer));
+
+    // The second push is too close to the query, so the frames it wrote are added to the cached delay
+    EXPECT_TRUE(m_sut->notifyNewSample(secondBuffer));
+
+    GstClockTime minLatency{0};
+    GstClockTime maxLatency{0};
+    EXPECT_TRUE(m_sut->getLatency(minLatency, maxLatency));
+    EXPECT_EQ(minLatency, gst_util_uint64_scale(kDelayFrames + kWrittenFrames, GST_SECOND, kRate));
+    EXPECT_EQ(m_sut->getPosition(),
+              static_cast<gint64>(gst_util_uint64_scale(kWrittenFrames - kDelayFrames, GST_SECOND, kRate)));
+}
+
+TEST_F(GstreamerWebAudioPlayerClientTests, ShouldKeepCachedBufferDelayWhenGetBufferDelayFails)
+{
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, kBytes.size(), nullptr);
+    gst_buffer_fill(buffer, 0, kBytes.data(), kBytes.size());
+
+    open();
+    expectPostMessage();
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferAvailable(_))
+        .WillOnce(DoAll(SetArgReferee<0>(kBytes.size()), Return(true)))
+        .WillOnce(Return(false));
+    EXPECT_CALL(m_webAudioClientBackendMock, writeBuffer(2, _)).WillOnce(Return(true));
+    EXPECT_CALL(m_webAudioClientBackendMock, getBufferDelay(_)).WillOnce(Return(false));
+    EXPECT_TRUE(m_sut->notifyNewSample(buffer));
+
+    EXPECT_EQ(m_sut->getPosition(), 0);
+}
+
 TEST_F(GstreamerWebAudioPlayerClientTests, shouldNotifyEos)
 {
     EXPECT_CALL(CallbackMock::instance(), eosCallback());
@@ -19,10 +19,12 @@
 #include "Matchers.h"
 #include "RialtoGstTest.h"
 #include "WebAudioPlayerMock.h"
+#include "WebAudioPlayerPool.h"
 
 using firebolt::rialto::IWebAudioPlayerFactory;
 using firebolt::rialto::WebAudioPlayerFactoryMock;
 using firebolt::rialto::WebAudioPlayerMock;
+using firebolt::rialto::client::WebAudioPlayerPool;
 using testing::_;
 using testing::DoAll;
 using testing::Return;
@@ -45,7 +47,7 @@ class GstreamerWebAudioSinkTests : public RialtoGstTest
 {
 public:
     GstreamerWebAudioSinkTests() = default;
-    ~GstreamerWebAudioSinkTests() = default;
+    ~GstreamerWebAudioSinkTests() override { WebAudioPlayerPool::instance()->clear(); }
 
     void setPaused(GstElement *pipeline)
     {
@@ -139,6 +141,47 @@ TEST_F(GstreamerWebAudioSinkTests, ShouldAttachSource)
     gst_object_unref(pipeline);
 }
 
+TEST_F(GstreamerWebAudioSinkTests, ShouldFailToQueryPositionAndLatencyWhenSourceIsNotAttached)
+{
+    RialtoWebAudioSink *sink{createWebAudioSink()};
+    GstElement *pipeline = createPipelineWithSink(sink);
+
+    setPaused(pipeline);
+
+    gint64 position{-1};
+    EXPECT_FALSE(gst_element_query_position(GST_ELEMENT_CAST(sink), GST_FORMAT_TIME, &position));
+
+    setNull(pipeline);
+    gst_object_unref(pipeline);
+}
+
+TEST_F(GstreamerWebAudioSinkTests, ShouldQueryPositionAndLatency)
+{
+    RialtoWebAudioSink *sink{createWebAudioSink()};
+    GstElement *pipeline = createPipelineWithSink(sink);
+
+    setPaused(pipeline);
+    attachSource(sink);
+
+    gint64 position{-1};
+    EXPECT_TRUE(gst_element_query_position(GST_ELEMENT_CAST(sink), GST_FORMAT_TIME, &position));
+    EXPECT_EQ(position, 0);
+
+    GstQuery *query{gst_query_new_latency()};
+    EXPECT_TRUE(gst_element_query(GST_ELEMENT_CAST(sink), query));
+    gboolean isLive{TRUE};
+    GstClockTime minLatency{GST_CLOCK_TIME_NONE};
+    GstClockTime maxLatency{0};
+    gst_query_parse_latency(query, &isLive, &minLatency, &maxLatency);
+    EXPECT_FALSE(isLive);
+    EXPECT_EQ(minLatency, 0u);
+    EXPECT_EQ(maxLatency, GST_CLOCK_TIME_NONE);
+    gst_query_unref(query);
+
+    setNull(pipeline);
+    gst_object_unref(pipeline);
+}
+
 TEST_F(GstreamerWebAudioSinkTests, ShouldFailToReachPlayingState)
 {
     RialtoWebAudioSink *sink{createWebAudioSink()};
@@ -328,6 +371,24 @@ TEST_F(GstreamerWebAudioSinkTests, ShouldHandleUnknownEvent)
     gst_object_unref(pipeline);
 }
 
+TEST_F(GstreamerWebAudioSinkTests, ShouldHandleFlushEvents)
+{
+    RialtoWebAudioSink *sink{createWebAudioSink()};
+    GstElement *pipeline = createPipelineWithSink(sink);
+
+    setPaused(pipeline);
+    attachSource(sink);
+
+    GstPad *sinkPad = gst_element_get_static_pad(GST_ELEMENT_CAST(sink), "sink");
+    ASSERT_TRUE(sinkPad);
+    gst_pad_send_event(sinkPad, gst_event_new_flush_start());
+    gst_pad_send_event(sinkPad, gst_event_new_flush_stop(TRUE));
+
+    setNull(pipeline);
+    gst_object_unref(sinkPad);
+    gst_object_unref(pipeline);
+}
+
 TEST_F(GstreamerWebAudioSinkTests, ShouldGetAndSetTsOffsetProperty)
 {
     RialtoWebAudioSink *sink{createWebAudioSink()};
@@ -83,6 +83,17 @@ TEST_F(MediaPlayerClientBackendTests, ShouldCreateMediaPipeline)
     EXPECT_TRUE(m_sut.isMediaPlayerBackendCreated());
 }
 
+TEST_F(MediaPlayerClientBackendTests, ShouldDestroyMediaPipeline)
+{
+    constexpr int64_t kPosition{123};
+    initializeMediaPipeline();
+    ASSERT_TRUE(m_sut.isMediaPlayerBackendCreated());
+    m_sut.destroyMediaPlayerBackend();
+    EXPECT_FALSE(m_sut.isMediaPlayerBackendCreated());
+    EXPECT_FALSE(m_sut.play());
+    EXPECT_FALSE(m_sut.seek(kPosition));
+}
+
 TEST_F(MediaPlayerClientBackendTests, ShouldAttachSource)
 {
     std::unique_ptr<firebolt::rialto::IMediaPipeline::MediaSource> mediaSourceAudio{
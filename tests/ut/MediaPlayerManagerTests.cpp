@@ -18,8 +18,12 @@
 
 #include "MediaPipelineMock.h"
 #include "MediaPlayerManager.h"
+#include <chrono>
 #include <gst/gst.h>
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
 
 using firebolt::rialto::IMediaPipelineFactory;
 using firebolt::rialto::MediaPipelineFactoryMock;
@@ -33,6 +37,7 @@ namespace
 {
 constexpr uint32_t kMaxVideoWidth{1920};
 constexpr uint32_t kMaxVideoHeight{1080};
+constexpr std::chrono::milliseconds kShortLingerTime{10};
 } // namespace
 
 class MediaPlayerManagerTests : public testing::Test
@@ -129,3 +134,100 @@ TEST_F(MediaPlayerManagerTests, ShouldAcquireControl)
     }
     EXPECT_TRUE(m_sut.hasControl());
 }
+
+TEST_F(MediaPlayerManagerTests, ShouldNotHaveControlAfterRelease)
+{
+    EXPECT_CALL(*m_mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+    EXPECT_TRUE(m_sut.hasControl());
+    m_sut.releaseMediaPlayerClient();
+    EXPECT_FALSE(m_sut.hasControl());
+}
+
+TEST_F(MediaPlayerManagerTests, OnlyOneMediaPlayerManagerShouldAcquireReleasedControl)
+{
+    EXPECT_CALL(*m_mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    MediaPlayerManager secondSut;
+    MediaPlayerManager thirdSut;
+    {
+        MediaPlayerManager firstSut;
+        EXPECT_TRUE(firstSut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+        EXPECT_TRUE(secondSut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+        EXPECT_TRUE(thirdSut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+        EXPECT_TRUE(firstSut.hasControl());
+        EXPECT_FALSE(secondSut.hasControl());
+    }
+    EXPECT_TRUE(secondSut.hasControl());
+    EXPECT_FALSE(thirdSut.hasControl());
+    EXPECT_TRUE(secondSut.hasControl());
+}
+
+TEST_F(MediaPlayerManagerTests, ShouldReuseLingeringMediaPlayerClient)
+{
+    setenv("RIALTO_CLIENT_LINGER_MS", "10000", 1);
+    StrictMock<MediaPipelineMock> &mediaPipelineMock{*m_mediaPipelineMock};
+    EXPECT_CALL(mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+
+    EXPECT_CALL(mediaPipelineMock, stop()).WillOnce(Return(true));
+    m_sut.releaseMediaPlayerClient();
+
+    GstObject anotherObject{};
+    EXPECT_CALL(mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&anotherObject, kMaxVideoWidth, kMaxVideoHeight));
+    EXPECT_TRUE(m_sut.hasControl());
+
+    unsetenv("RIALTO_CLIENT_LINGER_MS");
+    m_sut.releaseMediaPlayerClient();
+}
+
+TEST_F(MediaPlayerManagerTests, ShouldNotReuseLingeringMediaPlayerClientWithOtherVideoRequirements)
+{
+    setenv("RIALTO_CLIENT_LINGER_MS", std::to_string(kShortLingerTime.count()).c_str(), 1);
+    StrictMock<MediaPipelineMock> &mediaPipelineMock{*m_mediaPipelineMock};
+    EXPECT_CALL(mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+
+    EXPECT_CALL(mediaPipelineMock, stop()).WillOnce(Return(true));
+    m_sut.releaseMediaPlayerClient();
+    unsetenv("RIALTO_CLIENT_LINGER_MS");
+
+    m_mediaPipelineMock = std::make_unique<StrictMock<MediaPipelineMock>>();
+    EXPECT_CALL(*m_mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth / 2, kMaxVideoHeight / 2));
+    m_sut.releaseMediaPlayerClient();
+
+    // Let the lingering client expire
+    std::this_thread::sleep_for(kShortLingerTime * 5);
+}
+
+TEST_F(MediaPlayerManagerTests, ShouldNotReuseExpiredMediaPlayerClient)
+{
+    setenv("RIALTO_CLIENT_LINGER_MS", std::to_string(kShortLingerTime.count()).c_str(), 1);
+    StrictMock<MediaPipelineMock> &mediaPipelineMock{*m_mediaPipelineMock};
+    EXPECT_CALL(mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+
+    EXPECT_CALL(mediaPipelineMock, stop()).WillOnce(Return(true));
+    m_sut.releaseMediaPlayerClient();
+    unsetenv("RIALTO_CLIENT_LINGER_MS");
+    std::this_thread::sleep_for(kShortLingerTime * 5);
+
+    m_mediaPipelineMock = std::make_unique<StrictMock<MediaPipelineMock>>();
+    EXPECT_CALL(*m_mediaPipelineMock, load(_, _, _)).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, _))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipelineMock))));
+    EXPECT_TRUE(m_sut.attachMediaPlayerClient(&m_object, kMaxVideoWidth, kMaxVideoHeight));
+}
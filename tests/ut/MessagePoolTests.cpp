@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "MessagePool.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+class TestMessage
+{
+public:
+    explicit TestMessage(int value) : m_value{value} {}
+    int getValue() const { return m_value; }
+
+private:
+    int m_value;
+};
+} // namespace
+
+TEST(MessagePoolTests, ShouldCreateMessage)
+{
+    MessagePool<TestMessage> sut;
+    std::shared_ptr<TestMessage> message{sut.acquire(1)};
+    ASSERT_TRUE(message);
+    EXPECT_EQ(message->getValue(), 1);
+}
+
+TEST(MessagePoolTests, ShouldReuseReleasedMessage)
+{
+    MessagePool<TestMessage> sut;
+    std::shared_ptr<TestMessage> message{sut.acquire(1)};
+    const TestMessage *firstMessage{message.get()};
+    message.reset();
+
+    message = sut.acquire(2);
+    EXPECT_EQ(message.get(), firstMessage);
+    EXPECT_EQ(message->getValue(), 2);
+}
+
+TEST(MessagePoolTests, ShouldNotReuseMessageInUse)
+{
+    MessagePool<TestMessage> sut;
+    std::shared_ptr<TestMessage> firstMessage{sut.acquire(1)};
+    std::shared_ptr<TestMessage> secondMessage{sut.acquire(2)};
+    EXPECT_NE(firstMessage.get(), secondMessage.get());
+    EXPECT_EQ(firstMessage->getValue(), 1);
+    EXPECT_EQ(secondMessage->getValue(), 2);
+}
@@ -131,6 +131,8 @@ RialtoGstTest::RialtoGstTest()
     std::call_once(onceFlag,
                    [this]()
                    {
+                       // The supported mime types are asked from the server mocks, not from a cache file
+                       setenv("RIALTO_MIME_TYPES_CACHE_FILE", "", 1);
                        expectSinksInitialisation();
                        gst_init(nullptr, nullptr);
                        const auto registerResult =
@@ -161,29 +163,36 @@ bool RialtoGstTest::ReceivedMessages::contains(const GstMessageType &type) const
     return std::find(m_receivedMessages.begin(), m_receivedMessages.end(), type) != m_receivedMessages.end();
 }
 
-RialtoMSEBaseSink *RialtoGstTest::createAudioSink() const
+void RialtoGstTest::expectControlRegistration() const
 {
+    // The sinks created later in the test share the control registered by the first one
+    if (m_isControlRegistrationExpected)
+    {
+        return;
+    }
+    m_isControlRegistrationExpected = true;
     EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
     EXPECT_CALL(*m_controlMock, registerClient(_, _))
         .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+}
+
+RialtoMSEBaseSink *RialtoGstTest::createAudioSink() const
+{
+    expectControlRegistration();
     GstElement *audioSink = gst_element_factory_make("rialtomseaudiosink", "rialtomseaudiosink");
     return RIALTO_MSE_BASE_SINK(audioSink);
 }
 
 RialtoMSEBaseSink *RialtoGstTest::createVideoSink() const
 {
-    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
-    EXPECT_CALL(*m_controlMock, registerClient(_, _))
-        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    expectControlRegistration();
     GstElement *videoSink = gst_element_factory_make("rialtomsevideosink", "rialtomsevideosink");
     return RIALTO_MSE_BASE_SINK(videoSink);
 }
 
 RialtoWebAudioSink *RialtoGstTest::createWebAudioSink() const
 {
-    EXPECT_CALL(*m_controlFactoryMock, createControl()).WillOnce(Return(m_controlMock));
-    EXPECT_CALL(*m_controlMock, registerClient(_, _))
-        .WillOnce(DoAll(SetArgReferee<1>(ApplicationState::RUNNING), Return(true)));
+    expectControlRegistration();
     GstElement *webAudioSink = gst_element_factory_make("rialtowebaudiosink", "rialtowebaudiosink");
     return RIALTO_WEB_AUDIO_SINK(webAudioSink);
 }
@@ -292,6 +301,19 @@ void RialtoGstTest::setPausedState(GstElement *pipeline, RialtoMSEBaseSink *sink
     EXPECT_EQ(GST_STATE_CHANGE_ASYNC, gst_element_set_state(pipeline, GST_STATE_PAUSED));
 }
 
+void RialtoGstTest::setReadyState(GstElement *pipeline)
+{
+    // The media player session is prewarmed in NULL->READY and stopped in READY->NULL
+    constexpr firebolt::rialto::MediaType kMediaType{firebolt::rialto::MediaType::MSE};
+    const std::string kMimeType{};
+    const std::string kUrl{"mse://1"};
+    EXPECT_CALL(m_mediaPipelineMock, load(kMediaType, kMimeType, kUrl)).WillOnce(Return(true));
+    EXPECT_CALL(m_mediaPipelineMock, stop()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mediaPipelineFactoryMock, createMediaPipeline(_, kDefaultRequirements))
+        .WillOnce(Return(ByMove(std::move(m_mediaPipeline))));
+    EXPECT_EQ(GST_STATE_CHANGE_SUCCESS, gst_element_set_state(pipeline, GST_STATE_READY));
+}
+
 void RialtoGstTest::setPlayingState(GstElement *pipeline) const
 {
     EXPECT_CALL(m_mediaPipelineMock, play()).WillOnce(Return(true));
@@ -43,6 +43,7 @@ public:
         std::vector<GstMessageType> m_receivedMessages;
     };
 
+    void expectControlRegistration() const;
     RialtoMSEBaseSink *createAudioSink() const;
     RialtoMSEBaseSink *createVideoSink() const;
     RialtoWebAudioSink *createWebAudioSink() const;
@@ -55,6 +56,7 @@ public:
     int32_t dolbyVisionSourceWillBeAttached(
         const firebolt::rialto::IMediaPipeline::MediaSourceVideoDolbyVision &mediaSource) const;
     void setPausedState(GstElement *pipeline, RialtoMSEBaseSink *sink);
+    void setReadyState(GstElement *pipeline);
     void setPlayingState(GstElement *pipeline) const;
     void setNullState(GstElement *pipeline, int32_t sourceId) const;
     void pipelineWillGoToPausedState(RialtoMSEBaseSink *sink) const;
@@ -75,6 +77,7 @@ protected:
     std::shared_ptr<testing::StrictMock<firebolt::rialto::MediaPipelineFactoryMock>> m_mediaPipelineFactoryMock{
         std::dynamic_pointer_cast<testing::StrictMock<firebolt::rialto::MediaPipelineFactoryMock>>(
             firebolt::rialto::IMediaPipelineFactory::createFactory())};
+    mutable bool m_isControlRegistrationExpected{false};
     std::unique_ptr<testing::StrictMock<firebolt::rialto::MediaPipelineMock>> m_mediaPipeline{
         std::make_unique<testing::StrictMock<firebolt::rialto::MediaPipelineMock>>()};
     testing::StrictMock<firebolt::rialto::MediaPipelineMock> &m_mediaPipelineMock{*m_mediaPipeline};
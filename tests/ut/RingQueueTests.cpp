@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RingQueue.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+TEST(RingQueueTests, ShouldBeEmptyWhenCreated)
+{
+    RingQueue<int> sut;
+    EXPECT_TRUE(sut.empty());
+    EXPECT_EQ(sut.size(), 0u);
+}
+
+TEST(RingQueueTests, ShouldPopInPushOrder)
+{
+    RingQueue<int> sut;
+    sut.push(1);
+    sut.push(2);
+    sut.push(3);
+    ASSERT_EQ(sut.size(), 3u);
+    EXPECT_EQ(sut.front(), 1);
+    EXPECT_EQ(sut.back(), 3);
+    EXPECT_EQ(sut[1], 2);
+
+    sut.pop();
+    EXPECT_EQ(sut.front(), 2);
+    sut.pop();
+    sut.pop();
+    EXPECT_TRUE(sut.empty());
+}
+
+TEST(RingQueueTests, ShouldKeepOrderWhenGrowingAfterWrapping)
+{
+    RingQueue<int> sut;
+    for (int i = 0; i < 10; ++i)
+    {
+        sut.push(i);
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        sut.pop();
+    }
+    for (int i = 10; i < 60; ++i)
+    {
+        sut.push(i);
+    }
+
+    ASSERT_EQ(sut.size(), 52u);
+    for (int i = 8; i < 60; ++i)
+    {
+        EXPECT_EQ(sut.front(), i);
+        sut.pop();
+    }
+}
+
+TEST(RingQueueTests, ShouldReleaseItemWhenPopped)
+{
+    RingQueue<std::shared_ptr<int>> sut;
+    std::shared_ptr<int> item{std::make_shared<int>(1)};
+    sut.push(item);
+    EXPECT_EQ(item.use_count(), 2);
+
+    sut.pop();
+    EXPECT_EQ(item.use_count(), 1);
+}
+
+TEST(RingQueueTests, ShouldClear)
+{
+    RingQueue<int> sut;
+    sut.push(1);
+    sut.push(2);
+    sut.clear();
+    EXPECT_TRUE(sut.empty());
+
+    sut.push(3);
+    EXPECT_EQ(sut.front(), 3);
+}
+
+TEST(RingQueueTests, ShouldReserveAndSwap)
+{
+    RingQueue<int> sut;
+    RingQueue<int> other;
+    sut.reserve(100);
+    sut.push(1);
+    other.push(2);
+    other.push(3);
+
+    sut.swap(other);
+    ASSERT_EQ(sut.size(), 2u);
+    EXPECT_EQ(sut.front(), 2);
+    ASSERT_EQ(other.size(), 1u);
+    EXPECT_EQ(other.front(), 1);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SampleRecords.h"
+#include "RialtoGstTest.h"
+#include <gtest/gtest.h>
+
+class SampleRecordsTests : public RialtoGstTest
+{
+public:
+    SampleRecordsTests()
+    {
+        m_firstCaps = gst_caps_new_empty_simple("audio/mpeg");
+        m_secondCaps = gst_caps_new_empty_simple("audio/x-opus");
+        m_buffer = gst_buffer_new();
+    }
+
+    ~SampleRecordsTests() override
+    {
+        gst_buffer_unref(m_buffer);
+        gst_caps_unref(m_secondCaps);
+        gst_caps_unref(m_firstCaps);
+    }
+
+    GstCaps *m_firstCaps{nullptr};
+    GstCaps *m_secondCaps{nullptr};
+    GstBuffer *m_buffer{nullptr};
+    SampleRecordTables m_sut;
+};
+
+TEST_F(SampleRecordsTests, ShouldHaveNoCapsAndTimeSegmentInitially)
+{
+    const SampleRecord kRecord{m_sut.createRecord(nullptr)};
+    EXPECT_EQ(m_sut.getCurrentCaps(), nullptr);
+    EXPECT_EQ(m_sut.getCaps(kRecord), nullptr);
+    EXPECT_EQ(m_sut.getSegment(kRecord).format, GST_FORMAT_TIME);
+}
+
+TEST_F(SampleRecordsTests, ShouldKeepCapsAndSegmentOfQueuedRecords)
+{
+    m_sut.setCaps(gst_caps_ref(m_firstCaps));
+    const SampleRecord kFirstRecord{m_sut.createRecord(m_buffer)};
+    EXPECT_EQ(kFirstRecord.buffer, m_buffer);
+
+    GstSegment segment;
+    gst_segment_init(&segment, GST_FORMAT_TIME);
+    segment.start = 10 * GST_SECOND;
+    m_sut.setCaps(gst_caps_ref(m_secondCaps));
+    m_sut.setSegment(segment);
+    const SampleRecord kSecondRecord{m_sut.createRecord(m_buffer)};
+
+    m_sut.releaseUnused(&kFirstRecord);
+    EXPECT_EQ(m_sut.getCaps(kFirstRecord), m_firstCaps);
+    EXPECT_EQ(m_sut.getSegment(kFirstRecord).start, 0u);
+    EXPECT_EQ(m_sut.getCaps(kSecondRecord), m_secondCaps);
+    EXPECT_EQ(m_sut.getSegment(kSecondRecord).start, 10 * GST_SECOND);
+    EXPECT_EQ(m_sut.getCurrentCaps(), m_secondCaps);
+}
+
+TEST_F(SampleRecordsTests, ShouldReleaseGenerationsOlderThanOldestRecord)
+{
+    m_sut.setCaps(gst_caps_ref(m_firstCaps));
+    m_sut.setCaps(gst_caps_ref(m_secondCaps));
+    const SampleRecord kRecord{m_sut.createRecord(m_buffer)};
+    EXPECT_EQ(m_sut.getCapsGenerationCount(), 3u);
+
+    m_sut.releaseUnused(&kRecord);
+    EXPECT_EQ(m_sut.getCapsGenerationCount(), 1u);
+    EXPECT_EQ(GST_MINI_OBJECT_REFCOUNT_VALUE(m_firstCaps), 1);
+    EXPECT_EQ(m_sut.getCaps(kRecord), m_secondCaps);
+}
+
+TEST_F(SampleRecordsTests, ShouldKeepOnlyCurrentGenerationsWhenNothingIsQueued)
+{
+    GstSegment segment;
+    gst_segment_init(&segment, GST_FORMAT_TIME);
+    m_sut.setCaps(gst_caps_ref(m_firstCaps));
+    m_sut.setSegment(segment);
+    m_sut.setSegment(segment);
+
+    m_sut.releaseUnused(nullptr);
+    EXPECT_EQ(m_sut.getCapsGenerationCount(), 1u);
+    EXPECT_EQ(m_sut.getSegmentGenerationCount(), 1u);
+    EXPECT_EQ(m_sut.getCurrentCaps(), m_firstCaps);
+}
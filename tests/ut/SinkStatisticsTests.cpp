@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SinkStatistics.h"
+#include <gtest/gtest.h>
+
+using firebolt::rialto::MediaSourceStatus;
+
+namespace
+{
+uint64_t getField(const GstStructure *structure, const char *fieldName)
+{
+    guint64 value = 0;
+    EXPECT_TRUE(gst_structure_get_uint64(structure, fieldName, &value));
+    return value;
+}
+} // namespace
+
+class SinkStatisticsTests : public testing::Test
+{
+public:
+    ~SinkStatisticsTests() override
+    {
+        if (m_structure)
+        {
+            gst_structure_free(m_structure);
+        }
+    }
+
+protected:
+    SinkStatistics m_sut;
+    GstStructure *m_structure{nullptr};
+};
+
+TEST_F(SinkStatisticsTests, ShouldReportZerosWhenNothingIsRecorded)
+{
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    EXPECT_TRUE(gst_structure_has_name(m_structure, "rialto-sink-stats"));
+    EXPECT_EQ(getField(m_structure, "need-data-requests"), 0u);
+    EXPECT_EQ(getField(m_structure, "latency-min-us"), 0u);
+    EXPECT_EQ(getField(m_structure, "latency-avg-us"), 0u);
+    EXPECT_EQ(getField(m_structure, "latency-max-us"), 0u);
+    EXPECT_EQ(getField(m_structure, "latency-p99-us"), 0u);
+}
+
+TEST_F(SinkStatisticsTests, ShouldReportQueueState)
+{
+    m_structure = m_sut.createStructure(3, 1024, GST_SECOND);
+    ASSERT_TRUE(m_structure);
+    EXPECT_EQ(getField(m_structure, "queued-samples"), 3u);
+    EXPECT_EQ(getField(m_structure, "queued-bytes"), 1024u);
+    EXPECT_EQ(getField(m_structure, "queued-time"), GST_SECOND);
+}
+
+TEST_F(SinkStatisticsTests, ShouldCountDataRequestsAndAnswers)
+{
+    m_sut.recordNeedData(24);
+    m_sut.recordHaveData(MediaSourceStatus::OK, 20, std::chrono::microseconds{100});
+    m_sut.recordNeedData(24);
+    m_sut.recordHaveData(MediaSourceStatus::NO_AVAILABLE_SAMPLES, 0, std::chrono::microseconds{300});
+    m_sut.recordNeedData(24);
+    m_sut.recordHaveData(MediaSourceStatus::EOS, 1, std::chrono::microseconds{200});
+    m_sut.recordNoSpace();
+    m_sut.recordBytesSent(4096);
+    m_sut.recordBytesSent(1024);
+    m_sut.recordChainBlocked(std::chrono::microseconds{50});
+    m_sut.recordUnderflow();
+
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    EXPECT_EQ(getField(m_structure, "need-data-requests"), 3u);
+    EXPECT_EQ(getField(m_structure, "frames-requested"), 72u);
+    EXPECT_EQ(getField(m_structure, "frames-delivered"), 21u);
+    EXPECT_EQ(getField(m_structure, "no-space"), 1u);
+    EXPECT_EQ(getField(m_structure, "no-available-samples"), 1u);
+    EXPECT_EQ(getField(m_structure, "eos"), 1u);
+    EXPECT_EQ(getField(m_structure, "bytes-sent"), 5120u);
+    EXPECT_EQ(getField(m_structure, "chain-blocked-us"), 50u);
+    EXPECT_EQ(getField(m_structure, "underflows"), 1u);
+    EXPECT_EQ(getField(m_structure, "latency-min-us"), 100u);
+    EXPECT_EQ(getField(m_structure, "latency-avg-us"), 200u);
+    EXPECT_EQ(getField(m_structure, "latency-max-us"), 300u);
+}
+
+TEST_F(SinkStatisticsTests, ShouldReportBytesLeftForNextRequest)
+{
+    m_sut.recordBytesPending(65536);
+    m_sut.recordBytesPending(0);
+    m_sut.recordBytesPending(32768);
+
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    EXPECT_EQ(getField(m_structure, "bytes-pending"), 32768u);
+    EXPECT_EQ(getField(m_structure, "space-deferred"), 2u);
+}
+
+TEST_F(SinkStatisticsTests, ShouldReportLatestTimeToFirstSample)
+{
+    m_sut.recordTimeToFirstSample(std::chrono::microseconds{2000});
+    m_sut.recordTimeToFirstSample(std::chrono::microseconds{1500});
+
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    EXPECT_EQ(getField(m_structure, "time-to-first-sample-us"), 1500u);
+}
+
+TEST_F(SinkStatisticsTests, ShouldCountDroppedSamples)
+{
+    m_sut.recordDroppedSample(1024);
+    m_sut.recordDroppedSample(512);
+
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    EXPECT_EQ(getField(m_structure, "samples-dropped"), 2u);
+    EXPECT_EQ(getField(m_structure, "bytes-dropped"), 1536u);
+}
+
+TEST_F(SinkStatisticsTests, ShouldReportLatencyPercentileFromHistogram)
+{
+    for (int i = 0; i < 99; ++i)
+    {
+        m_sut.recordHaveData(MediaSourceStatus::OK, 1, std::chrono::microseconds{10});
+    }
+    m_sut.recordHaveData(MediaSourceStatus::OK, 1, std::chrono::microseconds{5000});
+
+    m_structure = m_sut.createStructure(0, 0, 0);
+    ASSERT_TRUE(m_structure);
+    // 10 us falls in the [8, 16) bucket, reported by its upper bound
+    EXPECT_EQ(getField(m_structure, "latency-p99-us"), 15u);
+    EXPECT_EQ(getField(m_structure, "latency-max-us"), 5000u);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SourceTable.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace
+{
+constexpr int32_t kSourceId{1};
+constexpr int32_t kOtherSourceId{2};
+} // namespace
+
+TEST(SourceTableTests, ShouldNotFindUnknownSource)
+{
+    SourceTable<int> sut;
+    EXPECT_FALSE(sut.find(kSourceId, [](int &) { FAIL(); }));
+}
+
+TEST(SourceTableTests, ShouldFindInsertedSource)
+{
+    SourceTable<int> sut;
+    EXPECT_TRUE(sut.insert(kSourceId, std::make_shared<int>(3)));
+    EXPECT_TRUE(sut.insert(kOtherSourceId, std::make_shared<int>(5)));
+
+    int value{0};
+    EXPECT_TRUE(sut.find(kOtherSourceId, [&](int &found) { value = found; }));
+    EXPECT_EQ(value, 5);
+    EXPECT_TRUE(sut.find(kSourceId, [&](int &found) { value = found; }));
+    EXPECT_EQ(value, 3);
+}
+
+TEST(SourceTableTests, ShouldFailToInsertWhenFull)
+{
+    SourceTable<int, 1> sut;
+    EXPECT_TRUE(sut.insert(kSourceId, std::make_shared<int>(3)));
+    EXPECT_FALSE(sut.insert(kOtherSourceId, std::make_shared<int>(5)));
+}
+
+TEST(SourceTableTests, ShouldReuseSlotOfErasedSource)
+{
+    SourceTable<int, 1> sut;
+    std::shared_ptr<int> value{std::make_shared<int>(3)};
+    EXPECT_TRUE(sut.insert(kSourceId, value));
+    sut.erase(kSourceId);
+    EXPECT_EQ(value.use_count(), 1);
+    EXPECT_FALSE(sut.find(kSourceId, [](int &) { FAIL(); }));
+
+    EXPECT_TRUE(sut.insert(kOtherSourceId, std::make_shared<int>(5)));
+    EXPECT_TRUE(sut.find(kOtherSourceId, [](int &) {}));
+}
+
+TEST(SourceTableTests, ShouldClearAllSources)
+{
+    SourceTable<int> sut;
+    EXPECT_TRUE(sut.insert(kSourceId, std::make_shared<int>(3)));
+    EXPECT_TRUE(sut.insert(kOtherSourceId, std::make_shared<int>(5)));
+    sut.clear();
+    EXPECT_FALSE(sut.find(kSourceId, [](int &) { FAIL(); }));
+    EXPECT_FALSE(sut.find(kOtherSourceId, [](int &) { FAIL(); }));
+}
+
+TEST(SourceTableTests, ShouldWaitForLookupBeforeReleasingErasedSource)
+{
+    SourceTable<std::atomic<bool>> sut;
+    std::shared_ptr<std::atomic<bool>> isInUse{std::make_shared<std::atomic<bool>>(false)};
+    std::atomic<bool> isLookupStarted{false};
+    EXPECT_TRUE(sut.insert(kSourceId, isInUse));
+
+    std::thread reader{[&]()
+                       {
+                           sut.find(kSourceId,
+                                    [&](std::atomic<bool> &value)
+                                    {
+                                        value = true;
+                                        isLookupStarted = true;
+                                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                                        value = false;
+                                    });
+                       }};
+    while (!isLookupStarted)
+    {
+        std::this_thread::yield();
+    }
+    sut.erase(kSourceId);
+    EXPECT_FALSE(*isInUse);
+    EXPECT_EQ(isInUse.use_count(), 1);
+    reader.join();
+}
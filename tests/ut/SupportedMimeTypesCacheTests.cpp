@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "SupportedMimeTypesCache.h"
+#include "MediaPipelineCapabilitiesMock.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+using firebolt::rialto::MediaPipelineCapabilitiesFactoryMock;
+using firebolt::rialto::MediaPipelineCapabilitiesMock;
+using firebolt::rialto::MediaSourceType;
+using testing::ByMove;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+namespace
+{
+const std::string kServerKey{"/tmp/rialto-0"};
+const std::string kOtherServerKey{"/tmp/rialto-1"};
+const std::vector<std::string> kAudioMimeTypes{"audio/mp4", "audio/aac"};
+const std::vector<std::string> kVideoMimeTypes{"video/h264"};
+const std::vector<std::string> kCachedVideoMimeTypes{"video/h264", "video/h265"};
+const std::string kQueriedCacheFile{kServerKey + "\naudio audio/mp4\naudio audio/aac\nvideo video/h264\n"};
+constexpr std::chrono::milliseconds kRefreshTimeout{1000};
+} // namespace
+
+class SupportedMimeTypesCacheTests : public testing::Test
+{
+public:
+    SupportedMimeTypesCacheTests() : m_cacheFilePath{testing::TempDir() + "rialto-mime-types-cache"}
+    {
+        std::remove(m_cacheFilePath.c_str());
+    }
+
+    ~SupportedMimeTypesCacheTests() override { std::remove(m_cacheFilePath.c_str()); }
+
+    void createSut(const std::string &cacheFilePath)
+    {
+        m_sut = std::make_unique<SupportedMimeTypesCache>(m_capabilitiesFactoryMock, cacheFilePath, kServerKey);
+    }
+
+    void serverWillBeQueried()
+    {
+        std::unique_ptr<StrictMock<MediaPipelineCapabilitiesMock>> capabilitiesMock{
+            std::make_unique<StrictMock<MediaPipelineCapabilitiesMock>>()};
+        EXPECT_CALL(*capabilitiesMock, getSupportedMimeTypes(MediaSourceType::AUDIO)).WillOnce(Return(kAudioMimeTypes));
+        EXPECT_CALL(*capabilitiesMock, getSupportedMimeTypes(MediaSourceType::VIDEO)).WillOnce(Return(kVideoMimeTypes));
+        EXPECT_CALL(*m_capabilitiesFactoryMock, createMediaPipelineCapabilities())
+            .WillOnce(Return(ByMove(std::move(capabilitiesMock))));
+    }
+
+    void writeCacheFile(const std::string &serverKey, const std::vector<std::string> &videoMimeTypes)
+    {
+        std::ofstream file{m_cacheFilePath};
+        file << serverKey << '\n';
+        for (const std::string &mimeType : kAudioMimeTypes)
+        {
+            file << "audio " << mimeType << '\n';
+        }
+        for (const std::string &mimeType : videoMimeTypes)
+        {
+            file << "video " << mimeType << '\n';
+        }
+    }
+
+    std::string readCacheFile()
+    {
+        std::ifstream file{m_cacheFilePath};
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    bool waitForCacheFile(const std::string &expectedContent)
+    {
+        const auto kDeadline{std::chrono::steady_clock::now() + kRefreshTimeout};
+        while (readCacheFile() != expectedContent)
+        {
+            if (std::chrono::steady_clock::now() > kDeadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+protected:
+    std::shared_ptr<StrictMock<MediaPipelineCapabilitiesFactoryMock>> m_capabilitiesFactoryMock{
+        std::make_shared<StrictMock<MediaPipelineCapabilitiesFactoryMock>>()};
+    const std::string m_cacheFilePath;
+    std::unique_ptr<SupportedMimeTypesCache> m_sut;
+};
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldQueryServerForEachTypeWhenCacheIsDisabled)
+{
+    createSut("");
+    std::unique_ptr<StrictMock<MediaPipelineCapabilitiesMock>> capabilitiesMock{
+        std::make_unique<StrictMock<MediaPipelineCapabilitiesMock>>()};
+    EXPECT_CALL(*capabilitiesMock, getSupportedMimeTypes(MediaSourceType::VIDEO)).WillOnce(Return(kVideoMimeTypes));
+    EXPECT_CALL(*m_capabilitiesFactoryMock, createMediaPipelineCapabilities())
+        .WillOnce(Return(ByMove(std::move(capabilitiesMock))));
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::VIDEO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kVideoMimeTypes);
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldFailWhenCapabilitiesCannotBeCreated)
+{
+    createSut(m_cacheFilePath);
+    EXPECT_CALL(*m_capabilitiesFactoryMock, createMediaPipelineCapabilities()).WillOnce(Return(nullptr));
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_FALSE(m_sut->getSupportedMimeTypes(MediaSourceType::AUDIO, mimeTypes));
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldQueryServerOnceAndWriteCacheFile)
+{
+    createSut(m_cacheFilePath);
+    serverWillBeQueried();
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::AUDIO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kAudioMimeTypes);
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::VIDEO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kVideoMimeTypes);
+
+    EXPECT_EQ(readCacheFile(), kQueriedCacheFile);
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldUseCacheFileAndRefreshItInBackground)
+{
+    writeCacheFile(kServerKey, kCachedVideoMimeTypes);
+    createSut(m_cacheFilePath);
+    serverWillBeQueried();
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::VIDEO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kCachedVideoMimeTypes);
+
+    // Only the first started sink refreshes the cache
+    m_sut->refreshInBackground();
+    m_sut->refreshInBackground();
+    EXPECT_TRUE(waitForCacheFile(kQueriedCacheFile));
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldNotRefreshCacheFileUntilASinkIsStarted)
+{
+    writeCacheFile(kServerKey, kCachedVideoMimeTypes);
+    createSut(m_cacheFilePath);
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::AUDIO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kAudioMimeTypes);
+    m_sut.reset();
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldNotRefreshCacheFileWrittenFromServer)
+{
+    createSut(m_cacheFilePath);
+    serverWillBeQueried();
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::AUDIO, mimeTypes));
+    m_sut->refreshInBackground();
+    EXPECT_EQ(readCacheFile(), kQueriedCacheFile);
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldGetCacheFilePathFromEnvironment)
+{
+    setenv("XDG_RUNTIME_DIR", "/run/user/1000", 1);
+    unsetenv("RIALTO_MIME_TYPES_CACHE_FILE");
+    EXPECT_EQ(SupportedMimeTypesCache::getCacheFilePath(), "/run/user/1000/rialto-mime-types");
+
+    unsetenv("XDG_RUNTIME_DIR");
+    EXPECT_EQ(SupportedMimeTypesCache::getCacheFilePath(), "/tmp/rialto-mime-types");
+
+    setenv("RIALTO_MIME_TYPES_CACHE_FILE", "/data/mime-types", 1);
+    EXPECT_EQ(SupportedMimeTypesCache::getCacheFilePath(), "/data/mime-types");
+
+    // An empty value disables the cache
+    setenv("RIALTO_MIME_TYPES_CACHE_FILE", "", 1);
+    EXPECT_TRUE(SupportedMimeTypesCache::getCacheFilePath().empty());
+    unsetenv("RIALTO_MIME_TYPES_CACHE_FILE");
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldNotWaitForRefreshOnDestruction)
+{
+    writeCacheFile(kServerKey, kCachedVideoMimeTypes);
+    createSut(m_cacheFilePath);
+
+    std::promise<void> destroyed;
+    std::promise<void> answered;
+    std::shared_future<void> destroyedFuture{destroyed.get_future()};
+    std::unique_ptr<StrictMock<MediaPipelineCapabilitiesMock>> capabilitiesMock{
+        std::make_unique<StrictMock<MediaPipelineCapabilitiesMock>>()};
+    EXPECT_CALL(*capabilitiesMock, getSupportedMimeTypes(MediaSourceType::AUDIO))
+        .WillOnce(Invoke(
+            [destroyedFuture](auto)
+            {
+                // The server answers only once the cache has been destroyed
+                destroyedFuture.wait();
+                return kAudioMimeTypes;
+            }));
+    EXPECT_CALL(*capabilitiesMock, getSupportedMimeTypes(MediaSourceType::VIDEO))
+        .WillOnce(Invoke(
+            [&](auto)
+            {
+                answered.set_value();
+                return kVideoMimeTypes;
+            }));
+    EXPECT_CALL(*m_capabilitiesFactoryMock, createMediaPipelineCapabilities())
+        .WillOnce(Return(ByMove(std::move(capabilitiesMock))));
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::VIDEO, mimeTypes));
+    m_sut->refreshInBackground();
+    m_sut.reset();
+    destroyed.set_value();
+
+    // The cancelled refresh leaves the cache file as it was
+    EXPECT_EQ(std::future_status::ready, answered.get_future().wait_for(kRefreshTimeout));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_NE(readCacheFile(), kQueriedCacheFile);
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldIgnoreCacheFileOfAnotherServer)
+{
+    writeCacheFile(kOtherServerKey, kCachedVideoMimeTypes);
+    createSut(m_cacheFilePath);
+    serverWillBeQueried();
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::VIDEO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kVideoMimeTypes);
+}
+
+TEST_F(SupportedMimeTypesCacheTests, ShouldIgnoreMalformedCacheFile)
+{
+    {
+        std::ofstream file{m_cacheFilePath};
+        file << kServerKey << "\nsubtitle text/vtt\n";
+    }
+    createSut(m_cacheFilePath);
+    serverWillBeQueried();
+
+    std::vector<std::string> mimeTypes;
+    EXPECT_TRUE(m_sut->getSupportedMimeTypes(MediaSourceType::AUDIO, mimeTypes));
+    EXPECT_EQ(mimeTypes, kAudioMimeTypes);
+}
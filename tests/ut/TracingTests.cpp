@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "Tracing.h"
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+
+using testing::HasSubstr;
+using testing::StartsWith;
+
+class TracingTests : public testing::Test
+{
+public:
+    TracingTests() : m_traceFilePath{testing::TempDir() + "rialto-trace.json"} { std::remove(m_traceFilePath.c_str()); }
+
+    ~TracingTests() override { std::remove(m_traceFilePath.c_str()); }
+
+    std::string readTraceFile()
+    {
+        std::ifstream file{m_traceFilePath};
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+protected:
+    const std::string m_traceFilePath;
+};
+
+TEST_F(TracingTests, ShouldBeDisabledWithoutFile)
+{
+    Tracer tracer{""};
+    EXPECT_FALSE(tracer.isEnabled());
+    tracer.instant("NeedData", {{"sourceId", 1}});
+    {
+        TraceScope scope{"PullBuffer", {}, tracer};
+    }
+}
+
+TEST_F(TracingTests, ShouldWriteInstantEvent)
+{
+    {
+        Tracer tracer{m_traceFilePath};
+        EXPECT_TRUE(tracer.isEnabled());
+        tracer.instant("NeedData", {{"sourceId", 1}, {"frames", 24}});
+    }
+
+    const std::string kTrace{readTraceFile()};
+    EXPECT_THAT(kTrace, StartsWith("[\n{\"name\":\"NeedData\",\"cat\":\"rialto\",\"ph\":\"i\""));
+    EXPECT_THAT(kTrace, HasSubstr("\"s\":\"t\""));
+    EXPECT_THAT(kTrace, HasSubstr("\"args\":{\"sourceId\":1,\"frames\":24}}\n]\n"));
+}
+
+TEST_F(TracingTests, ShouldWriteScopeAsCompleteEvent)
+{
+    {
+        Tracer tracer{m_traceFilePath};
+        tracer.instant("NeedData");
+        TraceScope scope{"AddSegment", {{"sourceId", 2}}, tracer};
+    }
+
+    const std::string kTrace{readTraceFile()};
+    EXPECT_THAT(kTrace, HasSubstr("\"args\":{}},\n{\"name\":\"AddSegment\",\"cat\":\"rialto\",\"ph\":\"X\""));
+    EXPECT_THAT(kTrace, HasSubstr("\"dur\":"));
+    EXPECT_THAT(kTrace, HasSubstr("\"args\":{\"sourceId\":2}}\n]\n"));
+}
+
+TEST_F(TracingTests, ShouldWriteCompleteEventWithGivenDuration)
+{
+    {
+        Tracer tracer{m_traceFilePath};
+        const auto kStart{std::chrono::steady_clock::now()};
+        tracer.complete("NeedDataQueued", kStart, kStart + std::chrono::microseconds{1500});
+    }
+
+    EXPECT_THAT(readTraceFile(), HasSubstr("\"dur\":1500.000,"));
+}
@@ -36,6 +36,7 @@ using testing::StrictMock;
 namespace
 {
 const std::string kAudioMimeType{"mime_type"};
+const std::string kPcmMimeType{"audio/x-raw"};
 constexpr uint32_t kPriority{123};
 constexpr firebolt::rialto::WebAudioConfig kConfig{firebolt::rialto::WebAudioPcmConfig{1, 2, 3, false, true, false}};
 constexpr uint32_t kFrames{18};
@@ -77,6 +78,15 @@ TEST_F(WebAudioClientBackendTests, ShouldDestroyBackend)
     m_sut.destroyWebAudioBackend();
 }
 
+TEST_F(WebAudioClientBackendTests, ShouldReuseReleasedBackend)
+{
+    EXPECT_CALL(*m_playerFactoryMock, createWebAudioPlayer(_, kPcmMimeType, kPriority, &kConfig))
+        .WillOnce(Return(ByMove(std::move(m_playerMock))));
+    EXPECT_TRUE(m_sut.createWebAudioBackend(m_clientMock, kPcmMimeType, kPriority, &kConfig));
+    m_sut.releaseWebAudioBackend();
+    EXPECT_TRUE(m_sut.createWebAudioBackend(m_clientMock, kPcmMimeType, kPriority, &kConfig));
+}
+
 TEST_F(WebAudioClientBackendTests, ShouldPlay)
 {
     EXPECT_CALL(*m_playerMock, play()).WillOnce(Return(true));
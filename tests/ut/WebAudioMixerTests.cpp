@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "WebAudioMixer.h"
+#include "TimerFactoryMock.h"
+#include "TimerMock.h"
+#include "WebAudioPlayerClientMock.h"
+#include "WebAudioPlayerMock.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+using firebolt::rialto::IWebAudioPlayer;
+using firebolt::rialto::IWebAudioPlayerClient;
+using firebolt::rialto::IWebAudioPlayerFactory;
+using firebolt::rialto::WebAudioConfig;
+using firebolt::rialto::WebAudioPcmConfig;
+using firebolt::rialto::WebAudioPlayerClientMock;
+using firebolt::rialto::WebAudioPlayerFactoryMock;
+using firebolt::rialto::WebAudioPlayerMock;
+using firebolt::rialto::WebAudioPlayerState;
+using firebolt::rialto::client::WebAudioMixer;
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::Return;
+using testing::SetArgReferee;
+using testing::StrictMock;
+
+namespace
+{
+const std::string kPcmMimeType{"audio/x-raw"};
+constexpr uint32_t kPriority{1};
+constexpr WebAudioConfig kS16Config{WebAudioPcmConfig{48000, 2, 16, false, true, false}};
+constexpr WebAudioConfig kF32Config{WebAudioPcmConfig{48000, 1, 32, false, true, true}};
+constexpr uint32_t kPreferredFrames{240};
+constexpr uint32_t kAvailableFrames{1024};
+constexpr uint32_t kDelayFrames{480};
+} // namespace
+
+class WebAudioMixerTests : public testing::Test
+{
+public:
+    void createSut(const WebAudioConfig &config = kS16Config)
+    {
+        std::unique_ptr<StrictMock<WebAudioPlayerMock>> player{std::make_unique<StrictMock<WebAudioPlayerMock>>()};
+        m_playerMock = player.get();
+        EXPECT_CALL(*m_playerFactoryMock, createWebAudioPlayer(_, kPcmMimeType, kPriority, _))
+            .WillOnce(Return(testing::ByMove(std::move(player))));
+        EXPECT_CALL(*m_playerMock, getDeviceInfo(_, _, _))
+            .WillOnce(DoAll(SetArgReferee<0>(kPreferredFrames), SetArgReferee<1>(0u), SetArgReferee<2>(true),
+                            Return(true)));
+
+        m_sut = std::make_shared<WebAudioMixer>(m_timerFactoryMock, kPcmMimeType, kPriority, config);
+        ASSERT_TRUE(m_sut->init());
+    }
+
+    void mixTimerWillBeCreated()
+    {
+        EXPECT_CALL(*m_timerFactoryMock, createTimer(_, _, TimerType::PERIODIC))
+            .WillOnce(Invoke(
+                [this](const auto &, const auto &callback, auto)
+                {
+                    m_mixCallback = callback;
+                    auto timer = std::make_unique<StrictMock<TimerMock>>();
+                    EXPECT_CALL(*timer, isActive()).WillRepeatedly(Return(true));
+                    m_mixTimerMock = timer.get();
+                    return timer;
+                }));
+    }
+
+    void sharedPlayerWillPlay()
+    {
+        EXPECT_CALL(*m_playerMock, play()).WillOnce(Return(true));
+        EXPECT_CALL(*m_playerMock, getBufferAvailable(_, _))
+            .WillRepeatedly(DoAll(SetArgReferee<0>(kAvailableFrames), Return(true)));
+    }
+
+    template <typename T> void mixedSamplesWillBeWritten(const std::vector<T> &expectedSamples, uint32_t channels)
+    {
+        EXPECT_CALL(*m_playerMock, writeBuffer(expectedSamples.size() / channels, _))
+            .WillOnce(Invoke(
+                [expectedSamples](const uint32_t, void *data)
+                {
+                    std::vector<T> samples(expectedSamples.size());
+                    std::memcpy(samples.data(), data, samples.size() * sizeof(T));
+                    EXPECT_EQ(samples, expectedSamples);
+                    return true;
+                }));
+    }
+
+protected:
+    std::shared_ptr<StrictMock<WebAudioPlayerFactoryMock>> m_playerFactoryMock{
+        std::dynamic_pointer_cast<StrictMock<WebAudioPlayerFactoryMock>>(IWebAudioPlayerFactory::createFactory())};
+    std::shared_ptr<StrictMock<TimerFactoryMock>> m_timerFactoryMock{std::make_shared<StrictMock<TimerFactoryMock>>()};
+    std::shared_ptr<StrictMock<WebAudioPlayerClientMock>> m_clientMock{
+        std::make_shared<StrictMock<WebAudioPlayerClientMock>>()};
+    std::shared_ptr<StrictMock<WebAudioPlayerClientMock>> m_otherClientMock{
+        std::make_shared<StrictMock<WebAudioPlayerClientMock>>()};
+    StrictMock<WebAudioPlayerMock> *m_playerMock{nullptr};
+    std::function<void()> m_mixCallback;
+    StrictMock<TimerMock> *m_mixTimerMock{nullptr};
+    std::shared_ptr<WebAudioMixer> m_sut;
+};
+
+TEST_F(WebAudioMixerTests, ShouldSupportOnlyLittleEndianS16AndF32Pcm)
+{
+    constexpr WebAudioConfig kS16BeConfig{WebAudioPcmConfig{48000, 2, 16, true, true, false}};
+    constexpr WebAudioConfig kS32Config{WebAudioPcmConfig{48000, 2, 32, false, true, false}};
+    EXPECT_TRUE(WebAudioMixer::isSupported(kPcmMimeType, &kS16Config));
+    EXPECT_TRUE(WebAudioMixer::isSupported(kPcmMimeType, &kF32Config));
+    EXPECT_FALSE(WebAudioMixer::isSupported(kPcmMimeType, &kS16BeConfig));
+    EXPECT_FALSE(WebAudioMixer::isSupported(kPcmMimeType, &kS32Config));
+    EXPECT_FALSE(WebAudioMixer::isSupported("audio/mp4", &kS16Config));
+    EXPECT_FALSE(WebAudioMixer::isSupported(kPcmMimeType, nullptr));
+}
+
+TEST_F(WebAudioMixerTests, ShouldFailToInitWhenPlayerCannotBeCreated)
+{
+    EXPECT_CALL(*m_playerFactoryMock, createWebAudioPlayer(_, kPcmMimeType, kPriority, _)).WillOnce(Return(nullptr));
+    m_sut = std::make_shared<WebAudioMixer>(m_timerFactoryMock, kPcmMimeType, kPriority, kS16Config);
+    EXPECT_FALSE(m_sut->init());
+}
+
+TEST_F(WebAudioMixerTests, ShouldReportInputDeviceInfo)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+
+    uint32_t preferredFrames{0};
+    uint32_t maximumFrames{0};
+    bool supportDeferredPlay{false};
+    EXPECT_TRUE(input->getDeviceInfo(preferredFrames, maximumFrames, supportDeferredPlay));
+    EXPECT_EQ(preferredFrames, kPreferredFrames);
+    EXPECT_GT(maximumFrames, kPreferredFrames);
+    EXPECT_TRUE(supportDeferredPlay);
+}
+
+TEST_F(WebAudioMixerTests, ShouldMixS16InputsWithVolumeAndSaturation)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+
+    std::vector<int16_t> samples{1000, -1000, 30000, -30000};
+    std::vector<int16_t> otherSamples{2000, 500, 30000, -30000};
+    EXPECT_TRUE(input->writeBuffer(2, samples.data()));
+    EXPECT_TRUE(otherInput->writeBuffer(2, otherSamples.data()));
+    EXPECT_TRUE(otherInput->setVolume(0.5));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+    EXPECT_TRUE(otherInput->play());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    EXPECT_CALL(*m_otherClientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    mixedSamplesWillBeWritten(std::vector<int16_t>{2000, -750, 32767, -32768}, kS16Config.pcm.channels);
+    m_mixCallback();
+
+    uint32_t availableFrames{0};
+    std::shared_ptr<firebolt::rialto::WebAudioShmInfo> shmInfo;
+    uint32_t maximumFrames{0};
+    uint32_t preferredFrames{0};
+    bool supportDeferredPlay{false};
+    EXPECT_TRUE(input->getDeviceInfo(preferredFrames, maximumFrames, supportDeferredPlay));
+    EXPECT_TRUE(input->getBufferAvailable(availableFrames, shmInfo));
+    EXPECT_EQ(availableFrames, maximumFrames);
+}
+
+TEST_F(WebAudioMixerTests, ShouldMixF32Inputs)
+{
+    createSut(kF32Config);
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+
+    std::vector<float> samples{0.25f, 0.75f, -0.75f};
+    std::vector<float> otherSamples{0.25f, 0.5f};
+    EXPECT_TRUE(input->writeBuffer(3, samples.data()));
+    EXPECT_TRUE(otherInput->writeBuffer(2, otherSamples.data()));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+    EXPECT_TRUE(otherInput->play());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    EXPECT_CALL(*m_otherClientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    // The third frame waits for the other input
+    mixedSamplesWillBeWritten(std::vector<float>{0.5f, 1.0f}, kF32Config.pcm.channels);
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldPadInputWithSilenceOnlyAfterItUnderranForAPeriod)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+
+    std::vector<int16_t> samples{100, 200, 300, 400};
+    std::vector<int16_t> otherSamples{10, 20};
+    EXPECT_TRUE(input->writeBuffer(2, samples.data()));
+    EXPECT_TRUE(otherInput->writeBuffer(1, otherSamples.data()));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+    EXPECT_TRUE(otherInput->play());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    EXPECT_CALL(*m_otherClientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    mixedSamplesWillBeWritten(std::vector<int16_t>{110, 220}, kS16Config.pcm.channels);
+    m_mixCallback();
+
+    // The other input may still deliver its next frames in time
+    m_mixCallback();
+
+    mixedSamplesWillBeWritten(std::vector<int16_t>{300, 400}, kS16Config.pcm.channels);
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldNotMixPausedInput)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+
+    std::vector<int16_t> samples{100, 200};
+    std::vector<int16_t> otherSamples{300, 400};
+    EXPECT_TRUE(input->writeBuffer(1, samples.data()));
+    EXPECT_TRUE(otherInput->writeBuffer(1, otherSamples.data()));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    mixedSamplesWillBeWritten(samples, kS16Config.pcm.channels);
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldFailToWriteMoreThanInputCapacity)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+
+    uint32_t availableFrames{0};
+    std::shared_ptr<firebolt::rialto::WebAudioShmInfo> shmInfo;
+    EXPECT_TRUE(input->getBufferAvailable(availableFrames, shmInfo));
+    std::vector<int16_t> samples((availableFrames + 1) * kS16Config.pcm.channels);
+    EXPECT_FALSE(input->writeBuffer(availableFrames + 1, samples.data()));
+    EXPECT_TRUE(input->writeBuffer(availableFrames, samples.data()));
+
+    EXPECT_TRUE(input->getBufferAvailable(availableFrames, shmInfo));
+    EXPECT_EQ(availableFrames, 0u);
+}
+
+TEST_F(WebAudioMixerTests, ShouldAddQueuedFramesToBufferDelay)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::vector<int16_t> samples(8);
+    EXPECT_TRUE(input->writeBuffer(4, samples.data()));
+
+    EXPECT_CALL(*m_playerMock, getBufferDelay(_)).WillOnce(DoAll(SetArgReferee<0>(kDelayFrames), Return(true)));
+    uint32_t delayFrames{0};
+    EXPECT_TRUE(input->getBufferDelay(delayFrames));
+    EXPECT_EQ(delayFrames, kDelayFrames + 4);
+}
+
+TEST_F(WebAudioMixerTests, ShouldNotifyEosWhenInputIsDrained)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::vector<int16_t> samples{100, 200};
+    EXPECT_TRUE(input->writeBuffer(1, samples.data()));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+    EXPECT_TRUE(input->setEos());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    mixedSamplesWillBeWritten(samples, kS16Config.pcm.channels);
+    m_mixCallback();
+
+    // The last frame is still queued in the server
+    EXPECT_CALL(*m_playerMock, getBufferDelay(_)).WillOnce(DoAll(SetArgReferee<0>(1u), Return(true)));
+    m_mixCallback();
+
+    EXPECT_CALL(*m_playerMock, getBufferDelay(_)).WillOnce(DoAll(SetArgReferee<0>(0u), Return(true)));
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::END_OF_STREAM));
+    m_mixCallback();
+
+    // EOS is only notified once
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldNotifyEosOfEmptyInputOnceServerHasPlayedTheMix)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+    std::vector<int16_t> samples{100, 200};
+    EXPECT_TRUE(otherInput->writeBuffer(1, samples.data()));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(otherInput->play());
+
+    EXPECT_CALL(*m_otherClientMock, notifyState(WebAudioPlayerState::PLAYING));
+    sharedPlayerWillPlay();
+    mixedSamplesWillBeWritten(samples, kS16Config.pcm.channels);
+    m_mixCallback();
+
+    // The input has nothing queued, but the mix written before its EOS is still in the server
+    EXPECT_TRUE(input->setEos());
+    EXPECT_CALL(*m_playerMock, getBufferDelay(_)).WillOnce(DoAll(SetArgReferee<0>(1u), Return(true)));
+    m_mixCallback();
+
+    EXPECT_CALL(*m_playerMock, getBufferDelay(_)).WillOnce(Return(false));
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::END_OF_STREAM));
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldPauseSharedPlayerWhenNoInputIsPlaying)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PLAYING));
+    EXPECT_CALL(*m_playerMock, play()).WillOnce(Return(true));
+    m_mixCallback();
+
+    EXPECT_TRUE(input->pause());
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::PAUSED));
+    EXPECT_CALL(*m_playerMock, pause()).WillOnce(Return(true));
+    EXPECT_CALL(*m_mixTimerMock, cancel());
+    m_mixCallback();
+
+    // The idle mixer starts mixing again when an input is played
+    EXPECT_CALL(*m_mixTimerMock, isActive()).WillRepeatedly(Return(false));
+    mixTimerWillBeCreated();
+    EXPECT_TRUE(input->play());
+}
+
+TEST_F(WebAudioMixerTests, ShouldNotifyFailureToAllInputs)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+    std::unique_ptr<IWebAudioPlayer> otherInput{m_sut->createInput(m_otherClientMock)};
+
+    mixTimerWillBeCreated();
+    m_sut->notifyState(WebAudioPlayerState::FAILURE);
+
+    EXPECT_CALL(*m_clientMock, notifyState(WebAudioPlayerState::FAILURE));
+    EXPECT_CALL(*m_otherClientMock, notifyState(WebAudioPlayerState::FAILURE));
+    EXPECT_CALL(*m_mixTimerMock, cancel());
+    m_mixCallback();
+}
+
+TEST_F(WebAudioMixerTests, ShouldSetAndGetInputVolume)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> input{m_sut->createInput(m_clientMock)};
+
+    double volume{0.0};
+    EXPECT_TRUE(input->getVolume(volume));
+    EXPECT_DOUBLE_EQ(volume, 1.0);
+    EXPECT_TRUE(input->setVolume(0.25));
+    EXPECT_TRUE(input->getVolume(volume));
+    EXPECT_DOUBLE_EQ(volume, 0.25);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2023 Sky UK
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "WebAudioPlayerPool.h"
+#include "TimerFactoryMock.h"
+#include "TimerMock.h"
+#include "WebAudioPlayerClientMock.h"
+#include "WebAudioPlayerMock.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using firebolt::rialto::IWebAudioPlayer;
+using firebolt::rialto::IWebAudioPlayerClient;
+using firebolt::rialto::IWebAudioPlayerFactory;
+using firebolt::rialto::WebAudioConfig;
+using firebolt::rialto::WebAudioPcmConfig;
+using firebolt::rialto::WebAudioPlayerClientMock;
+using firebolt::rialto::WebAudioPlayerFactoryMock;
+using firebolt::rialto::WebAudioPlayerMock;
+using firebolt::rialto::WebAudioPlayerState;
+using firebolt::rialto::client::WebAudioPlayerPool;
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+namespace
+{
+const std::string kPcmMimeType{"audio/x-raw"};
+const std::string kMp4MimeType{"audio/mp4"};
+constexpr uint32_t kPriority{1};
+constexpr WebAudioConfig kConfig{WebAudioPcmConfig{48000, 2, 16, false, true, false}};
+constexpr WebAudioConfig kOtherConfig{WebAudioPcmConfig{44100, 2, 16, false, true, false}};
+constexpr std::size_t kMaxIdlePlayers{2};
+constexpr std::chrono::milliseconds kIdleTimeout{1000};
+} // namespace
+
+class WebAudioPlayerPoolTests : public testing::Test
+{
+public:
+    void createSut(std::size_t maxIdlePlayers = kMaxIdlePlayers, std::chrono::milliseconds idleTimeout = kIdleTimeout)
+    {
+        m_sut = std::make_unique<WebAudioPlayerPool>(m_timerFactoryMock, maxIdlePlayers, idleTimeout);
+    }
+
+    std::unique_ptr<IWebAudioPlayer> playerWillBeCreated(const std::string &mimeType, const WebAudioConfig *config)
+    {
+        EXPECT_CALL(*m_playerFactoryMock, createWebAudioPlayer(_, mimeType, kPriority, config))
+            .WillOnce(Invoke(
+                [this](std::weak_ptr<IWebAudioPlayerClient> client, const std::string &, const uint32_t,
+                    const WebAudioConfig *)
+                {
+                    m_playerClient = client;
+                    return std::make_unique<StrictMock<WebAudioPlayerMock>>();
+                }));
+        return m_sut->acquire(m_clientMock, mimeType, kPriority, config);
+    }
+
+    void expiryTimerWillBeCreated(std::chrono::milliseconds idleTimeout = kIdleTimeout)
+    {
+        EXPECT_CALL(*m_timerFactoryMock, createTimer(idleTimeout, _, TimerType::PERIODIC))
+            .WillOnce(Invoke(
+                [this](const auto &, const auto &callback, auto)
+                {
+                    m_timerCallback = callback;
+                    auto timer{std::make_unique<StrictMock<TimerMock>>()};
+                    EXPECT_CALL(*timer, isActive()).WillRepeatedly(Return(true));
+                    m_expiryTimerMock = timer.get();
+                    return timer;
+                }));
+    }
+
+    void volumeWillBeReset(IWebAudioPlayer &player)
+    {
+        EXPECT_CALL(static_cast<StrictMock<WebAudioPlayerMock> &>(player), setVolume(1.0)).WillOnce(Return(true));
+    }
+
+protected:
+    std::shared_ptr<StrictMock<WebAudioPlayerFactoryMock>> m_playerFactoryMock{
+        std::dynamic_pointer_cast<StrictMock<WebAudioPlayerFactoryMock>>(IWebAudioPlayerFactory::createFactory())};
+    std::shared_ptr<StrictMock<TimerFactoryMock>> m_timerFactoryMock{std::make_shared<StrictMock<TimerFactoryMock>>()};
+    std::shared_ptr<StrictMock<WebAudioPlayerClientMock>> m_clientMock{
+        std::make_shared<StrictMock<WebAudioPlayerClientMock>>()};
+    std::weak_ptr<IWebAudioPlayerClient> m_playerClient;
+    std::function<void()> m_timerCallback;
+    StrictMock<TimerMock> *m_expiryTimerMock{nullptr};
+    std::unique_ptr<WebAudioPlayerPool> m_sut;
+};
+
+TEST_F(WebAudioPlayerPoolTests, ShouldFailToAcquireWhenPlayerCannotBeCreated)
+{
+    createSut();
+    EXPECT_CALL(*m_playerFactoryMock, createWebAudioPlayer(_, kPcmMimeType, kPriority, &kConfig))
+        .WillOnce(Return(nullptr));
+    EXPECT_FALSE(m_sut->acquire(m_clientMock, kPcmMimeType, kPriority, &kConfig));
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldCreatePlayerWhenPoolIsEmpty)
+{
+    createSut();
+    EXPECT_TRUE(playerWillBeCreated(kPcmMimeType, &kConfig));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldReuseReleasedPlayerWithTheSameConfig)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+    const IWebAudioPlayer *playerPtr{player.get()};
+
+    expiryTimerWillBeCreated();
+    volumeWillBeReset(*player);
+    m_sut->release(std::move(player));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 1u);
+
+    std::shared_ptr<StrictMock<WebAudioPlayerClientMock>> newClientMock{
+        std::make_shared<StrictMock<WebAudioPlayerClientMock>>()};
+    player = m_sut->acquire(newClientMock, kPcmMimeType, kPriority, &kConfig);
+    EXPECT_EQ(player.get(), playerPtr);
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+
+    // Notifications of the reused player go to its new owner
+    std::shared_ptr<IWebAudioPlayerClient> playerClient{m_playerClient.lock()};
+    ASSERT_TRUE(playerClient);
+    EXPECT_CALL(*newClientMock, notifyState(WebAudioPlayerState::PLAYING));
+    playerClient->notifyState(WebAudioPlayerState::PLAYING);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldNotForwardNotificationsOfIdlePlayer)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    expiryTimerWillBeCreated();
+    m_sut->release(std::move(player));
+
+    std::shared_ptr<IWebAudioPlayerClient> playerClient{m_playerClient.lock()};
+    ASSERT_TRUE(playerClient);
+    playerClient->notifyState(WebAudioPlayerState::END_OF_STREAM);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldCreateNewPlayerForDifferentConfig)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    expiryTimerWillBeCreated();
+    m_sut->release(std::move(player));
+
+    EXPECT_TRUE(playerWillBeCreated(kPcmMimeType, &kOtherConfig));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 1u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldNotPoolNonPcmPlayer)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kMp4MimeType, &kConfig)};
+
+    m_sut->release(std::move(player));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldNotPoolWhenLimitIsZero)
+{
+    createSut(0);
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    m_sut->release(std::move(player));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldDropLeastRecentlyUsedPlayer)
+{
+    createSut(1);
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+    std::unique_ptr<IWebAudioPlayer> otherPlayer{playerWillBeCreated(kPcmMimeType, &kOtherConfig)};
+    const IWebAudioPlayer *otherPlayerPtr{otherPlayer.get()};
+
+    expiryTimerWillBeCreated();
+    volumeWillBeReset(*otherPlayer);
+    m_sut->release(std::move(player));
+    m_sut->release(std::move(otherPlayer));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 1u);
+
+    EXPECT_EQ(m_sut->acquire(m_clientMock, kPcmMimeType, kPriority, &kOtherConfig).get(), otherPlayerPtr);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldDestroyExpiredPlayers)
+{
+    constexpr std::chrono::milliseconds kShortIdleTimeout{10};
+    createSut(kMaxIdlePlayers, kShortIdleTimeout);
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    expiryTimerWillBeCreated(kShortIdleTimeout);
+    m_sut->release(std::move(player));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 1u);
+
+    std::this_thread::sleep_for(kShortIdleTimeout * 2);
+    ASSERT_TRUE(m_timerCallback);
+    ASSERT_TRUE(m_expiryTimerMock);
+    EXPECT_CALL(*m_expiryTimerMock, cancel());
+    m_timerCallback();
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldRestartCancelledExpiryTimer)
+{
+    constexpr std::chrono::milliseconds kShortIdleTimeout{10};
+    createSut(kMaxIdlePlayers, kShortIdleTimeout);
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+    std::unique_ptr<IWebAudioPlayer> otherPlayer{playerWillBeCreated(kPcmMimeType, &kOtherConfig)};
+
+    expiryTimerWillBeCreated(kShortIdleTimeout);
+    m_sut->release(std::move(player));
+
+    std::this_thread::sleep_for(kShortIdleTimeout * 2);
+    ASSERT_TRUE(m_expiryTimerMock);
+    EXPECT_CALL(*m_expiryTimerMock, cancel());
+    EXPECT_CALL(*m_expiryTimerMock, isActive()).WillRepeatedly(Return(false));
+    m_timerCallback();
+
+    expiryTimerWillBeCreated(kShortIdleTimeout);
+    m_sut->release(std::move(otherPlayer));
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 1u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldDestroyPlayer)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    m_sut->destroy(std::move(player));
+    EXPECT_FALSE(player);
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+}
+
+TEST_F(WebAudioPlayerPoolTests, ShouldClearIdlePlayers)
+{
+    createSut();
+    std::unique_ptr<IWebAudioPlayer> player{playerWillBeCreated(kPcmMimeType, &kConfig)};
+
+    expiryTimerWillBeCreated();
+    m_sut->release(std::move(player));
+    m_sut->clear();
+    EXPECT_EQ(m_sut->getIdlePlayersCount(), 0u);
+
+    EXPECT_TRUE(playerWillBeCreated(kPcmMimeType, &kConfig));
+}